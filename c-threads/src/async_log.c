@@ -0,0 +1,290 @@
+/**
+ * @file async_log.c
+ * @brief Per-thread message rings and the thread that drains them
+ */
+
+#include "async_log.h"
+
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "thread_port.h"
+
+typedef struct {
+    uint64_t timestamp_ns;
+    uint32_t thread;               // Small number of the thread that logged it
+    int level;
+    char text[LOG_MESSAGE_SIZE];
+} log_record_t;
+
+// Single-producer single-consumer ring. The owning thread advances head, the drain
+// thread advances tail; the padding keeps the two counters on separate cache lines.
+// A ring stays on the list after its thread exits, so its last messages still appear,
+// and the next thread that starts logging takes it over instead of allocating one.
+typedef struct log_ring {
+    _Atomic size_t head;
+    size_t cached_tail;            // Producer's last view of tail
+    _Atomic uint64_t dropped;
+    uint32_t thread;               // Number of the owning thread, stamped on its records
+    char padding[64];
+    _Atomic size_t tail;
+    size_t drain_head;             // Drain thread's snapshot of head
+    atomic_bool owned;             // A running thread logs into this ring
+    struct log_ring* next;
+    log_record_t records[LOG_RING_RECORDS];
+} log_ring_t;
+
+// Every ring ever allocated, newest first; rings are never freed, only reused
+static _Atomic(log_ring_t*) rings = NULL;
+static _Atomic uint32_t thread_count = 0;
+static PORT_THREAD_LOCAL log_ring_t* tls_ring = NULL;
+
+// Holds each logging thread's ring so its exit can hand the ring back
+static port_tls_t ring_key;
+
+// The drain thread is started with the first ring; the spinlock guards the start and the output
+static atomic_flag state_lock = ATOMIC_FLAG_INIT;
+static bool drainer_started = false;
+static port_thread_t drainer;
+static port_event_t wake;
+static FILE* output = NULL;
+static bool output_chosen = false;
+static uint64_t start_ns = 0;
+
+static atomic_bool stopping = false;
+static _Atomic uint64_t flush_requested = 0;
+static _Atomic uint64_t flush_completed = 0;
+
+static void state_lock_acquire(void) {
+    while (atomic_flag_test_and_set_explicit(&state_lock, memory_order_acquire)) {
+        port_thread_yield();
+    }
+}
+
+static void state_lock_release(void) {
+    atomic_flag_clear_explicit(&state_lock, memory_order_release);
+}
+
+static const char* level_prefix(int level) {
+    switch (level) {
+    case LOG_LEVEL_DEBUG: return "DEBUG ";
+    case LOG_LEVEL_WARN: return "WARN ";
+    case LOG_LEVEL_ERROR: return "ERROR ";
+    default: return "";
+    }
+}
+
+// Oldest first; equal timestamps are ordered by address so the output is deterministic
+static int compare_records(const void* a, const void* b) {
+    const log_record_t* x = *(const log_record_t* const*)a;
+    const log_record_t* y = *(const log_record_t* const*)b;
+    if (x->timestamp_ns != y->timestamp_ns) {
+        return (x->timestamp_ns > y->timestamp_ns) - (x->timestamp_ns < y->timestamp_ns);
+    }
+    return (x > y) - (x < y);
+}
+
+// Write everything the rings hold, oldest first, then hand the slots back to the producers
+static void drain_rings(uint64_t* dropped_reported) {
+    state_lock_acquire();
+    FILE* out = output_chosen ? output : stdout;
+    state_lock_release();
+    
+    // Messages published after this snapshot wait for the next pass
+    log_ring_t* first = atomic_load_explicit(&rings, memory_order_acquire);
+    size_t count = 0;
+    uint64_t dropped = 0;
+    for (log_ring_t* ring = first; ring != NULL; ring = ring->next) {
+        ring->drain_head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        count += ring->drain_head - atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        dropped += atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+    }
+    
+    if (count > 0) {
+        const log_record_t** batch = (const log_record_t**)malloc(count * sizeof(log_record_t*));
+        if (batch == NULL) {
+            return;
+        }
+        size_t n = 0;
+        for (log_ring_t* ring = first; ring != NULL; ring = ring->next) {
+            for (size_t i = atomic_load_explicit(&ring->tail, memory_order_relaxed); i != ring->drain_head; i++) {
+                batch[n++] = &ring->records[i & (LOG_RING_RECORDS - 1)];
+            }
+        }
+        qsort((void*)batch, count, sizeof(log_record_t*), compare_records);
+        
+        if (out != NULL) {
+            for (size_t i = 0; i < count; i++) {
+                fprintf(out, "[+%.3fms T%u] %s%s\n", (double)(batch[i]->timestamp_ns - start_ns) / 1e6,
+                        (unsigned int)batch[i]->thread, level_prefix(batch[i]->level), batch[i]->text);
+            }
+        }
+        free((void*)batch);
+        
+        for (log_ring_t* ring = first; ring != NULL; ring = ring->next) {
+            atomic_store_explicit(&ring->tail, ring->drain_head, memory_order_release);
+        }
+    }
+    
+    if (out != NULL && dropped > *dropped_reported) {
+        fprintf(out, "[log] %llu messages dropped, their thread's ring was full\n",
+                (unsigned long long)(dropped - *dropped_reported));
+    }
+    *dropped_reported = dropped;
+    if (out != NULL) {
+        fflush(out);
+    }
+}
+
+static int drain_main(void* arg) {
+    (void)arg;
+    uint64_t dropped_reported = 0;
+    
+    while (true) {
+        port_event_wait(&wake, LOG_DRAIN_INTERVAL_MS);
+        uint64_t request = atomic_load(&flush_requested);
+        bool stop = atomic_load(&stopping);
+        drain_rings(&dropped_reported);
+        atomic_store(&flush_completed, request);
+        if (stop) {
+            return 0;
+        }
+    }
+}
+
+// Write what is left and stop the drain thread when the program ends
+static void stop_drainer(void) {
+    atomic_store(&stopping, true);
+    port_event_set(&wake);
+    port_thread_join(drainer, NULL);
+    port_event_destroy(&wake);
+}
+
+// Runs as a thread exits: the ring's messages stay queued and the ring becomes free to reuse
+static void release_ring(void* value) {
+    log_ring_t* ring = (log_ring_t*)value;
+    tls_ring = NULL;
+    atomic_store_explicit(&ring->owned, false, memory_order_release);
+}
+
+static void start_drainer(void) {
+    state_lock_acquire();
+    if (!drainer_started) {
+        if (!port_tls_alloc_destructor(&ring_key, release_ring)) {
+            fprintf(stderr, "Error: Failed to allocate the log ring slot: %d\n", port_last_error());
+            exit(EXIT_FAILURE);
+        }
+        start_ns = port_time_ns();
+        port_event_init(&wake, false);
+        if (!port_thread_create(&drainer, drain_main, NULL)) {
+            fprintf(stderr, "Error: Failed to start the log drain thread: %d\n", port_last_error());
+            exit(EXIT_FAILURE);
+        }
+        drainer_started = true;
+        atexit(stop_drainer);
+    }
+    state_lock_release();
+}
+
+// Take over a ring left by an exited thread; NULL when every ring is in use
+static log_ring_t* reuse_ring(void) {
+    for (log_ring_t* ring = atomic_load_explicit(&rings, memory_order_acquire); ring != NULL; ring = ring->next) {
+        bool expected = false;
+        if (!atomic_load_explicit(&ring->owned, memory_order_relaxed) &&
+            atomic_compare_exchange_strong_explicit(&ring->owned, &expected, true,
+                                                    memory_order_acquire, memory_order_relaxed)) {
+            return ring;
+        }
+    }
+    return NULL;
+}
+
+// Found on the first message, so threads that never log pay nothing
+static log_ring_t* thread_ring(void) {
+    if (tls_ring == NULL) {
+        start_drainer();
+        
+        // A reused ring may still hold the last owner's messages; they keep their timestamps
+        log_ring_t* ring = reuse_ring();
+        if (ring == NULL) {
+            ring = (log_ring_t*)calloc(1, sizeof(log_ring_t));
+            if (ring == NULL) {
+                fprintf(stderr, "Error: Failed to allocate log ring\n");
+                exit(EXIT_FAILURE);
+            }
+            atomic_init(&ring->owned, true);
+            log_ring_t* head = atomic_load_explicit(&rings, memory_order_relaxed);
+            do {
+                ring->next = head;
+            } while (!atomic_compare_exchange_weak_explicit(&rings, &head, ring,
+                                                            memory_order_release, memory_order_relaxed));
+        }
+        ring->thread = atomic_fetch_add(&thread_count, 1) + 1;
+        port_tls_set(ring_key, ring);
+        tls_ring = ring;
+    }
+    return tls_ring;
+}
+
+void log_write(int level, const char* format, ...) {
+    log_ring_t* ring = thread_ring();
+    
+    // Only a ring that looks full costs a read of the drain thread's cache line
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (head - ring->cached_tail == LOG_RING_RECORDS) {
+        ring->cached_tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (head - ring->cached_tail == LOG_RING_RECORDS) {
+            atomic_store_explicit(&ring->dropped,
+                                  atomic_load_explicit(&ring->dropped, memory_order_relaxed) + 1,
+                                  memory_order_relaxed);
+            return;
+        }
+    }
+    
+    log_record_t* record = &ring->records[head & (LOG_RING_RECORDS - 1)];
+    record->timestamp_ns = port_time_ns();
+    record->thread = ring->thread;
+    record->level = level;
+    va_list args;
+    va_start(args, format);
+    if (vsnprintf(record->text, LOG_MESSAGE_SIZE, format, args) < 0) {
+        record->text[0] = '\0';
+    }
+    va_end(args);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+void log_flush(void) {
+    state_lock_acquire();
+    bool started = drainer_started;
+    state_lock_release();
+    if (!started || atomic_load(&stopping)) {
+        return;
+    }
+    
+    uint64_t ticket = atomic_fetch_add(&flush_requested, 1) + 1;
+    port_event_set(&wake);
+    while (atomic_load(&flush_completed) < ticket) {
+        port_thread_yield();
+    }
+}
+
+void log_set_output(FILE* out) {
+    log_flush();
+    state_lock_acquire();
+    output = out;
+    output_chosen = true;
+    state_lock_release();
+    
+    // A drain pass already under way may still write to the old output; wait it out
+    log_flush();
+}
+
+uint64_t log_dropped(void) {
+    uint64_t dropped = 0;
+    for (log_ring_t* ring = atomic_load_explicit(&rings, memory_order_acquire); ring != NULL; ring = ring->next) {
+        dropped += atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+    }
+    return dropped;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file async_log.h
+ * @brief Logging from worker threads without serializing them on the stdout lock
+ *
+ * LOG_INFO("Producer %d starting", id) formats the message into a ring
+ * buffer owned by the calling thread and returns; no lock is taken and no
+ * other thread's cache lines are written. A background thread drains every
+ * ring in batches, orders each batch by timestamp and writes it to stdout
+ * (or another FILE*) with the time and a thread number in front. When a
+ * ring is full the message is dropped and counted rather than making the
+ * producer wait.
+ *
+ * Statements below CTHREADS_LOG_LEVEL are removed by the preprocessor,
+ * arguments included, so a disabled LOG_DEBUG costs nothing.
+ */
+
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_ERROR 3
+
+// Lowest level that is compiled in; override with -DCTHREADS_LOG_LEVEL=0..4
+#ifndef CTHREADS_LOG_LEVEL
+#define CTHREADS_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Messages each thread can have waiting for the drain thread (power of two)
+#define LOG_RING_RECORDS 256
+
+// Longest message kept, including the terminator; longer ones are truncated
+#define LOG_MESSAGE_SIZE 200
+
+// How often the drain thread looks for messages when nobody calls log_flush()
+#define LOG_DRAIN_INTERVAL_MS 5
+
+#if defined(__GNUC__) || defined(__clang__)
+#define LOG_PRINTF_FORMAT __attribute__((format(printf, 2, 3)))
+#else
+#define LOG_PRINTF_FORMAT
+#endif
+
+// Format a message into the calling thread's ring; use the LOG_* macros instead
+void log_write(int level, const char* format, ...) LOG_PRINTF_FORMAT;
+
+// Block until every message logged before the call has been written
+void log_flush(void);
+
+// Where drained messages go from now on; NULL discards them. Default: stdout.
+void log_set_output(FILE* out);
+
+// Messages dropped so far because their thread's ring was full
+uint64_t log_dropped(void);
+
+#if CTHREADS_LOG_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) log_write(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if CTHREADS_LOG_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(...) log_write(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if CTHREADS_LOG_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(...) log_write(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+
+#if CTHREADS_LOG_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) log_write(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+
+#endif // ASYNC_LOG_H
@@ -0,0 +1,46 @@
+/**
+ * @file bench_main.c
+ * @brief Entry point for the C threading benchmarks
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+// Function declarations from other source files
+extern int thread_pool_bench_main(int argc, char* argv[]);
+extern int thread_costs_bench_main(int argc, char* argv[]);
+extern int submit_bench_main(int argc, char* argv[]);
+extern int log_bench_main(int argc, char* argv[]);
+
+static void print_usage(void) {
+    printf("Usage: CThreadsBench <benchmark> [options]\n");
+    printf("Benchmarks:\n");
+    printf("  pool    Jobs/sec of the shared-queue and work-stealing thread pools\n");
+    printf("  costs   Thread creation, mutex and wake-up costs of the threading backend\n");
+    printf("  submit  Submission latency percentiles under many concurrent submitters\n");
+    printf("  log     Cost of one log call: fprintf versus the asynchronous logger\n");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        print_usage();
+        return 1;
+    }
+    
+    // Remaining arguments are passed to the selected benchmark
+    if (strcmp(argv[1], "pool") == 0) {
+        return thread_pool_bench_main(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "costs") == 0) {
+        return thread_costs_bench_main(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "submit") == 0) {
+        return submit_bench_main(argc - 2, argv + 2);
+    }
+    if (strcmp(argv[1], "log") == 0) {
+        return log_bench_main(argc - 2, argv + 2);
+    }
+    
+    print_usage();
+    return 1;
+}
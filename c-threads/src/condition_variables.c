@@ -1,18 +1,18 @@
 /**
  * @file condition_variables.c
- * @brief Thread signaling and waiting mechanisms using Windows condition variables
+ * @brief Thread signaling and waiting mechanisms using condition variables
  */
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <Windows.h>
+#include "thread_port.h"
 
-// Shared data protected by critical section
+// Shared data protected by a mutex
 typedef struct {
     int ready;              // Flag indicating data is ready
     int data;               // The shared data
-    CRITICAL_SECTION cs;    // Critical section for synchronization
-    CONDITION_VARIABLE cv;  // Condition variable for signaling
+    port_mutex_t cs;        // Mutex (critical section) for synchronization
+    port_cond_t cv;         // Condition variable for signaling
 } shared_data_t;
 
 // Initialize shared data structure
@@ -21,10 +21,10 @@ void init_shared_data(shared_data_t* shared_data) {
     shared_data->data = 0;
     
     // Initialize critical section
-    InitializeCriticalSection(&shared_data->cs);
+    port_mutex_init(&shared_data->cs);
     
     // Initialize condition variable
-    InitializeConditionVariable(&shared_data->cv);
+    port_cond_init(&shared_data->cv);
     
     printf("Shared data initialized\n");
 }
@@ -32,21 +32,22 @@ void init_shared_data(shared_data_t* shared_data) {
 // Clean up shared data structure
 void cleanup_shared_data(shared_data_t* shared_data) {
     // Delete critical section
-    DeleteCriticalSection(&shared_data->cs);
+    port_mutex_destroy(&shared_data->cs);
     
-    // Note: Condition variables do not need explicit cleanup in Windows
+    // Destroy condition variable (a no-op on Windows)
+    port_cond_destroy(&shared_data->cv);
     
     printf("Shared data cleaned up\n");
 }
 
 // Consumer thread function
-DWORD WINAPI consumer_thread(LPVOID arg) {
+int consumer_thread(void* arg) {
     shared_data_t* shared_data = (shared_data_t*)arg;
     
     printf("Consumer: Waiting for data to be ready\n");
     
     // Enter critical section
-    EnterCriticalSection(&shared_data->cs);
+    port_mutex_lock(&shared_data->cs);
     
     // Wait until data is ready
     while (!shared_data->ready) {
@@ -54,7 +55,7 @@ DWORD WINAPI consumer_thread(LPVOID arg) {
         
         // Wait for the condition variable to be signaled
         // This automatically releases the critical section while waiting
-        SleepConditionVariableCS(&shared_data->cv, &shared_data->cs, INFINITE);
+        port_cond_wait(&shared_data->cv, &shared_data->cs);
         
         printf("Consumer: Condition signaled, checking if data ready\n");
     }
@@ -70,21 +71,21 @@ DWORD WINAPI consumer_thread(LPVOID arg) {
     shared_data->ready = 0;
     
     // Leave critical section
-    LeaveCriticalSection(&shared_data->cs);
+    port_mutex_unlock(&shared_data->cs);
     
     return 0;
 }
 
 // Producer thread function
-DWORD WINAPI producer_thread(LPVOID arg) {
+int producer_thread(void* arg) {
     shared_data_t* shared_data = (shared_data_t*)arg;
     
     // Simulate some work before producing data
     printf("Producer: Working on producing data...\n");
-    Sleep(2000); // Sleep for 2 seconds
+    port_sleep_ms(2000); // Sleep for 2 seconds
     
     // Enter critical section
-    EnterCriticalSection(&shared_data->cs);
+    port_mutex_lock(&shared_data->cs);
     
     // Update the shared data
     shared_data->data = 42;
@@ -93,17 +94,17 @@ DWORD WINAPI producer_thread(LPVOID arg) {
     printf("Producer: Data is ready (value = %d)\n", shared_data->data);
     
     // Signal the condition variable
-    WakeConditionVariable(&shared_data->cv);
+    port_cond_signal(&shared_data->cv);
     
     // Leave critical section
-    LeaveCriticalSection(&shared_data->cs);
+    port_mutex_unlock(&shared_data->cs);
     
     return 0;
 }
 
 // Demo for simple signal/wait with condition variables
 void simple_condition_demo() {
-    HANDLE threads[2];
+    port_thread_t threads[2];
     shared_data_t shared_data;
     
     printf("\n=== Simple Condition Variable Demo ===\n");
@@ -112,44 +113,23 @@ void simple_condition_demo() {
     init_shared_data(&shared_data);
     
     // Create consumer thread (waits for condition)
-    threads[0] = CreateThread(
-        NULL,                // Default security attributes
-        0,                   // Default stack size
-        consumer_thread,     // Thread function
-        &shared_data,        // Argument to thread function
-        0,                   // Default creation flags
-        NULL                 // Don't store thread ID
-    );
-    
-    if (threads[0] == NULL) {
+    if (!port_thread_create(&threads[0], consumer_thread, &shared_data)) {
         fprintf(stderr, "Error creating consumer thread\n");
         cleanup_shared_data(&shared_data);
         exit(EXIT_FAILURE);
     }
     
     // Create producer thread (signals condition)
-    threads[1] = CreateThread(
-        NULL,                // Default security attributes
-        0,                   // Default stack size
-        producer_thread,     // Thread function
-        &shared_data,        // Argument to thread function
-        0,                   // Default creation flags
-        NULL                 // Don't store thread ID
-    );
-    
-    if (threads[1] == NULL) {
+    if (!port_thread_create(&threads[1], producer_thread, &shared_data)) {
         fprintf(stderr, "Error creating producer thread\n");
-        CloseHandle(threads[0]);
+        port_thread_detach(threads[0]);
         cleanup_shared_data(&shared_data);
         exit(EXIT_FAILURE);
     }
     
     // Wait for both threads to finish
-    WaitForMultipleObjects(2, threads, TRUE, INFINITE);
-    
-    // Close thread handles
-    CloseHandle(threads[0]);
-    CloseHandle(threads[1]);
+    port_thread_join(threads[0], NULL);
+    port_thread_join(threads[1], NULL);
     
     // Clean up shared data
     cleanup_shared_data(&shared_data);
@@ -160,19 +140,19 @@ void simple_condition_demo() {
 // Broadcast example with multiple consumers
 #define NUM_CONSUMERS 3
 
-DWORD WINAPI broadcast_consumer_thread(LPVOID arg) {
+int broadcast_consumer_thread(void* arg) {
     shared_data_t* shared_data = (shared_data_t*)arg;
-    int thread_id = GetCurrentThreadId() % 1000; // Use last 3 digits for readability
+    int thread_id = (int)(port_thread_current_id() % 1000); // Use last 3 digits for readability
     
     printf("Consumer %d: Waiting for broadcast signal\n", thread_id);
     
     // Enter critical section
-    EnterCriticalSection(&shared_data->cs);
+    port_mutex_lock(&shared_data->cs);
     
     // Wait until data is ready
     while (!shared_data->ready) {
         printf("Consumer %d: Waiting on condition...\n", thread_id);
-        SleepConditionVariableCS(&shared_data->cv, &shared_data->cs, INFINITE);
+        port_cond_wait(&shared_data->cv, &shared_data->cs);
         printf("Consumer %d: Woke up from condition wait\n", thread_id);
     }
     
@@ -180,20 +160,20 @@ DWORD WINAPI broadcast_consumer_thread(LPVOID arg) {
     printf("Consumer %d: Received broadcast signal, data = %d\n", thread_id, shared_data->data);
     
     // Leave critical section
-    LeaveCriticalSection(&shared_data->cs);
+    port_mutex_unlock(&shared_data->cs);
     
     return 0;
 }
 
-DWORD WINAPI broadcast_producer_thread(LPVOID arg) {
+int broadcast_producer_thread(void* arg) {
     shared_data_t* shared_data = (shared_data_t*)arg;
     
     // Simulate work before broadcast
     printf("Producer: Working before broadcast...\n");
-    Sleep(3000); // Sleep for 3 seconds
+    port_sleep_ms(3000); // Sleep for 3 seconds
     
     // Enter critical section
-    EnterCriticalSection(&shared_data->cs);
+    port_mutex_lock(&shared_data->cs);
     
     // Update shared data
     shared_data->data = 100;
@@ -202,17 +182,17 @@ DWORD WINAPI broadcast_producer_thread(LPVOID arg) {
     printf("Producer: Broadcasting to all consumers, data = %d\n", shared_data->data);
     
     // Wake all waiting threads
-    WakeAllConditionVariable(&shared_data->cv);
+    port_cond_broadcast(&shared_data->cv);
     
     // Leave critical section
-    LeaveCriticalSection(&shared_data->cs);
+    port_mutex_unlock(&shared_data->cs);
     
     return 0;
 }
 
 // Demo for broadcasting to multiple threads
 void broadcast_condition_demo() {
-    HANDLE threads[NUM_CONSUMERS + 1]; // Consumers + 1 producer
+    port_thread_t threads[NUM_CONSUMERS + 1]; // Consumers + 1 producer
     shared_data_t shared_data;
     
     printf("\n=== Broadcast Condition Variable Demo ===\n");
@@ -222,21 +202,12 @@ void broadcast_condition_demo() {
     
     // Create multiple consumer threads
     for (int i = 0; i < NUM_CONSUMERS; i++) {
-        threads[i] = CreateThread(
-            NULL,                      // Default security attributes
-            0,                         // Default stack size
-            broadcast_consumer_thread, // Thread function
-            &shared_data,              // Argument to thread function
-            0,                         // Default creation flags
-            NULL                       // Don't store thread ID
-        );
-        
-        if (threads[i] == NULL) {
+        if (!port_thread_create(&threads[i], broadcast_consumer_thread, &shared_data)) {
             fprintf(stderr, "Error creating consumer thread %d\n", i);
             
-            // Close already created threads
+            // Detach already created threads
             for (int j = 0; j < i; j++) {
-                CloseHandle(threads[j]);
+                port_thread_detach(threads[j]);
             }
             
             cleanup_shared_data(&shared_data);
@@ -245,21 +216,12 @@ void broadcast_condition_demo() {
     }
     
     // Create producer thread
-    threads[NUM_CONSUMERS] = CreateThread(
-        NULL,                       // Default security attributes
-        0,                          // Default stack size
-        broadcast_producer_thread,  // Thread function
-        &shared_data,               // Argument to thread function
-        0,                          // Default creation flags
-        NULL                        // Don't store thread ID
-    );
-    
-    if (threads[NUM_CONSUMERS] == NULL) {
+    if (!port_thread_create(&threads[NUM_CONSUMERS], broadcast_producer_thread, &shared_data)) {
         fprintf(stderr, "Error creating producer thread\n");
         
-        // Close consumer threads
+        // Detach consumer threads
         for (int i = 0; i < NUM_CONSUMERS; i++) {
-            CloseHandle(threads[i]);
+            port_thread_detach(threads[i]);
         }
         
         cleanup_shared_data(&shared_data);
@@ -267,11 +229,8 @@ void broadcast_condition_demo() {
     }
     
     // Wait for all threads to finish
-    WaitForMultipleObjects(NUM_CONSUMERS + 1, threads, TRUE, INFINITE);
-    
-    // Close thread handles
     for (int i = 0; i < NUM_CONSUMERS + 1; i++) {
-        CloseHandle(threads[i]);
+        port_thread_join(threads[i], NULL);
     }
     
     // Clean up shared data
@@ -0,0 +1,261 @@
+/**
+ * @file lock_profiler.c
+ * @brief Per-thread lock statistics, their merging and the contention report
+ */
+
+#include "lock_profiler.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// One thread's statistics for one lock. Only the owning thread writes them; the report
+// reads them from another thread, hence the relaxed atomics.
+typedef struct {
+    _Atomic uint64_t acquisitions;
+    _Atomic uint64_t contended;
+    _Atomic uint64_t wait_ns;
+    _Atomic uint64_t wait_histogram[LOCK_PROFILE_BUCKETS];
+    _Atomic uint64_t hold_histogram[LOCK_PROFILE_BUCKETS];
+} lock_counters_t;
+
+// A thread's buffer stays on the list after the thread exits, so the report covers every thread
+typedef struct lock_thread_buffer {
+    lock_counters_t counters[LOCK_PROFILE_MAX_LOCKS];
+    struct lock_thread_buffer* next;
+} lock_thread_buffer_t;
+
+// Statistics of one lock merged over threads
+typedef struct {
+    int id;
+    uint64_t acquisitions;
+    uint64_t contended;
+    uint64_t wait_ns;
+    uint64_t wait_histogram[LOCK_PROFILE_BUCKETS];
+    uint64_t hold_histogram[LOCK_PROFILE_BUCKETS];
+} lock_totals_t;
+
+// The name table is guarded by a spinlock, which needs no initialization call
+static atomic_flag names_lock = ATOMIC_FLAG_INIT;
+static const char* lock_names[LOCK_PROFILE_MAX_LOCKS];
+static int lock_name_count = 0;
+static bool report_registered = false;
+
+// Every thread buffer ever allocated, newest first
+static _Atomic(lock_thread_buffer_t*) thread_buffers = NULL;
+
+static PORT_THREAD_LOCAL lock_thread_buffer_t* tls_buffer = NULL;
+
+static void names_lock_acquire(void) {
+    while (atomic_flag_test_and_set_explicit(&names_lock, memory_order_acquire)) {
+        port_thread_yield();
+    }
+}
+
+static void names_lock_release(void) {
+    atomic_flag_clear_explicit(&names_lock, memory_order_release);
+}
+
+static void report_at_exit(void) {
+    lock_profile_report(stderr, LOCK_PROFILE_TOP_N);
+}
+
+// Allocated on the first acquisition, so threads that never take a profiled lock pay nothing
+static lock_counters_t* thread_counters(int id) {
+    if (tls_buffer == NULL) {
+        tls_buffer = (lock_thread_buffer_t*)calloc(1, sizeof(lock_thread_buffer_t));
+        if (tls_buffer == NULL) {
+            fprintf(stderr, "Error: Failed to allocate lock profile buffer\n");
+            exit(EXIT_FAILURE);
+        }
+        lock_thread_buffer_t* head = atomic_load_explicit(&thread_buffers, memory_order_relaxed);
+        do {
+            tls_buffer->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&thread_buffers, &head, tls_buffer,
+                                                        memory_order_release, memory_order_relaxed));
+    }
+    return &tls_buffer->counters[id];
+}
+
+// The owner is the only writer, so a load and a store replace the locked read-modify-write
+static void bump(_Atomic uint64_t* value, uint64_t amount) {
+    atomic_store_explicit(value, atomic_load_explicit(value, memory_order_relaxed) + amount,
+                          memory_order_relaxed);
+}
+
+static int histogram_bucket(uint64_t ns) {
+    int bucket = 0;
+    while (ns != 0 && bucket < LOCK_PROFILE_BUCKETS - 1) {
+        ns >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+static int register_name(const char* name) {
+    names_lock_acquire();
+    
+    int id = -1;
+    for (int i = 0; i < lock_name_count; i++) {
+        if (strcmp(lock_names[i], name) == 0) {
+            id = i;
+            break;
+        }
+    }
+    if (id < 0) {
+        if (lock_name_count == LOCK_PROFILE_MAX_LOCKS - 1) {
+            lock_names[lock_name_count++] = "(other locks)";
+        }
+        if (lock_name_count == LOCK_PROFILE_MAX_LOCKS) {
+            id = LOCK_PROFILE_MAX_LOCKS - 1;
+        } else {
+            id = lock_name_count;
+            lock_names[lock_name_count++] = name;
+        }
+    }
+    if (!report_registered) {
+        report_registered = true;
+        atexit(report_at_exit);
+    }
+    
+    names_lock_release();
+    return id;
+}
+
+void profiled_mutex_init(profiled_mutex_t* mutex, const char* name) {
+    port_mutex_init(&mutex->mutex);
+    mutex->id = register_name(name);
+    mutex->acquired_at = 0;
+}
+
+void profiled_mutex_destroy(profiled_mutex_t* mutex) {
+    port_mutex_destroy(&mutex->mutex);
+}
+
+void profiled_mutex_lock(profiled_mutex_t* mutex) {
+    lock_counters_t* counters = thread_counters(mutex->id);
+    
+    // A failed trylock is what makes an acquisition contended
+    if (port_mutex_trylock(&mutex->mutex)) {
+        mutex->acquired_at = port_time_ns();
+    } else {
+        uint64_t start = port_time_ns();
+        port_mutex_lock(&mutex->mutex);
+        mutex->acquired_at = port_time_ns();
+        
+        uint64_t wait_ns = mutex->acquired_at - start;
+        bump(&counters->contended, 1);
+        bump(&counters->wait_ns, wait_ns);
+        bump(&counters->wait_histogram[histogram_bucket(wait_ns)], 1);
+    }
+    bump(&counters->acquisitions, 1);
+}
+
+void profiled_mutex_unlock(profiled_mutex_t* mutex) {
+    uint64_t hold_ns = port_time_ns() - mutex->acquired_at;
+    bump(&thread_counters(mutex->id)->hold_histogram[histogram_bucket(hold_ns)], 1);
+    port_mutex_unlock(&mutex->mutex);
+}
+
+void profiled_cond_wait(port_cond_t* cond, profiled_mutex_t* mutex) {
+    uint64_t hold_ns = port_time_ns() - mutex->acquired_at;
+    bump(&thread_counters(mutex->id)->hold_histogram[histogram_bucket(hold_ns)], 1);
+    port_cond_wait(cond, &mutex->mutex);
+    mutex->acquired_at = port_time_ns();
+}
+
+// Upper bound of the bucket that holds the given fraction of the samples
+static void histogram_percentile(const uint64_t* histogram, double fraction, char* text, size_t size) {
+    uint64_t total = 0;
+    for (int i = 0; i < LOCK_PROFILE_BUCKETS; i++) {
+        total += histogram[i];
+    }
+    if (total == 0) {
+        snprintf(text, size, "-");
+        return;
+    }
+    
+    uint64_t seen = 0;
+    int bucket = 0;
+    for (; bucket < LOCK_PROFILE_BUCKETS - 1; bucket++) {
+        seen += histogram[bucket];
+        if ((double)seen >= fraction * (double)total) {
+            break;
+        }
+    }
+    
+    uint64_t bound = (uint64_t)1 << bucket;
+    if (bucket == 0) {
+        snprintf(text, size, "0");
+    } else if (bound < 10000) {
+        snprintf(text, size, "<%lluns", (unsigned long long)bound);
+    } else if (bound < 10000000) {
+        snprintf(text, size, "<%lluus", (unsigned long long)(bound / 1000));
+    } else {
+        snprintf(text, size, "<%llums", (unsigned long long)(bound / 1000000));
+    }
+}
+
+// Most total wait first
+static int compare_wait(const void* a, const void* b) {
+    uint64_t wait_a = ((const lock_totals_t*)a)->wait_ns;
+    uint64_t wait_b = ((const lock_totals_t*)b)->wait_ns;
+    return (wait_a < wait_b) - (wait_a > wait_b);
+}
+
+void lock_profile_report(FILE* out, int top_n) {
+    lock_totals_t totals[LOCK_PROFILE_MAX_LOCKS];
+    memset(totals, 0, sizeof(totals));
+    
+    names_lock_acquire();
+    int count = lock_name_count;
+    names_lock_release();
+    
+    for (lock_thread_buffer_t* buffer = atomic_load_explicit(&thread_buffers, memory_order_acquire);
+         buffer != NULL; buffer = buffer->next) {
+        for (int i = 0; i < count; i++) {
+            lock_counters_t* counters = &buffer->counters[i];
+            totals[i].acquisitions += atomic_load_explicit(&counters->acquisitions, memory_order_relaxed);
+            totals[i].contended += atomic_load_explicit(&counters->contended, memory_order_relaxed);
+            totals[i].wait_ns += atomic_load_explicit(&counters->wait_ns, memory_order_relaxed);
+            for (int b = 0; b < LOCK_PROFILE_BUCKETS; b++) {
+                totals[i].wait_histogram[b] += atomic_load_explicit(&counters->wait_histogram[b], memory_order_relaxed);
+                totals[i].hold_histogram[b] += atomic_load_explicit(&counters->hold_histogram[b], memory_order_relaxed);
+            }
+        }
+    }
+    
+    // Keep the locks that were taken at all
+    int used = 0;
+    for (int i = 0; i < count; i++) {
+        if (totals[i].acquisitions > 0) {
+            totals[used] = totals[i];
+            totals[used].id = i;
+            used++;
+        }
+    }
+    if (used == 0) {
+        return;
+    }
+    qsort(totals, (size_t)used, sizeof(lock_totals_t), compare_wait);
+    if (used > top_n) {
+        used = top_n;
+    }
+    
+    fprintf(out, "\n=== Lock Contention (top %d by total wait) ===\n", used);
+    fprintf(out, "%-20s%12s%12s%9s%14s%10s%10s%10s%10s\n", "Lock", "Acquired", "Contended", "%",
+            "Wait total ms", "Wait p50", "Wait p99", "Hold p50", "Hold p99");
+    for (int i = 0; i < used; i++) {
+        char wait_p50[16], wait_p99[16], hold_p50[16], hold_p99[16];
+        histogram_percentile(totals[i].wait_histogram, 0.50, wait_p50, sizeof(wait_p50));
+        histogram_percentile(totals[i].wait_histogram, 0.99, wait_p99, sizeof(wait_p99));
+        histogram_percentile(totals[i].hold_histogram, 0.50, hold_p50, sizeof(hold_p50));
+        histogram_percentile(totals[i].hold_histogram, 0.99, hold_p99, sizeof(hold_p99));
+        
+        fprintf(out, "%-20s%12llu%12llu%9.2f%14.2f%10s%10s%10s%10s\n", lock_names[totals[i].id],
+                (unsigned long long)totals[i].acquisitions, (unsigned long long)totals[i].contended,
+                100.0 * (double)totals[i].contended / (double)totals[i].acquisitions,
+                (double)totals[i].wait_ns / 1e6, wait_p50, wait_p99, hold_p50, hold_p99);
+    }
+}
@@ -0,0 +1,168 @@
+/**
+ * @file log_bench.c
+ * @brief Producer-side cost of one log call: fprintf versus the async logger
+ *
+ * Every thread logs in bursts of half a ring and only the time spent inside
+ * the log calls is counted; the async logger is flushed between bursts, so
+ * no message is dropped and the drain thread's work is not billed to the
+ * producer. The reported ns/call is the average time a thread spends in one
+ * call, including any waiting for the other threads.
+ *
+ * - fprintf:  a line to a shared FILE*, serialized by the stdio lock, the
+ *             pattern of the demos' printf lines
+ * - async:    LOG_INFO into the calling thread's ring
+ * - filtered: LOG_DEBUG below the compiled-in level, which should cost nothing
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "async_log.h"
+#include "thread_port.h"
+
+// Default benchmark parameters
+#define LOG_BENCH_DEFAULT_CALLS 100000
+#define LOG_BENCH_DEFAULT_REPEAT 5
+#define LOG_BENCH_DEFAULT_THREADS 4
+#define LOG_BENCH_MAX_REPEAT 32
+#define LOG_BENCH_MAX_THREADS 64
+
+// Calls timed back to back before the async logger is flushed
+#define LOG_BENCH_BURST (LOG_RING_RECORDS / 2)
+
+#if defined(_WIN32)
+#define LOG_BENCH_NULL_DEVICE "NUL"
+#else
+#define LOG_BENCH_NULL_DEVICE "/dev/null"
+#endif
+
+typedef enum {
+    LOG_POLICY_FPRINTF,
+    LOG_POLICY_ASYNC,
+    LOG_POLICY_FILTERED
+} log_policy_t;
+
+static const char* const LOG_POLICY_NAMES[] = { "fprintf", "async", "filtered" };
+
+// One producer thread's parameters and result
+typedef struct {
+    int index;
+    log_policy_t policy;
+    long calls;
+    FILE* sink;
+    uint64_t busy_ns;
+} log_producer_t;
+
+static int log_producer_thread(void* arg) {
+    log_producer_t* producer = (log_producer_t*)arg;
+    for (long done = 0; done < producer->calls;) {
+        long burst = producer->calls - done < LOG_BENCH_BURST ? producer->calls - done : LOG_BENCH_BURST;
+        uint64_t start = port_time_ns();
+        for (long i = done; i < done + burst; i++) {
+            switch (producer->policy) {
+            case LOG_POLICY_FPRINTF:
+                fprintf(producer->sink, "Thread %d processed item %ld\n", producer->index, i);
+                fflush(producer->sink);
+                break;
+            case LOG_POLICY_ASYNC:
+                LOG_INFO("Thread %d processed item %ld", producer->index, i);
+                break;
+            case LOG_POLICY_FILTERED:
+                LOG_DEBUG("Thread %d processed item %ld", producer->index, i);
+                break;
+            }
+        }
+        producer->busy_ns += port_time_ns() - start;
+        done += burst;
+        log_flush();
+    }
+    return 0;
+}
+
+// Average nanoseconds per call over every thread of one run
+static double log_bench_run(log_policy_t policy, int threads, long calls, FILE* sink) {
+    port_thread_t handles[LOG_BENCH_MAX_THREADS];
+    log_producer_t producers[LOG_BENCH_MAX_THREADS];
+    
+    for (int t = 0; t < threads; t++) {
+        producers[t].index = t;
+        producers[t].policy = policy;
+        producers[t].calls = calls;
+        producers[t].sink = sink;
+        producers[t].busy_ns = 0;
+        if (!port_thread_create(&handles[t], log_producer_thread, &producers[t])) {
+            fprintf(stderr, "Failed to create thread: %d\n", port_last_error());
+            exit(EXIT_FAILURE);
+        }
+    }
+    
+    uint64_t busy = 0;
+    for (int t = 0; t < threads; t++) {
+        port_thread_join(handles[t], NULL);
+        busy += producers[t].busy_ns;
+    }
+    return (double)busy / ((double)calls * threads);
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static void print_usage(void) {
+    printf("Usage: CThreadsBench log [--calls=N] [--threads=N] [--repeat=N]\n");
+    printf("  Thread counts are the powers of two up to --threads (default %d)\n", LOG_BENCH_DEFAULT_THREADS);
+}
+
+// Entry point of the logging benchmark
+int log_bench_main(int argc, char* argv[]) {
+    long calls = LOG_BENCH_DEFAULT_CALLS;
+    int max_threads = LOG_BENCH_DEFAULT_THREADS;
+    int repeat = LOG_BENCH_DEFAULT_REPEAT;
+    
+    for (int i = 0; i < argc; i++) {
+        if (strncmp(argv[i], "--calls=", 8) == 0) {
+            calls = atol(argv[i] + 8);
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            max_threads = atoi(argv[i] + 10);
+        } else if (strncmp(argv[i], "--repeat=", 9) == 0) {
+            repeat = atoi(argv[i] + 9);
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    if (calls <= 0 || max_threads <= 0 || max_threads > LOG_BENCH_MAX_THREADS ||
+        repeat <= 0 || repeat > LOG_BENCH_MAX_REPEAT) {
+        print_usage();
+        return 1;
+    }
+    
+    FILE* sink = fopen(LOG_BENCH_NULL_DEVICE, "w");
+    if (sink == NULL) {
+        fprintf(stderr, "Cannot open %s\n", LOG_BENCH_NULL_DEVICE);
+        return 1;
+    }
+    log_set_output(sink);
+    
+    printf("=== Log Call Cost (%ld calls per thread, median of %d runs) ===\n", calls, repeat);
+    printf("%-10s%10s%14s\n", "Policy", "Threads", "ns/call");
+    for (int policy = LOG_POLICY_FPRINTF; policy <= LOG_POLICY_FILTERED; policy++) {
+        for (int threads = 1; threads <= max_threads; threads *= 2) {
+            double samples[LOG_BENCH_MAX_REPEAT];
+            for (int r = 0; r < repeat; r++) {
+                samples[r] = log_bench_run((log_policy_t)policy, threads, calls, sink);
+            }
+            qsort(samples, (size_t)repeat, sizeof(double), compare_double);
+            printf("%-10s%10d%14.2f\n", LOG_POLICY_NAMES[policy], threads, samples[repeat / 2]);
+        }
+    }
+    
+    if (log_dropped() != 0) {
+        fprintf(stderr, "async: %llu messages dropped\n", (unsigned long long)log_dropped());
+    }
+    log_set_output(stdout);
+    fclose(sink);
+    return 0;
+}
@@ -5,9 +5,9 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <Windows.h>
-#include <shellapi.h>  // For CommandLineToArgvW function
-#include <string.h>    // For strlen function
+#include <stdbool.h>
+#include <string.h>    // For strlen and strcmp functions
+#include "trace.h"
 
 // Function declarations from other source files
 extern int thread_basics_main();
@@ -37,7 +37,7 @@ void display_menu() {
 void run_demo(int (*demo_func)(), const char* demo_name) {
     printf("\n\n%s\n", demo_name);
     printf("====");
-    for (int i = 0; i < strlen(demo_name); i++) {
+    for (size_t i = 0; i < strlen(demo_name); i++) {
         printf("=");
     }
     printf("\n\n");
@@ -49,24 +49,25 @@ void run_demo(int (*demo_func)(), const char* demo_name) {
     getchar();
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     int choice;
-    BOOL interactive = TRUE;
+    bool interactive = true;
+    const char* trace_path = NULL;
     
     // Check if there are command line arguments
-    LPWSTR *szArglist;
-    int nArgs;
-    
-    szArglist = CommandLineToArgvW(GetCommandLineW(), &nArgs);
-    if (szArglist != NULL) {
-        for (int i = 1; i < nArgs; i++) {
-            if (wcscmp(szArglist[i], L"--run-all") == 0) {
-                interactive = FALSE;
-                choice = 8; // Run all demos automatically
-                break;
-            }
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--run-all") == 0) {
+            interactive = false;
+            choice = 8; // Run all demos automatically
+        } else if (strncmp(argv[i], "--trace=", 8) == 0) {
+            trace_path = argv[i] + 8;
         }
-        LocalFree(szArglist);
+    }
+    
+    // Record a Chrome trace of everything the demos do (chrome://tracing, ui.perfetto.dev)
+    if (trace_path != NULL) {
+        trace_thread_name("main");
+        trace_start();
     }
     
     // Interactive mode or automatic run-all mode
@@ -137,5 +138,13 @@ int main() {
         printf("\nAll demos completed successfully.\n");
     }
     
+    if (trace_path != NULL) {
+        trace_stop();
+        if (!trace_write(trace_path)) {
+            fprintf(stderr, "Cannot write %s\n", trace_path);
+            return 1;
+        }
+    }
+    
     return 0;
 } 
\ No newline at end of file
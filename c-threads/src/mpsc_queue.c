@@ -0,0 +1,55 @@
+/**
+ * @file mpsc_queue.c
+ * @brief Push and pop of the intrusive MPSC queue
+ */
+
+#include "mpsc_queue.h"
+
+void mpsc_queue_init(mpsc_queue_t* q) {
+    atomic_init(&q->stub.next, NULL);
+    atomic_init(&q->head, &q->stub);
+    q->tail = &q->stub;
+}
+
+void mpsc_queue_push(mpsc_queue_t* q, mpsc_node_t* node) {
+    atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+    
+    // Claim the position, then link the predecessor to the new node
+    mpsc_node_t* prev = atomic_exchange_explicit(&q->head, node, memory_order_acq_rel);
+    atomic_store_explicit(&prev->next, node, memory_order_release);
+}
+
+mpsc_node_t* mpsc_queue_pop(mpsc_queue_t* q) {
+    mpsc_node_t* tail = q->tail;
+    mpsc_node_t* next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    
+    // Skip over the stub
+    if (tail == &q->stub) {
+        if (next == NULL) {
+            return NULL;
+        }
+        q->tail = next;
+        tail = next;
+        next = atomic_load_explicit(&next->next, memory_order_acquire);
+    }
+    
+    if (next != NULL) {
+        q->tail = next;
+        return tail;
+    }
+    
+    // tail is the last linked node; if it is not the head, a push is still linking
+    mpsc_node_t* head = atomic_load_explicit(&q->head, memory_order_acquire);
+    if (tail != head) {
+        return NULL;
+    }
+    
+    // Re-insert the stub behind the last node so the last node can be handed out
+    mpsc_queue_push(q, &q->stub);
+    next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (next != NULL) {
+        q->tail = next;
+        return tail;
+    }
+    return NULL;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file mpsc_queue.h
+ * @brief Unbounded intrusive multi-producer/single-consumer queue (Dmitry Vyukov's design)
+ *
+ * Callers embed an mpsc_node_t in their own structures, so the queue never
+ * allocates and never fills up. A push is one atomic exchange followed by
+ * one store: it is wait-free and never waits for other producers or for
+ * the consumer. Only one thread at a time may pop.
+ *
+ * A producer that has swapped itself in as the head but not yet linked
+ * its node makes the queue look empty to the consumer until it finishes,
+ * so mpsc_queue_pop() may briefly return NULL while a push is in progress.
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include "thread_port.h"
+
+// Link embedded in every queued element
+typedef struct mpsc_node {
+    _Atomic(struct mpsc_node*) next;
+} mpsc_node_t;
+
+typedef struct {
+    _Atomic(mpsc_node_t*) head;                 // Producers append here
+    char pad_head[PORT_CACHE_LINE - sizeof(void*)];
+    mpsc_node_t* tail;                          // Consumer removes from here
+    mpsc_node_t stub;                           // Keeps the list non-empty
+} mpsc_queue_t;
+
+// Initialize an empty queue
+void mpsc_queue_init(mpsc_queue_t* q);
+
+// Any thread: append a node
+void mpsc_queue_push(mpsc_queue_t* q, mpsc_node_t* node);
+
+// Consumer only: remove the oldest node, or NULL when none is available
+mpsc_node_t* mpsc_queue_pop(mpsc_queue_t* q);
+
+// Recover the enclosing structure from a pointer to its embedded node
+#define MPSC_CONTAINER_OF(node, type, member) \
+    ((type*)((char*)(node) - offsetof(type, member)))
+
+#endif // MPSC_QUEUE_H
@@ -1,27 +1,27 @@
 /**
  * @file mutex_demo.c
- * @brief Mutex usage patterns and deadlock avoidance examples for Windows threads
+ * @brief Mutex usage patterns and deadlock avoidance examples
  */
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <Windows.h>
+#include "thread_port.h"
 
 // Global variables
 #define NUM_THREADS 4
 #define NUM_INCREMENTS 1000000
 
 // Shared counter (no protection)
-LONG unsafe_counter = 0;
+long unsafe_counter = 0;
 
 // Shared counter (with mutex protection)
-LONG safe_counter = 0;
+long safe_counter = 0;
 
 // Mutex for protecting the counter
-HANDLE counter_mutex = NULL;
+port_mutex_t counter_mutex;
 
 // Thread function for unsafe increment
-DWORD WINAPI unsafe_increment_thread(LPVOID arg) {
+int unsafe_increment_thread(void* arg) {
     int thread_id = *((int*)arg);
     printf("Unsafe thread %d starting\n", thread_id);
     
@@ -35,20 +35,20 @@ DWORD WINAPI unsafe_increment_thread(LPVOID arg) {
 }
 
 // Thread function for safe increment using mutex
-DWORD WINAPI safe_increment_thread(LPVOID arg) {
+int safe_increment_thread(void* arg) {
     int thread_id = *((int*)arg);
     printf("Safe thread %d starting\n", thread_id);
     
     // Repeatedly increment the counter with mutex protection
     for (int i = 0; i < NUM_INCREMENTS; i++) {
         // Wait for mutex before accessing the shared counter
-        WaitForSingleObject(counter_mutex, INFINITE);
+        port_mutex_lock(&counter_mutex);
         
         // Critical section - only one thread can be here at a time
         safe_counter++;
         
         // Release the mutex
-        ReleaseMutex(counter_mutex);
+        port_mutex_unlock(&counter_mutex);
     }
     
     printf("Safe thread %d finished\n", thread_id);
@@ -57,7 +57,7 @@ DWORD WINAPI safe_increment_thread(LPVOID arg) {
 
 // Demo for race condition problem
 void race_condition_demo() {
-    HANDLE threads[NUM_THREADS];
+    port_thread_t threads[NUM_THREADS];
     int thread_ids[NUM_THREADS];
     
     printf("\n=== Race Condition Demo ===\n");
@@ -70,32 +70,20 @@ void race_condition_demo() {
     // Create threads
     for (int i = 0; i < NUM_THREADS; i++) {
         thread_ids[i] = i + 1;
-        threads[i] = CreateThread(
-            NULL,               // Default security attributes
-            0,                  // Default stack size
-            unsafe_increment_thread, // Thread function
-            &thread_ids[i],     // Argument to thread function
-            0,                  // Default creation flags
-            NULL                // Don't store thread ID
-        );
-        
-        if (threads[i] == NULL) {
+        if (!port_thread_create(&threads[i], unsafe_increment_thread, &thread_ids[i])) {
             fprintf(stderr, "Error creating thread\n");
             exit(EXIT_FAILURE);
         }
     }
     
     // Wait for all threads to finish
-    WaitForMultipleObjects(NUM_THREADS, threads, TRUE, INFINITE);
-    
-    // Close thread handles
     for (int i = 0; i < NUM_THREADS; i++) {
-        CloseHandle(threads[i]);
+        port_thread_join(threads[i], NULL);
     }
     
     // Check the final counter value
     printf("Expected counter value: %d\n", NUM_THREADS * NUM_INCREMENTS);
-    printf("Actual counter value: %d\n", unsafe_counter);
+    printf("Actual counter value: %ld\n", unsafe_counter);
     if (unsafe_counter != NUM_THREADS * NUM_INCREMENTS) {
         printf("Race condition detected! Counter value is incorrect.\n");
     }
@@ -103,7 +91,7 @@ void race_condition_demo() {
 
 // Demo for mutex protection
 void mutex_protection_demo() {
-    HANDLE threads[NUM_THREADS];
+    port_thread_t threads[NUM_THREADS];
     int thread_ids[NUM_THREADS];
     
     printf("\n=== Mutex Protection Demo ===\n");
@@ -114,50 +102,29 @@ void mutex_protection_demo() {
     safe_counter = 0;
     
     // Create a mutex
-    counter_mutex = CreateMutex(
-        NULL,  // Default security attributes
-        FALSE, // Initially not owned
-        NULL   // Unnamed mutex
-    );
-    
-    if (counter_mutex == NULL) {
-        fprintf(stderr, "Error creating mutex\n");
-        exit(EXIT_FAILURE);
-    }
+    port_mutex_init(&counter_mutex);
     
     // Create threads
     for (int i = 0; i < NUM_THREADS; i++) {
         thread_ids[i] = i + 1;
-        threads[i] = CreateThread(
-            NULL,                // Default security attributes
-            0,                   // Default stack size
-            safe_increment_thread, // Thread function
-            &thread_ids[i],      // Argument to thread function
-            0,                   // Default creation flags
-            NULL                 // Don't store thread ID
-        );
-        
-        if (threads[i] == NULL) {
+        if (!port_thread_create(&threads[i], safe_increment_thread, &thread_ids[i])) {
             fprintf(stderr, "Error creating thread\n");
-            CloseHandle(counter_mutex);
+            port_mutex_destroy(&counter_mutex);
             exit(EXIT_FAILURE);
         }
     }
     
     // Wait for all threads to finish
-    WaitForMultipleObjects(NUM_THREADS, threads, TRUE, INFINITE);
-    
-    // Close thread handles
     for (int i = 0; i < NUM_THREADS; i++) {
-        CloseHandle(threads[i]);
+        port_thread_join(threads[i], NULL);
     }
     
-    // Close the mutex
-    CloseHandle(counter_mutex);
+    // Destroy the mutex
+    port_mutex_destroy(&counter_mutex);
     
     // Check the final counter value
     printf("Expected counter value: %d\n", NUM_THREADS * NUM_INCREMENTS);
-    printf("Actual counter value: %d\n", safe_counter);
+    printf("Actual counter value: %ld\n", safe_counter);
     if (safe_counter == NUM_THREADS * NUM_INCREMENTS) {
         printf("Mutex protection successful! Counter value is correct.\n");
     }
@@ -166,8 +133,8 @@ void mutex_protection_demo() {
 // Structure for deadlock prevention demo
 typedef struct {
     int thread_id;
-    HANDLE* mutex_a;
-    HANDLE* mutex_b;
+    port_mutex_t* mutex_a;
+    port_mutex_t* mutex_b;
 } deadlock_args_t;
 
 // Demo for deadlock prevention
@@ -1,11 +1,12 @@
 /**
  * @file producer_consumer.c
- * @brief Producer-consumer pattern implementation using Windows threads
+ * @brief Producer-consumer pattern implementation
  */
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <Windows.h>
+#include "async_log.h"
+#include "thread_port.h"
 #include <time.h>   // For time() function
 
 // Size of the buffer
@@ -25,9 +26,9 @@ typedef struct {
     int count;                 // Number of items in the buffer
     int in;                    // Index for next insertion
     int out;                   // Index for next removal
-    CRITICAL_SECTION mutex;    // Mutex for buffer access
-    CONDITION_VARIABLE not_full;   // Condition for buffer not full
-    CONDITION_VARIABLE not_empty;  // Condition for buffer not empty
+    port_mutex_t mutex;        // Mutex for buffer access
+    port_cond_t not_full;      // Condition for buffer not full
+    port_cond_t not_empty;     // Condition for buffer not empty
 } bounded_buffer_t;
 
 // Global bounded buffer
@@ -40,18 +41,20 @@ void init_buffer() {
     buffer.out = 0;
     
     // Initialize synchronization objects
-    InitializeCriticalSection(&buffer.mutex);
-    InitializeConditionVariable(&buffer.not_full);
-    InitializeConditionVariable(&buffer.not_empty);
+    port_mutex_init(&buffer.mutex);
+    port_cond_init(&buffer.not_full);
+    port_cond_init(&buffer.not_empty);
     
     printf("Buffer initialized\n");
 }
 
 // Clean up the bounded buffer
 void cleanup_buffer() {
-    DeleteCriticalSection(&buffer.mutex);
+    port_mutex_destroy(&buffer.mutex);
     
-    // No cleanup needed for condition variables in Windows
+    // Condition variables only need cleanup on POSIX backends
+    port_cond_destroy(&buffer.not_full);
+    port_cond_destroy(&buffer.not_empty);
     
     printf("Buffer cleaned up\n");
 }
@@ -59,12 +62,12 @@ void cleanup_buffer() {
 // Insert an item into the buffer (producer operation)
 void buffer_insert(int item) {
     // Acquire the mutex
-    EnterCriticalSection(&buffer.mutex);
+    port_mutex_lock(&buffer.mutex);
     
     // Wait while the buffer is full
     while (buffer.count == BUFFER_SIZE) {
-        printf("Producer: Buffer full, waiting...\n");
-        SleepConditionVariableCS(&buffer.not_full, &buffer.mutex, INFINITE);
+        LOG_INFO("Producer: Buffer full, waiting...");
+        port_cond_wait(&buffer.not_full, &buffer.mutex);
     }
     
     // Insert the item into the buffer
@@ -72,13 +75,13 @@ void buffer_insert(int item) {
     buffer.in = (buffer.in + 1) % BUFFER_SIZE;
     buffer.count++;
     
-    printf("Producer: Inserted item %d, buffer count = %d\n", item, buffer.count);
+    LOG_INFO("Producer: Inserted item %d, buffer count = %d", item, buffer.count);
     
     // Signal that the buffer is not empty
-    WakeConditionVariable(&buffer.not_empty);
+    port_cond_signal(&buffer.not_empty);
     
     // Release the mutex
-    LeaveCriticalSection(&buffer.mutex);
+    port_mutex_unlock(&buffer.mutex);
 }
 
 // Remove an item from the buffer (consumer operation)
@@ -86,12 +89,12 @@ int buffer_remove() {
     int item;
     
     // Acquire the mutex
-    EnterCriticalSection(&buffer.mutex);
+    port_mutex_lock(&buffer.mutex);
     
     // Wait while the buffer is empty
     while (buffer.count == 0) {
-        printf("Consumer: Buffer empty, waiting...\n");
-        SleepConditionVariableCS(&buffer.not_empty, &buffer.mutex, INFINITE);
+        LOG_INFO("Consumer: Buffer empty, waiting...");
+        port_cond_wait(&buffer.not_empty, &buffer.mutex);
     }
     
     // Remove an item from the buffer
@@ -99,62 +102,62 @@ int buffer_remove() {
     buffer.out = (buffer.out + 1) % BUFFER_SIZE;
     buffer.count--;
     
-    printf("Consumer: Removed item %d, buffer count = %d\n", item, buffer.count);
+    LOG_INFO("Consumer: Removed item %d, buffer count = %d", item, buffer.count);
     
     // Signal that the buffer is not full
-    WakeConditionVariable(&buffer.not_full);
+    port_cond_signal(&buffer.not_full);
     
     // Release the mutex
-    LeaveCriticalSection(&buffer.mutex);
+    port_mutex_unlock(&buffer.mutex);
     
     return item;
 }
 
 // Producer thread function
-DWORD WINAPI pc_producer_thread(LPVOID arg) {
+int pc_producer_thread(void* arg) {
     int id = *((int*)arg);
     
-    printf("Producer %d starting\n", id);
+    LOG_INFO("Producer %d starting", id);
     
     for (int i = 0; i < ITEMS_PER_PRODUCER; i++) {
         // Generate an item (producer ID * 100 + iteration)
         int item = (id * 100) + i;
         
         // Simulate some work
-        Sleep(rand() % 500 + 500);
+        port_sleep_ms(rand() % 500 + 500);
         
         // Insert the item into the buffer
         buffer_insert(item);
-        printf("Producer %d inserted item %d\n", id, item);
+        LOG_INFO("Producer %d inserted item %d", id, item);
     }
     
-    printf("Producer %d finished\n", id);
+    LOG_INFO("Producer %d finished", id);
     return 0;
 }
 
 // Consumer thread function
-DWORD WINAPI pc_consumer_thread(LPVOID arg) {
+int pc_consumer_thread(void* arg) {
     int id = *((int*)arg);
     
-    printf("Consumer %d starting\n", id);
+    LOG_INFO("Consumer %d starting", id);
     
     for (int i = 0; i < ITEMS_PER_CONSUMER; i++) {
         // Simulate some work
-        Sleep(rand() % 1000 + 500);
+        port_sleep_ms(rand() % 1000 + 500);
         
         // Remove an item from the buffer
         int item = buffer_remove();
-        printf("Consumer %d removed item %d\n", id, item);
+        LOG_INFO("Consumer %d removed item %d", id, item);
     }
     
-    printf("Consumer %d finished\n", id);
+    LOG_INFO("Consumer %d finished", id);
     return 0;
 }
 
 // Main function to run the producer-consumer demo
 int producer_consumer_main() {
-    HANDLE producers[NUM_PRODUCERS];
-    HANDLE consumers[NUM_CONSUMERS];
+    port_thread_t producers[NUM_PRODUCERS];
+    port_thread_t consumers[NUM_CONSUMERS];
     int producer_ids[NUM_PRODUCERS];
     int consumer_ids[NUM_CONSUMERS];
     
@@ -169,21 +172,12 @@ int producer_consumer_main() {
     // Create producer threads
     for (int i = 0; i < NUM_PRODUCERS; i++) {
         producer_ids[i] = i + 1;
-        producers[i] = CreateThread(
-            NULL,                // Default security attributes
-            0,                   // Default stack size
-            pc_producer_thread,  // Thread function
-            &producer_ids[i],    // Argument to thread function
-            0,                   // Default creation flags
-            NULL                 // Don't store thread ID
-        );
-        
-        if (producers[i] == NULL) {
+        if (!port_thread_create(&producers[i], pc_producer_thread, &producer_ids[i])) {
             fprintf(stderr, "Error creating producer thread %d\n", i + 1);
             
-            // Close already created threads
+            // Detach already created threads
             for (int j = 0; j < i; j++) {
-                CloseHandle(producers[j]);
+                port_thread_detach(producers[j]);
             }
             
             cleanup_buffer();
@@ -194,26 +188,17 @@ int producer_consumer_main() {
     // Create consumer threads
     for (int i = 0; i < NUM_CONSUMERS; i++) {
         consumer_ids[i] = i + 1;
-        consumers[i] = CreateThread(
-            NULL,                // Default security attributes
-            0,                   // Default stack size
-            pc_consumer_thread,  // Thread function
-            &consumer_ids[i],    // Argument to thread function
-            0,                   // Default creation flags
-            NULL                 // Don't store thread ID
-        );
-        
-        if (consumers[i] == NULL) {
+        if (!port_thread_create(&consumers[i], pc_consumer_thread, &consumer_ids[i])) {
             fprintf(stderr, "Error creating consumer thread %d\n", i + 1);
             
-            // Close producer threads
+            // Detach producer threads
             for (int j = 0; j < NUM_PRODUCERS; j++) {
-                CloseHandle(producers[j]);
+                port_thread_detach(producers[j]);
             }
             
-            // Close already created consumer threads
+            // Detach already created consumer threads
             for (int j = 0; j < i; j++) {
-                CloseHandle(consumers[j]);
+                port_thread_detach(consumers[j]);
             }
             
             cleanup_buffer();
@@ -222,20 +207,18 @@ int producer_consumer_main() {
     }
     
     // Wait for all producer threads to finish
-    WaitForMultipleObjects(NUM_PRODUCERS, producers, TRUE, INFINITE);
-    
-    // Wait for all consumer threads to finish
-    WaitForMultipleObjects(NUM_CONSUMERS, consumers, TRUE, INFINITE);
-    
-    // Close all thread handles
     for (int i = 0; i < NUM_PRODUCERS; i++) {
-        CloseHandle(producers[i]);
+        port_thread_join(producers[i], NULL);
     }
     
+    // Wait for all consumer threads to finish
     for (int i = 0; i < NUM_CONSUMERS; i++) {
-        CloseHandle(consumers[i]);
+        port_thread_join(consumers[i], NULL);
     }
     
+    // Let the threads' log lines out before the summary
+    log_flush();
+    
     // Clean up the buffer
     cleanup_buffer();
     
@@ -0,0 +1,209 @@
+/**
+ * @file submit_bench.c
+ * @brief Submission latency of the locked ring queue and the lock-free inbox
+ *
+ * Many submitter threads call thread_pool_add_work() at the same time and
+ * time every call. In shared-queue mode each call takes the queue lock and
+ * blocks while the fixed-size ring is full; in work-stealing mode external
+ * submissions go through the unbounded MPSC inbox. The report lists latency
+ * percentiles over all calls of all submitters.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "thread_port.h"
+#include "thread_pool.h"
+
+// Default benchmark parameters
+#define SUBMIT_DEFAULT_SUBMITTERS 16
+#define SUBMIT_DEFAULT_JOBS 20000
+#define SUBMIT_DEFAULT_WORK 50
+
+// Benchmark parameters
+typedef struct {
+    int submitters;     // Concurrent submitting threads
+    long jobs;          // Jobs per submitter
+    int work;           // Busy-loop iterations per job
+    int threads;        // Worker threads per pool
+} submit_bench_config_t;
+
+// One submitting thread and its latency samples
+typedef struct {
+    thread_pool_t* pool;
+    long jobs;
+    uint64_t* latencies;
+    long failed;
+} submitter_t;
+
+// Latency summary of one pool mode, in nanoseconds
+typedef struct {
+    uint64_t p50, p90, p99, p999, max;
+    double submits_per_sec;
+    long rejected;
+} submit_result_t;
+
+// State shared by the submitters and jobs of one run
+static atomic_int submit_go;
+static atomic_long submit_completed;
+static int submit_work = 0;
+
+static void submit_tiny_job(void* arg) {
+    (void)arg;
+    volatile unsigned int x = 1;
+    for (int i = 0; i < submit_work; i++) {
+        x = x * 1664525u + 1013904223u;
+    }
+    atomic_fetch_add_explicit(&submit_completed, 1, memory_order_relaxed);
+}
+
+// Submit every job, timing each call individually
+static int submitter_thread(void* arg) {
+    submitter_t* self = (submitter_t*)arg;
+    
+    // Start all submitters together so they contend from the first call
+    while (!atomic_load_explicit(&submit_go, memory_order_acquire)) {
+        port_thread_yield();
+    }
+    
+    for (long i = 0; i < self->jobs; i++) {
+        uint64_t start = port_time_ns();
+        bool added = thread_pool_add_work(self->pool, submit_tiny_job, NULL);
+        self->latencies[i] = port_time_ns() - start;
+        if (!added) {
+            self->failed++;
+        }
+    }
+    return 0;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Value at the given fraction of a sorted sample array
+static uint64_t percentile(const uint64_t* sorted, size_t count, double fraction) {
+    size_t index = (size_t)(fraction * (double)(count - 1) + 0.5);
+    return sorted[index];
+}
+
+// Run one pool mode and summarize its submission latencies
+static submit_result_t submit_run(thread_pool_mode_t mode, const submit_bench_config_t* config) {
+    size_t total = (size_t)config->submitters * (size_t)config->jobs;
+    uint64_t* latencies = (uint64_t*)malloc(total * sizeof(uint64_t));
+    submitter_t* submitters = (submitter_t*)calloc((size_t)config->submitters, sizeof(submitter_t));
+    port_thread_t* threads = (port_thread_t*)malloc((size_t)config->submitters * sizeof(port_thread_t));
+    if (latencies == NULL || submitters == NULL || threads == NULL) {
+        fprintf(stderr, "Failed to allocate submit benchmark buffers\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    thread_pool_t* pool = thread_pool_init(mode, config->threads);
+    if (pool == NULL || !thread_pool_start(pool)) {
+        fprintf(stderr, "Failed to start %s pool\n", thread_pool_mode_name(mode));
+        exit(EXIT_FAILURE);
+    }
+    
+    atomic_store(&submit_go, 0);
+    atomic_store(&submit_completed, 0);
+    submit_work = config->work;
+    
+    for (int s = 0; s < config->submitters; s++) {
+        submitters[s].pool = pool;
+        submitters[s].jobs = config->jobs;
+        submitters[s].latencies = latencies + (size_t)s * (size_t)config->jobs;
+        if (!port_thread_create(&threads[s], submitter_thread, &submitters[s])) {
+            fprintf(stderr, "Failed to create submitter thread %d\n", s);
+            exit(EXIT_FAILURE);
+        }
+    }
+    
+    uint64_t start = port_time_ns();
+    atomic_store_explicit(&submit_go, 1, memory_order_release);
+    
+    long failed = 0;
+    for (int s = 0; s < config->submitters; s++) {
+        port_thread_join(threads[s], NULL);
+        failed += submitters[s].failed;
+    }
+    uint64_t submit_elapsed = port_time_ns() - start;
+    
+    // Every accepted job must run exactly once before the pool goes away
+    long expected = (long)total - failed;
+    while (atomic_load_explicit(&submit_completed, memory_order_acquire) < expected) {
+        port_thread_yield();
+    }
+    thread_pool_shutdown(pool);
+    
+    qsort(latencies, total, sizeof(uint64_t), compare_u64);
+    submit_result_t result;
+    result.p50 = percentile(latencies, total, 0.50);
+    result.p90 = percentile(latencies, total, 0.90);
+    result.p99 = percentile(latencies, total, 0.99);
+    result.p999 = percentile(latencies, total, 0.999);
+    result.max = latencies[total - 1];
+    result.submits_per_sec = (double)total / ((double)submit_elapsed / 1e9);
+    result.rejected = failed;
+    
+    free(threads);
+    free(submitters);
+    free(latencies);
+    return result;
+}
+
+static void print_usage(void) {
+    printf("Usage: CThreadsBench submit [--submitters=N] [--jobs=N] [--work=N] [--threads=N]\n");
+}
+
+// Entry point of the submission latency benchmark
+int submit_bench_main(int argc, char* argv[]) {
+    submit_bench_config_t config = {
+        SUBMIT_DEFAULT_SUBMITTERS, SUBMIT_DEFAULT_JOBS, SUBMIT_DEFAULT_WORK, port_cpu_count()
+    };
+    
+    for (int i = 0; i < argc; i++) {
+        if (strncmp(argv[i], "--submitters=", 13) == 0) {
+            config.submitters = atoi(argv[i] + 13);
+        } else if (strncmp(argv[i], "--jobs=", 7) == 0) {
+            config.jobs = atol(argv[i] + 7);
+        } else if (strncmp(argv[i], "--work=", 7) == 0) {
+            config.work = atoi(argv[i] + 7);
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            config.threads = atoi(argv[i] + 10);
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    
+    if (config.submitters <= 0 || config.jobs <= 0 || config.work < 0 || config.threads <= 0) {
+        print_usage();
+        return 1;
+    }
+    
+    printf("=== Submit Latency Benchmark ===\n");
+    printf("Submitters: %d, jobs per submitter: %ld, work per job: %d, workers: %d\n",
+           config.submitters, config.jobs, config.work, config.threads);
+    
+    submit_result_t results[2];
+    results[0] = submit_run(THREAD_POOL_SHARED_QUEUE, &config);
+    results[1] = submit_run(THREAD_POOL_WORK_STEALING, &config);
+    
+    printf("\n%-15s %9s %9s %9s %9s %11s %14s\n",
+           "Mode", "p50 ns", "p90 ns", "p99 ns", "p99.9 ns", "max ns", "Submits/sec");
+    for (int m = 0; m < 2; m++) {
+        printf("%-15s %9llu %9llu %9llu %9llu %11llu %14.0f\n",
+               thread_pool_mode_name((thread_pool_mode_t)m),
+               (unsigned long long)results[m].p50, (unsigned long long)results[m].p90,
+               (unsigned long long)results[m].p99, (unsigned long long)results[m].p999,
+               (unsigned long long)results[m].max, results[m].submits_per_sec);
+        if (results[m].rejected > 0) {
+            printf("%-15s %ld submissions rejected\n", "", results[m].rejected);
+        }
+    }
+    
+    return 0;
+}
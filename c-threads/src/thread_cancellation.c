@@ -1,22 +1,22 @@
 /**
  * @file thread_cancellation.c
- * @brief Safe thread termination techniques for Windows threads
+ * @brief Safe thread termination techniques
  */
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <Windows.h>
+#include "thread_port.h"
 #include <stdbool.h>
 
 // Structure for thread parameters
 typedef struct {
     int thread_id;
     volatile bool* should_exit;  // Flag for cooperative cancellation
-    HANDLE complete_event;       // Event to signal when cleanup is done
+    port_event_t* complete_event; // Event to signal when cleanup is done
 } thread_params_t;
 
 // Thread function that checks for cancellation
-DWORD WINAPI cancellable_thread(LPVOID arg) {
+int cancellable_thread(void* arg) {
     thread_params_t* params = (thread_params_t*)arg;
     int thread_id = params->thread_id;
     volatile bool* should_exit = params->should_exit;
@@ -30,7 +30,7 @@ DWORD WINAPI cancellable_thread(LPVOID arg) {
         return 1;
     }
     
-    sprintf_s(resource, 100, "Resource for thread %d", thread_id);
+    snprintf(resource, 100, "Resource for thread %d", thread_id);
     printf("Thread %d: Allocated resource: %s\n", thread_id, resource);
     
     // Main work loop with cancellation points
@@ -44,7 +44,7 @@ DWORD WINAPI cancellable_thread(LPVOID arg) {
             
             // Signal that cleanup is complete
             if (params->complete_event != NULL) {
-                SetEvent(params->complete_event);
+                port_event_set(params->complete_event);
             }
             
             return 0;
@@ -52,7 +52,7 @@ DWORD WINAPI cancellable_thread(LPVOID arg) {
         
         // Do some work
         printf("Thread %d: Working... (%d/20)\n", thread_id, i + 1);
-        Sleep(200);  // Simulate work
+        port_sleep_ms(200);  // Simulate work
     }
     
     // Normal completion
@@ -67,50 +67,34 @@ DWORD WINAPI cancellable_thread(LPVOID arg) {
 
 // Demo for cooperative cancellation
 void cooperative_cancellation_demo() {
-    HANDLE thread;
-    HANDLE complete_event;
+    port_thread_t thread;
+    port_event_t complete_event;
     volatile bool should_exit = false;
     thread_params_t params;
     
     printf("\n=== Cooperative Cancellation Demo ===\n");
     
     // Create event for signaling cleanup completion
-    complete_event = CreateEvent(
-        NULL,    // Default security attributes
-        TRUE,    // Manual reset
-        FALSE,   // Initial state non-signaled
-        NULL     // Unnamed event
-    );
-    
-    if (complete_event == NULL) {
-        fprintf(stderr, "Failed to create event: %lu\n", GetLastError());
+    if (!port_event_init(&complete_event, true)) {   // Manual reset, initially non-signaled
+        fprintf(stderr, "Failed to create event: %d\n", port_last_error());
         return;
     }
     
     // Set up thread parameters
     params.thread_id = 1;
     params.should_exit = &should_exit;
-    params.complete_event = complete_event;
+    params.complete_event = &complete_event;
     
     // Create the thread
-    thread = CreateThread(
-        NULL,                 // Default security attributes
-        0,                    // Default stack size
-        cancellable_thread,   // Thread function
-        &params,              // Thread parameters
-        0,                    // Default creation flags
-        NULL                  // Don't store thread ID
-    );
-    
-    if (thread == NULL) {
-        fprintf(stderr, "Failed to create thread: %lu\n", GetLastError());
-        CloseHandle(complete_event);
+    if (!port_thread_create(&thread, cancellable_thread, &params)) {
+        fprintf(stderr, "Failed to create thread: %d\n", port_last_error());
+        port_event_destroy(&complete_event);
         return;
     }
     
     // Let the thread run for a while
     printf("Main thread: Letting thread run for 2 seconds...\n");
-    Sleep(2000);
+    port_sleep_ms(2000);
     
     // Request cancellation
     printf("Main thread: Requesting thread cancellation\n");
@@ -118,28 +102,23 @@ void cooperative_cancellation_demo() {
     
     // Wait for the thread to signal it has cleaned up
     printf("Main thread: Waiting for thread to clean up...\n");
-    DWORD wait_result = WaitForSingleObject(complete_event, 5000);  // 5 second timeout
-    
-    if (wait_result == WAIT_OBJECT_0) {
+    if (port_event_wait(&complete_event, 5000)) {  // 5 second timeout
         printf("Main thread: Thread reported successful cleanup\n");
-    } else if (wait_result == WAIT_TIMEOUT) {
-        fprintf(stderr, "Main thread: Timeout waiting for thread cleanup\n");
     } else {
-        fprintf(stderr, "Main thread: Wait error: %lu\n", GetLastError());
+        fprintf(stderr, "Main thread: Timeout waiting for thread cleanup\n");
     }
     
     // Wait for the thread to exit
-    WaitForSingleObject(thread, INFINITE);
+    port_thread_join(thread, NULL);
     
-    // Clean up handles
-    CloseHandle(thread);
-    CloseHandle(complete_event);
+    // Clean up the event
+    port_event_destroy(&complete_event);
     
     printf("Cooperative cancellation demo completed\n");
 }
 
 // Thread function that doesn't check for cancellation
-DWORD WINAPI uncancellable_thread(LPVOID arg) {
+int uncancellable_thread(void* arg) {
     int thread_id = *((int*)arg);
     
     printf("Uncancellable thread %d: Starting\n", thread_id);
@@ -147,7 +126,7 @@ DWORD WINAPI uncancellable_thread(LPVOID arg) {
     // Main work loop with no cancellation checks
     for (int i = 0; i < 10; i++) {
         printf("Uncancellable thread %d: Working... (%d/10)\n", thread_id, i + 1);
-        Sleep(500);  // Simulate work
+        port_sleep_ms(500);  // Simulate work
     }
     
     printf("Uncancellable thread %d: Completed\n", thread_id);
@@ -156,43 +135,32 @@ DWORD WINAPI uncancellable_thread(LPVOID arg) {
 
 // Demo for forced termination (not recommended)
 void forced_termination_demo() {
-    HANDLE thread;
+    port_thread_t thread;
     int thread_id = 2;
     
     printf("\n=== Forced Termination Demo (Not Recommended) ===\n");
     
     // Create the thread
-    thread = CreateThread(
-        NULL,                  // Default security attributes
-        0,                     // Default stack size
-        uncancellable_thread,  // Thread function
-        &thread_id,            // Thread parameters
-        0,                     // Default creation flags
-        NULL                   // Don't store thread ID
-    );
-    
-    if (thread == NULL) {
-        fprintf(stderr, "Failed to create thread: %lu\n", GetLastError());
+    if (!port_thread_create(&thread, uncancellable_thread, &thread_id)) {
+        fprintf(stderr, "Failed to create thread: %d\n", port_last_error());
         return;
     }
     
     // Let the thread run for a while
     printf("Main thread: Letting thread run for 2 seconds...\n");
-    Sleep(2000);
+    port_sleep_ms(2000);
     
     // Forcibly terminate the thread (not recommended)
     printf("Main thread: WARNING - About to forcibly terminate thread\n");
     printf("Main thread: This is NOT recommended as it can cause resource leaks!\n");
     
-    if (TerminateThread(thread, 1)) {
+    // TerminateThread on Windows, pthread_cancel on POSIX; releases the handle either way
+    if (port_thread_terminate(thread)) {
         printf("Main thread: Thread terminated forcibly\n");
     } else {
-        fprintf(stderr, "Main thread: Failed to terminate thread: %lu\n", GetLastError());
+        fprintf(stderr, "Main thread: Failed to terminate thread: %d\n", port_last_error());
     }
     
-    // Clean up handle
-    CloseHandle(thread);
-    
     printf("Forced termination demo completed\n");
     printf("WARNING: Forced termination can lead to resource leaks and other issues!\n");
     printf("It's always better to use cooperative cancellation.\n");
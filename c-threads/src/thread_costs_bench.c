@@ -0,0 +1,218 @@
+/**
+ * @file thread_costs_bench.c
+ * @brief Raw costs of the threading backend selected at configure time
+ *
+ * Measures the primitives every demo is built on, so the win32, pthread and
+ * futex backends can be compared directly:
+ * - create/join: starting and joining an empty thread
+ * - mutex:       an uncontended lock/unlock pair
+ * - event wake:  one-way wake latency, from a ping-pong of two auto-reset events
+ * - cond wake:   one-way wake latency, from a condition variable ping-pong
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "thread_port.h"
+
+// Default benchmark parameters
+#define COSTS_DEFAULT_ITERATIONS 20000
+#define COSTS_DEFAULT_REPEAT 5
+#define COSTS_MAX_REPEAT 32
+
+// Benchmark parameters
+typedef struct {
+    long iterations;    // Operations per run (thread creations are capped lower)
+    int repeat;         // Runs per measurement (median is reported)
+} costs_bench_config_t;
+
+// Empty thread body for the create/join measurement
+static int costs_empty_thread(void* arg) {
+    (void)arg;
+    return 0;
+}
+
+// Start and join one thread per iteration
+static uint64_t costs_create_join(long iterations) {
+    uint64_t start = port_time_ns();
+    for (long i = 0; i < iterations; i++) {
+        port_thread_t thread;
+        if (!port_thread_create(&thread, costs_empty_thread, NULL)) {
+            fprintf(stderr, "Failed to create thread: %d\n", port_last_error());
+            exit(EXIT_FAILURE);
+        }
+        port_thread_join(thread, NULL);
+    }
+    return port_time_ns() - start;
+}
+
+// Lock and unlock a mutex nobody else touches
+static uint64_t costs_mutex(long iterations) {
+    port_mutex_t mutex;
+    port_mutex_init(&mutex);
+    
+    uint64_t start = port_time_ns();
+    for (long i = 0; i < iterations; i++) {
+        port_mutex_lock(&mutex);
+        port_mutex_unlock(&mutex);
+    }
+    uint64_t elapsed = port_time_ns() - start;
+    
+    port_mutex_destroy(&mutex);
+    return elapsed;
+}
+
+// Two auto-reset events bounced between the main thread and a partner
+typedef struct {
+    port_event_t ping;
+    port_event_t pong;
+    long iterations;
+} costs_event_pair_t;
+
+static int costs_event_partner(void* arg) {
+    costs_event_pair_t* pair = (costs_event_pair_t*)arg;
+    for (long i = 0; i < pair->iterations; i++) {
+        port_event_wait(&pair->ping, PORT_INFINITE);
+        port_event_set(&pair->pong);
+    }
+    return 0;
+}
+
+// Every round trip is two wakeups, so report half of it per operation
+static uint64_t costs_event_wake(long iterations) {
+    costs_event_pair_t pair;
+    pair.iterations = iterations;
+    port_event_init(&pair.ping, false);
+    port_event_init(&pair.pong, false);
+    
+    port_thread_t partner;
+    if (!port_thread_create(&partner, costs_event_partner, &pair)) {
+        fprintf(stderr, "Failed to create thread: %d\n", port_last_error());
+        exit(EXIT_FAILURE);
+    }
+    
+    uint64_t start = port_time_ns();
+    for (long i = 0; i < iterations; i++) {
+        port_event_set(&pair.ping);
+        port_event_wait(&pair.pong, PORT_INFINITE);
+    }
+    uint64_t elapsed = port_time_ns() - start;
+    
+    port_thread_join(partner, NULL);
+    port_event_destroy(&pair.ping);
+    port_event_destroy(&pair.pong);
+    return elapsed / 2;
+}
+
+// A turn counter handed back and forth under one mutex and condition variable
+typedef struct {
+    port_mutex_t mutex;
+    port_cond_t cond;
+    long turn;          // Even: main thread's turn, odd: partner's turn
+    long iterations;
+} costs_cond_pair_t;
+
+static int costs_cond_partner(void* arg) {
+    costs_cond_pair_t* pair = (costs_cond_pair_t*)arg;
+    port_mutex_lock(&pair->mutex);
+    for (long i = 0; i < pair->iterations; i++) {
+        while (pair->turn % 2 == 0) {
+            port_cond_wait(&pair->cond, &pair->mutex);
+        }
+        pair->turn++;
+        port_cond_signal(&pair->cond);
+    }
+    port_mutex_unlock(&pair->mutex);
+    return 0;
+}
+
+static uint64_t costs_cond_wake(long iterations) {
+    costs_cond_pair_t pair;
+    pair.turn = 0;
+    pair.iterations = iterations;
+    port_mutex_init(&pair.mutex);
+    port_cond_init(&pair.cond);
+    
+    port_thread_t partner;
+    if (!port_thread_create(&partner, costs_cond_partner, &pair)) {
+        fprintf(stderr, "Failed to create thread: %d\n", port_last_error());
+        exit(EXIT_FAILURE);
+    }
+    
+    uint64_t start = port_time_ns();
+    port_mutex_lock(&pair.mutex);
+    for (long i = 0; i < iterations; i++) {
+        pair.turn++;
+        port_cond_signal(&pair.cond);
+        while (pair.turn % 2 == 1) {
+            port_cond_wait(&pair.cond, &pair.mutex);
+        }
+    }
+    port_mutex_unlock(&pair.mutex);
+    uint64_t elapsed = port_time_ns() - start;
+    
+    port_thread_join(partner, NULL);
+    port_cond_destroy(&pair.cond);
+    port_mutex_destroy(&pair.mutex);
+    return elapsed / 2;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Median nanoseconds per operation over the configured number of repetitions
+static double costs_median(uint64_t (*measure)(long), long iterations, int repeat) {
+    uint64_t samples[COSTS_MAX_REPEAT];
+    for (int r = 0; r < repeat; r++) {
+        samples[r] = measure(iterations);
+    }
+    qsort(samples, (size_t)repeat, sizeof(uint64_t), compare_u64);
+    return (double)samples[repeat / 2] / (double)iterations;
+}
+
+static void print_usage(void) {
+    printf("Usage: CThreadsBench costs [--iterations=N] [--repeat=N]\n");
+}
+
+// Entry point of the backend costs benchmark
+int thread_costs_bench_main(int argc, char* argv[]) {
+    costs_bench_config_t config = { COSTS_DEFAULT_ITERATIONS, COSTS_DEFAULT_REPEAT };
+    
+    for (int i = 0; i < argc; i++) {
+        if (strncmp(argv[i], "--iterations=", 13) == 0) {
+            config.iterations = atol(argv[i] + 13);
+        } else if (strncmp(argv[i], "--repeat=", 9) == 0) {
+            config.repeat = atoi(argv[i] + 9);
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    
+    if (config.iterations <= 0 || config.repeat <= 0 || config.repeat > COSTS_MAX_REPEAT) {
+        print_usage();
+        return 1;
+    }
+    
+    // Thread creation is orders of magnitude slower than the other operations
+    long thread_iterations = config.iterations / 10 > 0 ? config.iterations / 10 : 1;
+    
+    printf("=== Threading Backend Costs ===\n");
+    printf("Backend: %s, CPUs: %d, iterations: %ld, repetitions: %d\n",
+           port_backend_name(), port_cpu_count(), config.iterations, config.repeat);
+    
+    printf("\n%-22s %14s\n", "Operation", "Median ns/op");
+    printf("%-22s %14.1f\n", "thread create+join",
+           costs_median(costs_create_join, thread_iterations, config.repeat));
+    printf("%-22s %14.1f\n", "mutex lock+unlock",
+           costs_median(costs_mutex, config.iterations * 100, config.repeat));
+    printf("%-22s %14.1f\n", "event wake latency",
+           costs_median(costs_event_wake, config.iterations, config.repeat));
+    printf("%-22s %14.1f\n", "condvar wake latency",
+           costs_median(costs_cond_wake, config.iterations, config.repeat));
+    
+    return 0;
+}
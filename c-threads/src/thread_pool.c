@@ -1,45 +1,237 @@
 /**
  * @file thread_pool.c
- * @brief Basic thread pool implementation using Windows threads
+ * @brief Thread pool with a shared-queue mode and a work-stealing mode
+ *
+ * The shared-queue mode funnels every job through one locked ring buffer.
+ * The work-stealing mode gives each worker a Chase-Lev deque: jobs spawned
+ * by a running job are pushed to the owner's end without any lock, and idle
+ * workers steal from the opposite end of a randomly chosen victim. Jobs
+ * submitted from outside the pool go through an unbounded MPSC inbox: a
+ * submission never waits for a full buffer and only takes the lock to wake
+ * a parked worker. One worker at a time drains the inbox in batches.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <Windows.h>
 #include <stdbool.h>
+#include <stdatomic.h>
+#include "thread_port.h"
+#include "thread_pool.h"
+#include "async_log.h"
+#include "lock_profiler.h"
+#include "mpsc_queue.h"
+#include "trace.h"
 
-// Maximum number of jobs in the queue
+// Maximum number of jobs in the queue (shared-queue mode)
 #define MAX_QUEUE_SIZE 100
 
-// Number of worker threads in the pool
-#define THREAD_POOL_SIZE 4
+// Initial number of slots in each work-stealing deque (power of two)
+#define WS_DEQUE_INITIAL_CAPACITY 256
+
+// Most jobs a worker moves from the inbox to its deque at once
+#define WS_INJECT_BATCH 32
+
+// Function executed by a work item
+typedef void (*work_fn_t)(void*);
 
 // Structure for a work item
 typedef struct {
-    void (*function)(void*);   // Function to execute
+    work_fn_t function;        // Function to execute
     void* argument;            // Argument to the function
+    uint64_t queued_at;        // When it was queued while tracing, else 0
+    uint64_t trace_id;         // Ties the queue-wait begin to its end
 } work_item_t;
 
-// Thread pool structure
+// Externally submitted job waiting in the work-stealing inbox
 typedef struct {
-    work_item_t queue[MAX_QUEUE_SIZE];  // Work queue
-    int queue_size;                      // Current size of the queue
-    int head;                            // Head of the queue
-    int tail;                            // Tail of the queue
-    
-    HANDLE worker_threads[THREAD_POOL_SIZE];  // Worker threads
-    CRITICAL_SECTION queue_lock;              // Lock for queue access
-    CONDITION_VARIABLE queue_not_empty;       // Condition for queue not empty
-    CONDITION_VARIABLE queue_not_full;        // Condition for queue not full
-    
-    bool shutdown;                            // Flag to signal shutdown
-} thread_pool_t;
+    mpsc_node_t node;          // Inbox link
+    work_item_t item;
+} inbox_job_t;
+
+// Deque slot; thieves read it concurrently with the owner, so fields are atomic.
+// Only the function and argument are kept, so jobs in deques are traced without queue wait.
+typedef struct {
+    _Atomic(work_fn_t) function;
+    _Atomic(void*) argument;
+} ws_slot_t;
+
+// Circular slot array of a deque; replaced by a larger one when full
+typedef struct ws_buffer {
+    int64_t capacity;              // Number of slots, always a power of two
+    struct ws_buffer* retired;     // Smaller predecessor, freed when the pool shuts down
+    ws_slot_t slots[];
+} ws_buffer_t;
+
+// Chase-Lev work-stealing deque (Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models", PPoPP 2013)
+typedef struct {
+    atomic_llong top;                                   // Thieves take from here
+    char pad_top[PORT_CACHE_LINE - sizeof(atomic_llong)];
+    atomic_llong bottom;                                // Owner pushes and pops here
+    char pad_bottom[PORT_CACHE_LINE - sizeof(atomic_llong)];
+    _Atomic(ws_buffer_t*) buffer;
+} ws_deque_t;
+
+// Result of a steal attempt
+typedef enum {
+    WS_STEAL_EMPTY,     // Victim had nothing to steal
+    WS_STEAL_ABORT,     // Lost a race with another thief or the owner
+    WS_STEAL_SUCCESS
+} ws_steal_result_t;
+
+// Per-worker state in work-stealing mode
+typedef struct {
+    ws_deque_t deque;          // Jobs owned by this worker
+    thread_pool_t* pool;       // Pool the worker belongs to
+    unsigned int rng;          // xorshift state for victim selection
+} ws_worker_t;
+
+// Thread pool structure
+struct thread_pool {
+    thread_pool_mode_t mode;                  // How work is distributed
+    int num_threads;                          // Number of worker threads
+    
+    work_item_t queue[MAX_QUEUE_SIZE];        // Work queue (shared-queue mode only)
+    int queue_size;                           // Current size of the queue
+    int head;                                 // Head of the queue
+    int tail;                                 // Tail of the queue
+    
+    port_thread_t* worker_threads;            // Worker threads
+    profiled_mutex_t queue_lock;              // Lock for queue access
+    port_cond_t queue_not_empty;              // Condition for queue not empty (parking in work stealing)
+    port_cond_t queue_not_full;               // Condition for queue not full
+    
+    atomic_bool shutdown;                     // Flag to signal shutdown
+    
+    ws_worker_t* workers;                     // Per-worker deques (work-stealing mode only)
+    mpsc_queue_t inbox;                       // Jobs submitted from outside (work-stealing mode only)
+    atomic_flag inbox_draining;               // Held by the one worker popping the inbox
+    atomic_long pending;                      // Jobs queued anywhere but not yet taken
+    atomic_int sleepers;                      // Workers parked on queue_not_empty
+};
 
 // Global thread pool
 thread_pool_t* g_pool = NULL;
 
+// Pool and worker the current thread belongs to (NULL outside of pool workers)
+static PORT_THREAD_LOCAL thread_pool_t* tls_pool = NULL;
+static PORT_THREAD_LOCAL ws_worker_t* tls_worker = NULL;
+
+// =================== WORK-STEALING DEQUE ===================
+
+static ws_buffer_t* ws_buffer_new(int64_t capacity, ws_buffer_t* retired) {
+    ws_buffer_t* buffer = (ws_buffer_t*)malloc(sizeof(ws_buffer_t) + (size_t)capacity * sizeof(ws_slot_t));
+    if (buffer == NULL) {
+        fprintf(stderr, "Error: Failed to allocate work-stealing deque buffer\n");
+        exit(EXIT_FAILURE);
+    }
+    buffer->capacity = capacity;
+    buffer->retired = retired;
+    return buffer;
+}
+
+static void ws_slot_write(ws_buffer_t* buffer, int64_t index, work_item_t item) {
+    ws_slot_t* slot = &buffer->slots[index & (buffer->capacity - 1)];
+    atomic_store_explicit(&slot->function, item.function, memory_order_relaxed);
+    atomic_store_explicit(&slot->argument, item.argument, memory_order_relaxed);
+}
+
+static work_item_t ws_slot_read(ws_buffer_t* buffer, int64_t index) {
+    ws_slot_t* slot = &buffer->slots[index & (buffer->capacity - 1)];
+    work_item_t item = { NULL, NULL, 0, 0 };
+    item.function = atomic_load_explicit(&slot->function, memory_order_relaxed);
+    item.argument = atomic_load_explicit(&slot->argument, memory_order_relaxed);
+    return item;
+}
+
+static void ws_deque_init(ws_deque_t* dq) {
+    atomic_init(&dq->top, 0);
+    atomic_init(&dq->bottom, 0);
+    atomic_init(&dq->buffer, ws_buffer_new(WS_DEQUE_INITIAL_CAPACITY, NULL));
+}
+
+static void ws_deque_destroy(ws_deque_t* dq) {
+    ws_buffer_t* buffer = atomic_load_explicit(&dq->buffer, memory_order_relaxed);
+    while (buffer != NULL) {
+        ws_buffer_t* retired = buffer->retired;
+        free(buffer);
+        buffer = retired;
+    }
+}
+
+// Owner only: push a job at the bottom, doubling the buffer when full
+static void ws_deque_push(ws_deque_t* dq, work_item_t item) {
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_relaxed);
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+    ws_buffer_t* buffer = atomic_load_explicit(&dq->buffer, memory_order_relaxed);
+    
+    if (b - t > buffer->capacity - 1) {
+        // Thieves may still be reading the old buffer, so it is retired rather than freed
+        ws_buffer_t* grown = ws_buffer_new(buffer->capacity * 2, buffer);
+        for (int64_t i = t; i < b; i++) {
+            ws_slot_write(grown, i, ws_slot_read(buffer, i));
+        }
+        atomic_store_explicit(&dq->buffer, grown, memory_order_release);
+        buffer = grown;
+    }
+    
+    ws_slot_write(buffer, b, item);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+}
+
+// Owner only: pop the most recently pushed job
+static bool ws_deque_pop(ws_deque_t* dq, work_item_t* item) {
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_relaxed) - 1;
+    ws_buffer_t* buffer = atomic_load_explicit(&dq->buffer, memory_order_relaxed);
+    atomic_store_explicit(&dq->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_relaxed);
+    
+    if (t > b) {
+        // Deque was empty
+        atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+        return false;
+    }
+    
+    *item = ws_slot_read(buffer, b);
+    if (t == b) {
+        // Last job: race the thieves for it
+        bool won = atomic_compare_exchange_strong_explicit(
+            &dq->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+// Any thread: take the oldest job from the top
+static ws_steal_result_t ws_deque_steal(ws_deque_t* dq, work_item_t* item) {
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_acquire);
+    
+    if (t >= b) {
+        return WS_STEAL_EMPTY;
+    }
+    
+    ws_buffer_t* buffer = atomic_load_explicit(&dq->buffer, memory_order_acquire);
+    *item = ws_slot_read(buffer, t);
+    if (!atomic_compare_exchange_strong_explicit(
+            &dq->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed)) {
+        return WS_STEAL_ABORT;
+    }
+    return WS_STEAL_SUCCESS;
+}
+
+// =================== THREAD POOL ===================
+
+const char* thread_pool_mode_name(thread_pool_mode_t mode) {
+    return mode == THREAD_POOL_WORK_STEALING ? "work-stealing" : "shared-queue";
+}
+
 // Initialize the thread pool
-thread_pool_t* thread_pool_init() {
+thread_pool_t* thread_pool_init(thread_pool_mode_t mode, int num_threads) {
     // Allocate memory for the pool
     thread_pool_t* tp = (thread_pool_t*)malloc(sizeof(thread_pool_t));
     if (tp == NULL) {
@@ -48,131 +240,357 @@ thread_pool_t* thread_pool_init() {
     }
     
     // Initialize pool properties
+    tp->mode = mode;
+    tp->num_threads = num_threads > 0 ? num_threads : THREAD_POOL_SIZE;
     tp->queue_size = 0;
     tp->head = 0;
     tp->tail = 0;
-    tp->shutdown = false;
+    atomic_init(&tp->shutdown, false);
+    tp->workers = NULL;
+    mpsc_queue_init(&tp->inbox);
+    atomic_flag_clear(&tp->inbox_draining);
+    atomic_init(&tp->pending, 0);
+    atomic_init(&tp->sleepers, 0);
+    
+    tp->worker_threads = (port_thread_t*)malloc(sizeof(port_thread_t) * (size_t)tp->num_threads);
+    if (tp->worker_threads == NULL) {
+        fprintf(stderr, "Error: Failed to allocate worker thread handles\n");
+        free(tp);
+        return NULL;
+    }
+    
+    // Per-worker deques for the work-stealing mode
+    if (mode == THREAD_POOL_WORK_STEALING) {
+        tp->workers = (ws_worker_t*)malloc(sizeof(ws_worker_t) * (size_t)tp->num_threads);
+        if (tp->workers == NULL) {
+            fprintf(stderr, "Error: Failed to allocate work-stealing workers\n");
+            free(tp->worker_threads);
+            free(tp);
+            return NULL;
+        }
+        for (int i = 0; i < tp->num_threads; i++) {
+            ws_deque_init(&tp->workers[i].deque);
+            tp->workers[i].pool = tp;
+            tp->workers[i].rng = 2463534242u + (unsigned int)i * 7919u;
+        }
+    }
     
     // Initialize synchronization objects
-    InitializeCriticalSection(&tp->queue_lock);
-    InitializeConditionVariable(&tp->queue_not_empty);
-    InitializeConditionVariable(&tp->queue_not_full);
+    profiled_mutex_init(&tp->queue_lock, "queue_lock");
+    port_cond_init(&tp->queue_not_empty);
+    port_cond_init(&tp->queue_not_full);
     
-    printf("Thread pool initialized\n");
+    printf("Thread pool initialized (%s)\n", thread_pool_mode_name(mode));
     
     return tp;
 }
 
-// Function declaration for worker thread
-DWORD WINAPI worker_thread(LPVOID arg);
+// Free everything owned by the pool once no worker is running
+static void thread_pool_release(thread_pool_t* tp) {
+    // Workers run every counted job before exiting, so this only finds jobs of a pool
+    // that never started; their arguments belong to the submitter
+    mpsc_node_t* node;
+    while ((node = mpsc_queue_pop(&tp->inbox)) != NULL) {
+        free(MPSC_CONTAINER_OF(node, inbox_job_t, node));
+    }
+    
+    if (tp->workers != NULL) {
+        for (int i = 0; i < tp->num_threads; i++) {
+            ws_deque_destroy(&tp->workers[i].deque);
+        }
+        free(tp->workers);
+    }
+    
+    // Clean up synchronization objects
+    port_cond_destroy(&tp->queue_not_full);
+    port_cond_destroy(&tp->queue_not_empty);
+    profiled_mutex_destroy(&tp->queue_lock);
+    
+    free(tp->worker_threads);
+    free(tp);
+}
+
+// Function declarations for worker threads
+static int worker_thread(void* arg);
+static int ws_worker_thread(void* arg);
 
 // Start the thread pool
 bool thread_pool_start(thread_pool_t* tp) {
     // Create worker threads
-    for (int i = 0; i < THREAD_POOL_SIZE; i++) {
-        tp->worker_threads[i] = CreateThread(
-            NULL,            // Default security attributes
-            0,               // Default stack size
-            worker_thread,   // Thread function
-            tp,              // Argument to thread function (the pool)
-            0,               // Default creation flags
-            NULL             // Don't store thread ID
-        );
+    for (int i = 0; i < tp->num_threads; i++) {
+        bool created = tp->mode == THREAD_POOL_WORK_STEALING
+            ? port_thread_create(&tp->worker_threads[i], ws_worker_thread, &tp->workers[i])
+            : port_thread_create(&tp->worker_threads[i], worker_thread, tp);
         
-        if (tp->worker_threads[i] == NULL) {
+        if (!created) {
             fprintf(stderr, "Error creating worker thread %d\n", i);
             
             // Shutdown the pool
+            profiled_mutex_lock(&tp->queue_lock);
             tp->shutdown = true;
-            WakeAllConditionVariable(&tp->queue_not_empty);
+            port_cond_broadcast(&tp->queue_not_empty);
+            profiled_mutex_unlock(&tp->queue_lock);
             
             // Wait for created threads to exit
             for (int j = 0; j < i; j++) {
-                WaitForSingleObject(tp->worker_threads[j], INFINITE);
-                CloseHandle(tp->worker_threads[j]);
+                port_thread_join(tp->worker_threads[j], NULL);
             }
             
-            // Clean up synchronization objects
-            DeleteCriticalSection(&tp->queue_lock);
+            // The pool is unusable, free it
+            thread_pool_release(tp);
             
             return false;
         }
     }
     
-    printf("Thread pool started with %d worker threads\n", THREAD_POOL_SIZE);
+    printf("Thread pool started with %d worker threads\n", tp->num_threads);
     
     return true;
 }
 
+// Wake one parked worker if any are sleeping (work-stealing mode)
+static void ws_wake_one(thread_pool_t* tp) {
+    if (atomic_load(&tp->sleepers) > 0) {
+        profiled_mutex_lock(&tp->queue_lock);
+        port_cond_signal(&tp->queue_not_empty);
+        profiled_mutex_unlock(&tp->queue_lock);
+    }
+}
+
 // Add work to the thread pool
 bool thread_pool_add_work(thread_pool_t* tp, void (*function)(void*), void* argument) {
+    // A job spawning more work in work-stealing mode pushes to its own deque without locking
+    if (tp->mode == THREAD_POOL_WORK_STEALING && tls_worker != NULL && tls_worker->pool == tp) {
+        work_item_t item = { function, argument, 0, 0 };
+        atomic_fetch_add(&tp->pending, 1);
+        ws_deque_push(&tls_worker->deque, item);
+        ws_wake_one(tp);
+        return true;
+    }
+    
+    // Other submitters go through the inbox, which never blocks
+    if (tp->mode == THREAD_POOL_WORK_STEALING) {
+        // Count the job before checking for shutdown: a worker only exits once it sees
+        // shutdown with nothing pending, so either it waits for this job or we back out
+        atomic_fetch_add(&tp->pending, 1);
+        if (atomic_load(&tp->shutdown)) {
+            atomic_fetch_sub(&tp->pending, 1);
+            return false;
+        }
+        inbox_job_t* job = (inbox_job_t*)malloc(sizeof(inbox_job_t));
+        if (job == NULL) {
+            atomic_fetch_sub(&tp->pending, 1);
+            return false;
+        }
+        job->item.function = function;
+        job->item.argument = argument;
+        job->item.queued_at = trace_enabled() ? port_time_ns() : 0;
+        job->item.trace_id = job->item.queued_at != 0 ? trace_next_id() : 0;
+        mpsc_queue_push(&tp->inbox, &job->node);
+        ws_wake_one(tp);
+        return true;
+    }
+    
     // Enter critical section
-    EnterCriticalSection(&tp->queue_lock);
+    profiled_mutex_lock(&tp->queue_lock);
     
     // Wait while the queue is full
     while (tp->queue_size == MAX_QUEUE_SIZE && !tp->shutdown) {
-        printf("Queue full, waiting...\n");
-        SleepConditionVariableCS(&tp->queue_not_full, &tp->queue_lock, INFINITE);
+        // A worker of this pool blocking here could stall every worker, so it runs the job itself
+        if (tls_pool == tp) {
+            profiled_mutex_unlock(&tp->queue_lock);
+            function(argument);
+            return true;
+        }
+        LOG_WARN("Queue full, waiting...");
+        profiled_cond_wait(&tp->queue_not_full, &tp->queue_lock);
     }
     
     // Check if pool is shutting down
     if (tp->shutdown) {
-        LeaveCriticalSection(&tp->queue_lock);
+        profiled_mutex_unlock(&tp->queue_lock);
         return false;
     }
     
     // Add work to the queue
     tp->queue[tp->tail].function = function;
     tp->queue[tp->tail].argument = argument;
+    tp->queue[tp->tail].queued_at = trace_enabled() ? port_time_ns() : 0;
+    tp->queue[tp->tail].trace_id = tp->queue[tp->tail].queued_at != 0 ? trace_next_id() : 0;
     tp->tail = (tp->tail + 1) % MAX_QUEUE_SIZE;
     tp->queue_size++;
+    trace_counter("queue_size", tp->queue_size);
     
     // Signal that the queue is not empty
-    WakeConditionVariable(&tp->queue_not_empty);
+    port_cond_signal(&tp->queue_not_empty);
     
     // Leave critical section
-    LeaveCriticalSection(&tp->queue_lock);
+    profiled_mutex_unlock(&tp->queue_lock);
     
     return true;
 }
 
-// Worker thread function
-DWORD WINAPI worker_thread(LPVOID arg) {
+// Run a job, tracing the time it sat in the queue apart from the time it ran
+static void run_work(const work_item_t* work) {
+    if (work->queued_at != 0) {
+        trace_async("queue wait", "thread_pool", work->trace_id, work->queued_at, port_time_ns());
+    }
+    uint64_t start = trace_span_begin();
+    work->function(work->argument);
+    trace_span_end("job", "thread_pool", start);
+}
+
+// Worker thread function (shared-queue mode)
+static int worker_thread(void* arg) {
     thread_pool_t* tp = (thread_pool_t*)arg;
     work_item_t work;
     
+    tls_pool = tp;
+    trace_thread_name("pool worker");
+    
     while (true) {
         // Enter critical section
-        EnterCriticalSection(&tp->queue_lock);
+        profiled_mutex_lock(&tp->queue_lock);
         
         // Wait while the queue is empty
         while (tp->queue_size == 0 && !tp->shutdown) {
-            SleepConditionVariableCS(&tp->queue_not_empty, &tp->queue_lock, INFINITE);
+            profiled_cond_wait(&tp->queue_not_empty, &tp->queue_lock);
         }
         
         // Check if we should exit
         if (tp->shutdown && tp->queue_size == 0) {
-            LeaveCriticalSection(&tp->queue_lock);
+            profiled_mutex_unlock(&tp->queue_lock);
             break;
         }
         
         // Get work from the queue
-        work.function = tp->queue[tp->head].function;
-        work.argument = tp->queue[tp->head].argument;
+        work = tp->queue[tp->head];
         tp->head = (tp->head + 1) % MAX_QUEUE_SIZE;
         tp->queue_size--;
+        trace_counter("queue_size", tp->queue_size);
         
         // Signal that the queue is not full
-        WakeConditionVariable(&tp->queue_not_full);
+        port_cond_signal(&tp->queue_not_full);
         
         // Leave critical section
-        LeaveCriticalSection(&tp->queue_lock);
+        profiled_mutex_unlock(&tp->queue_lock);
         
         // Execute the work
-        work.function(work.argument);
+        run_work(&work);
+    }
+    
+    LOG_INFO("Worker thread exiting");
+    return 0;
+}
+
+// Move a batch of externally submitted jobs into the worker's deque, returning one of them
+static bool ws_take_injected(thread_pool_t* tp, ws_worker_t* self, work_item_t* work) {
+    // The inbox has a single consumer; a worker that loses the race looks elsewhere
+    if (atomic_flag_test_and_set_explicit(&tp->inbox_draining, memory_order_acquire)) {
+        return false;
+    }
+    
+    // Take a fair share so the other workers find something in the inbox too
+    long batch = atomic_load_explicit(&tp->pending, memory_order_relaxed) / tp->num_threads;
+    if (batch < 1) {
+        batch = 1;
+    } else if (batch > WS_INJECT_BATCH) {
+        batch = WS_INJECT_BATCH;
+    }
+    
+    long taken = 0;
+    mpsc_node_t* node;
+    while (taken < batch && (node = mpsc_queue_pop(&tp->inbox)) != NULL) {
+        inbox_job_t* job = MPSC_CONTAINER_OF(node, inbox_job_t, node);
+        if (taken == 0) {
+            *work = job->item;
+        } else {
+            ws_deque_push(&self->deque, job->item);
+        }
+        free(job);
+        taken++;
+    }
+    
+    atomic_flag_clear_explicit(&tp->inbox_draining, memory_order_release);
+    return taken > 0;
+}
+
+// Try to steal one job, visiting the other workers starting from a random victim
+static bool ws_steal(thread_pool_t* tp, ws_worker_t* self, work_item_t* work) {
+    if (tp->num_threads < 2) {
+        return false;
+    }
+    
+    // xorshift32
+    self->rng ^= self->rng << 13;
+    self->rng ^= self->rng >> 17;
+    self->rng ^= self->rng << 5;
+    int start = (int)(self->rng % (unsigned int)tp->num_threads);
+    
+    for (int i = 0; i < tp->num_threads; i++) {
+        ws_worker_t* victim = &tp->workers[(start + i) % tp->num_threads];
+        if (victim == self) {
+            continue;
+        }
+        
+        ws_steal_result_t result;
+        do {
+            result = ws_deque_steal(&victim->deque, work);
+        } while (result == WS_STEAL_ABORT);
+        
+        if (result == WS_STEAL_SUCCESS) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Look for work: own deque first, then the inbox, then other workers
+static bool ws_find_work(thread_pool_t* tp, ws_worker_t* self, work_item_t* work) {
+    return ws_deque_pop(&self->deque, work)
+        || ws_take_injected(tp, self, work)
+        || ws_steal(tp, self, work);
+}
+
+// Worker thread function (work-stealing mode)
+static int ws_worker_thread(void* arg) {
+    ws_worker_t* self = (ws_worker_t*)arg;
+    thread_pool_t* tp = self->pool;
+    work_item_t work;
+    
+    tls_pool = tp;
+    tls_worker = self;
+    
+    char name[TRACE_THREAD_NAME_SIZE];
+    snprintf(name, sizeof(name), "pool worker %d", (int)(self - tp->workers));
+    trace_thread_name(name);
+    
+    while (true) {
+        if (ws_find_work(tp, self, &work)) {
+            atomic_fetch_sub(&tp->pending, 1);
+            
+            // Execute the work
+            run_work(&work);
+            continue;
+        }
+        
+        // Nothing to run anywhere: park until work is published or the pool shuts down
+        profiled_mutex_lock(&tp->queue_lock);
+        atomic_fetch_add(&tp->sleepers, 1);
+        while (atomic_load(&tp->pending) == 0 && !tp->shutdown) {
+            profiled_cond_wait(&tp->queue_not_empty, &tp->queue_lock);
+        }
+        atomic_fetch_sub(&tp->sleepers, 1);
+        bool exit_now = tp->shutdown && atomic_load(&tp->pending) == 0;
+        profiled_mutex_unlock(&tp->queue_lock);
+        
+        if (exit_now) {
+            break;
+        }
     }
     
-    printf("Worker thread exiting\n");
+    tls_worker = NULL;
+    LOG_INFO("Worker thread exiting");
     return 0;
 }
 
@@ -183,28 +601,25 @@ void thread_pool_shutdown(thread_pool_t* tp) {
     }
     
     // Enter critical section
-    EnterCriticalSection(&tp->queue_lock);
+    profiled_mutex_lock(&tp->queue_lock);
     
     // Set shutdown flag
     tp->shutdown = true;
     
     // Wake up all worker threads
-    WakeAllConditionVariable(&tp->queue_not_empty);
+    port_cond_broadcast(&tp->queue_not_empty);
     
     // Leave critical section
-    LeaveCriticalSection(&tp->queue_lock);
+    profiled_mutex_unlock(&tp->queue_lock);
     
-    // Wait for all worker threads to finish
-    for (int i = 0; i < THREAD_POOL_SIZE; i++) {
-        WaitForSingleObject(tp->worker_threads[i], INFINITE);
-        CloseHandle(tp->worker_threads[i]);
+    // Wait for all worker threads to finish, then let their log lines out
+    for (int i = 0; i < tp->num_threads; i++) {
+        port_thread_join(tp->worker_threads[i], NULL);
     }
+    log_flush();
     
-    // Clean up synchronization objects
-    DeleteCriticalSection(&tp->queue_lock);
-    
-    // Free the pool memory
-    free(tp);
+    // Clean up and free the pool memory
+    thread_pool_release(tp);
     
     printf("Thread pool shut down\n");
 }
@@ -219,32 +634,32 @@ typedef struct {
 void example_job(void* arg) {
     job_data_t* data = (job_data_t*)arg;
     
-    printf("Job %d starting with value %d\n", data->id, data->value);
+    LOG_INFO("Job %d starting with value %d", data->id, data->value);
     
     // Simulate work
-    Sleep(1000 + (data->id % 3) * 500);
+    port_sleep_ms(1000 + (data->id % 3) * 500);
     
-    printf("Job %d completed\n", data->id);
+    LOG_INFO("Job %d completed", data->id);
     
     // Free job data
     free(data);
 }
 
 // Demo function for thread pool
-void thread_pool_demo() {
-    printf("\n=== Thread Pool Demo ===\n");
+void thread_pool_demo(thread_pool_mode_t mode) {
+    printf("\n=== Thread Pool Demo (%s) ===\n", thread_pool_mode_name(mode));
     
     // Initialize the thread pool
-    g_pool = thread_pool_init();
+    g_pool = thread_pool_init(mode, THREAD_POOL_SIZE);
     if (g_pool == NULL) {
         fprintf(stderr, "Failed to initialize thread pool\n");
         return;
     }
     
-    // Start the thread pool
+    // Start the thread pool (a pool that fails to start frees itself)
     if (!thread_pool_start(g_pool)) {
         fprintf(stderr, "Failed to start thread pool\n");
-        free(g_pool);
+        g_pool = NULL;
         return;
     }
     
@@ -272,7 +687,7 @@ void thread_pool_demo() {
     
     // Wait for some time to allow jobs to complete
     printf("Waiting for jobs to complete...\n");
-    Sleep(5000);
+    port_sleep_ms(5000);
     
     // Shutdown the thread pool
     printf("Shutting down thread pool...\n");
@@ -284,9 +699,12 @@ void thread_pool_demo() {
 int thread_pool_main() {
     printf("=== Thread Pool Demo ===\n");
     
-    // Run the thread pool demo
-    thread_pool_demo();
+    // Run the thread pool demo with the single shared queue
+    thread_pool_demo(THREAD_POOL_SHARED_QUEUE);
+    
+    // Run the same jobs with per-worker deques and work stealing
+    thread_pool_demo(THREAD_POOL_WORK_STEALING);
     
     printf("Thread pool demo completed\n");
     return 0;
-} 
\ No newline at end of file
+}
@@ -0,0 +1,37 @@
+/**
+ * @file thread_pool.h
+ * @brief Public interface of the thread pool used by the demo and the benchmarks
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stdbool.h>
+
+// Number of worker threads in the pool when the caller does not choose
+#define THREAD_POOL_SIZE 4
+
+// How the pool distributes work between its workers
+typedef enum {
+    THREAD_POOL_SHARED_QUEUE,   // One locked ring buffer shared by every worker
+    THREAD_POOL_WORK_STEALING   // Per-worker deques, idle workers steal from random victims
+} thread_pool_mode_t;
+
+typedef struct thread_pool thread_pool_t;
+
+// Create a pool with the given mode and number of workers (<= 0 selects THREAD_POOL_SIZE)
+thread_pool_t* thread_pool_init(thread_pool_mode_t mode, int num_threads);
+
+// Start the worker threads
+bool thread_pool_start(thread_pool_t* tp);
+
+// Queue a job; may be called from outside the pool or from inside a running job
+bool thread_pool_add_work(thread_pool_t* tp, void (*function)(void*), void* argument);
+
+// Run every queued job, stop the workers and free the pool
+void thread_pool_shutdown(thread_pool_t* tp);
+
+// Human-readable name of a pool mode
+const char* thread_pool_mode_name(thread_pool_mode_t mode);
+
+#endif // THREAD_POOL_H
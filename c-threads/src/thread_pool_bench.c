@@ -0,0 +1,193 @@
+/**
+ * @file thread_pool_bench.c
+ * @brief Jobs/sec comparison of the shared-queue and work-stealing thread pools
+ *
+ * Two workloads are measured for each pool mode:
+ * - external: the main thread submits every job
+ * - nested:   a few root jobs submit the rest from inside the pool
+ * Each job is a short busy loop so the queueing cost dominates.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "async_log.h"
+#include "thread_port.h"
+#include "thread_pool.h"
+
+// Default benchmark parameters
+#define BENCH_DEFAULT_JOBS 200000
+#define BENCH_DEFAULT_WORK 50
+#define BENCH_DEFAULT_REPEAT 3
+#define BENCH_MAX_REPEAT 32
+
+// Benchmark parameters
+typedef struct {
+    long jobs;          // Jobs per run
+    int work;           // Busy-loop iterations per job
+    int threads;        // Worker threads per pool
+    int repeat;         // Runs per configuration (median is reported)
+} pool_bench_config_t;
+
+// Workload shapes
+typedef enum {
+    BENCH_EXTERNAL,     // Main thread submits every job
+    BENCH_NESTED        // Root jobs submit the children from worker threads
+} pool_bench_workload_t;
+
+// State shared by the jobs of one run
+static atomic_long bench_completed;
+static thread_pool_t* bench_pool = NULL;
+static int bench_work = 0;
+static long bench_children_per_root = 0;
+
+// Tiny job: a short dependent computation, then count completion
+static void bench_tiny_job(void* arg) {
+    (void)arg;
+    volatile unsigned int x = 1;
+    for (int i = 0; i < bench_work; i++) {
+        x = x * 1664525u + 1013904223u;
+    }
+    atomic_fetch_add_explicit(&bench_completed, 1, memory_order_relaxed);
+}
+
+// Root job of the nested workload: spawns its children from inside the pool
+static void bench_root_job(void* arg) {
+    (void)arg;
+    for (long i = 0; i < bench_children_per_root; i++) {
+        thread_pool_add_work(bench_pool, bench_tiny_job, NULL);
+    }
+    atomic_fetch_add_explicit(&bench_completed, 1, memory_order_relaxed);
+}
+
+// Root jobs of the nested workload
+static long bench_roots(const pool_bench_config_t* config) {
+    return (long)config->threads * 4;
+}
+
+// Jobs a run actually completes: the nested workload adds its root jobs and
+// drops the remainder that does not divide evenly among them
+static long bench_job_count(pool_bench_workload_t workload, const pool_bench_config_t* config) {
+    if (workload == BENCH_EXTERNAL) {
+        return config->jobs;
+    }
+    long roots = bench_roots(config);
+    return roots + roots * (config->jobs / roots);
+}
+
+// Run one workload once and return the elapsed time in nanoseconds
+static uint64_t bench_run_once(thread_pool_mode_t mode, pool_bench_workload_t workload,
+                               const pool_bench_config_t* config) {
+    bench_pool = thread_pool_init(mode, config->threads);
+    if (bench_pool == NULL || !thread_pool_start(bench_pool)) {
+        fprintf(stderr, "Failed to start %s pool\n", thread_pool_mode_name(mode));
+        exit(EXIT_FAILURE);
+    }
+    
+    atomic_store(&bench_completed, 0);
+    bench_work = config->work;
+    
+    long expected = bench_job_count(workload, config);
+    uint64_t start = port_time_ns();
+    
+    if (workload == BENCH_EXTERNAL) {
+        for (long i = 0; i < config->jobs; i++) {
+            thread_pool_add_work(bench_pool, bench_tiny_job, NULL);
+        }
+    } else {
+        long roots = bench_roots(config);
+        bench_children_per_root = config->jobs / roots;
+        for (long i = 0; i < roots; i++) {
+            thread_pool_add_work(bench_pool, bench_root_job, NULL);
+        }
+    }
+    
+    // Wait for every job to finish before stopping the clock
+    while (atomic_load_explicit(&bench_completed, memory_order_acquire) < expected) {
+        port_thread_yield();
+    }
+    
+    uint64_t elapsed = port_time_ns() - start;
+    thread_pool_shutdown(bench_pool);
+    bench_pool = NULL;
+    return elapsed;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Median elapsed time over the configured number of repetitions
+static uint64_t bench_median(thread_pool_mode_t mode, pool_bench_workload_t workload,
+                             const pool_bench_config_t* config) {
+    uint64_t samples[BENCH_MAX_REPEAT];
+    for (int r = 0; r < config->repeat; r++) {
+        samples[r] = bench_run_once(mode, workload, config);
+    }
+    qsort(samples, (size_t)config->repeat, sizeof(uint64_t), compare_u64);
+    return samples[config->repeat / 2];
+}
+
+static void print_usage(void) {
+    printf("Usage: CThreadsBench pool [--jobs=N] [--work=N] [--threads=N] [--repeat=N]\n");
+}
+
+// Entry point of the pool benchmark
+int thread_pool_bench_main(int argc, char* argv[]) {
+    pool_bench_config_t config = {
+        BENCH_DEFAULT_JOBS, BENCH_DEFAULT_WORK, port_cpu_count(), BENCH_DEFAULT_REPEAT
+    };
+    
+    for (int i = 0; i < argc; i++) {
+        if (strncmp(argv[i], "--jobs=", 7) == 0) {
+            config.jobs = atol(argv[i] + 7);
+        } else if (strncmp(argv[i], "--work=", 7) == 0) {
+            config.work = atoi(argv[i] + 7);
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            config.threads = atoi(argv[i] + 10);
+        } else if (strncmp(argv[i], "--repeat=", 9) == 0) {
+            config.repeat = atoi(argv[i] + 9);
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    
+    if (config.jobs <= 0 || config.work < 0 || config.threads <= 0 ||
+        config.repeat <= 0 || config.repeat > BENCH_MAX_REPEAT) {
+        print_usage();
+        return 1;
+    }
+    
+    printf("=== Thread Pool Benchmark ===\n");
+    printf("Jobs: %ld, work per job: %d, workers: %d, repetitions: %d\n",
+           config.jobs, config.work, config.threads, config.repeat);
+    
+    const char* workload_names[] = { "external", "nested" };
+    uint64_t results[2][2];
+    
+    // The pools' queue-full warnings and worker exit messages would bury the table
+    log_set_output(NULL);
+    for (int w = 0; w < 2; w++) {
+        results[w][0] = bench_median(THREAD_POOL_SHARED_QUEUE, (pool_bench_workload_t)w, &config);
+        results[w][1] = bench_median(THREAD_POOL_WORK_STEALING, (pool_bench_workload_t)w, &config);
+    }
+    log_set_output(stdout);
+    
+    printf("\n%-10s %-15s %12s %15s\n", "Workload", "Mode", "Median ms", "Jobs/sec");
+    for (int w = 0; w < 2; w++) {
+        for (int m = 0; m < 2; m++) {
+            double seconds = (double)results[w][m] / 1e9;
+            printf("%-10s %-15s %12.2f %15.0f\n", workload_names[w],
+                   thread_pool_mode_name((thread_pool_mode_t)m),
+                   seconds * 1e3, (double)bench_job_count((pool_bench_workload_t)w, &config) / seconds);
+        }
+        printf("%-10s work-stealing speedup: %.2fx\n", workload_names[w],
+               (double)results[w][0] / (double)results[w][1]);
+    }
+    
+    return 0;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file thread_port.h
+ * @brief Thin portability layer over Win32 threads and POSIX threads
+ *
+ * The backend is chosen at configure time with the CTHREADS_BACKEND CMake
+ * option, which defines one of:
+ * - CTHREADS_BACKEND_WIN32: Win32 threads, critical sections and events;
+ *   thread-local slots are fiber-local (FLS), which can run a destructor
+ * - CTHREADS_BACKEND_POSIX: pthreads for everything
+ * - CTHREADS_BACKEND_FUTEX: pthreads for threads and TLS, raw Linux futexes
+ *   for mutexes, condition variables and events (implies CTHREADS_BACKEND_POSIX)
+ * When none is defined the platform default is used. Atomics are not wrapped
+ * here: code that needs them uses C11 <stdatomic.h> directly.
+ */
+
+#ifndef THREAD_PORT_H
+#define THREAD_PORT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Pick a default backend when the build system did not choose one
+#if defined(CTHREADS_BACKEND_FUTEX) && !defined(CTHREADS_BACKEND_POSIX)
+#define CTHREADS_BACKEND_POSIX
+#endif
+#if !defined(CTHREADS_BACKEND_WIN32) && !defined(CTHREADS_BACKEND_POSIX)
+#if defined(_WIN32)
+#define CTHREADS_BACKEND_WIN32
+#else
+#define CTHREADS_BACKEND_POSIX
+#endif
+#endif
+
+#if defined(CTHREADS_BACKEND_WIN32)
+#include <Windows.h>
+#else
+#include <pthread.h>
+#endif
+#if defined(CTHREADS_BACKEND_FUTEX)
+#include <stdatomic.h>
+#endif
+
+// Thread-local storage class specifier
+#if defined(_MSC_VER) && !defined(__clang__)
+#define PORT_THREAD_LOCAL __declspec(thread)
+#else
+#define PORT_THREAD_LOCAL _Thread_local
+#endif
+
+// Size used to keep independently written fields on separate cache lines
+#define PORT_CACHE_LINE 64
+
+// Thread entry point: the return value becomes the thread's exit code
+typedef int (*port_thread_fn)(void* arg);
+
+#if defined(CTHREADS_BACKEND_WIN32)
+typedef HANDLE port_thread_t;
+typedef CRITICAL_SECTION port_mutex_t;
+typedef CONDITION_VARIABLE port_cond_t;
+typedef HANDLE port_event_t;
+typedef DWORD port_tls_t;
+#else
+typedef pthread_t port_thread_t;
+typedef pthread_key_t port_tls_t;
+#if defined(CTHREADS_BACKEND_FUTEX)
+// 0 = unlocked, 1 = locked, 2 = locked with waiters
+typedef struct {
+    atomic_int state;
+} port_mutex_t;
+// Waiters sleep until the sequence number changes
+typedef struct {
+    atomic_uint seq;
+} port_cond_t;
+typedef struct {
+    atomic_int signaled;
+    bool manual_reset;
+} port_event_t;
+#else
+typedef pthread_mutex_t port_mutex_t;
+typedef pthread_cond_t port_cond_t;
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool signaled;
+    bool manual_reset;
+} port_event_t;
+#endif
+#endif
+
+// Name of the backend selected at configure time
+const char* port_backend_name(void);
+
+// Threads
+bool port_thread_create(port_thread_t* thread, port_thread_fn fn, void* arg);
+bool port_thread_join(port_thread_t thread, int* exit_code);
+bool port_thread_detach(port_thread_t thread);
+bool port_thread_terminate(port_thread_t thread);
+unsigned long port_thread_get_id(port_thread_t thread);
+unsigned long port_thread_current_id(void);
+void port_thread_yield(void);
+
+// Mutexes
+void port_mutex_init(port_mutex_t* mutex);
+void port_mutex_destroy(port_mutex_t* mutex);
+void port_mutex_lock(port_mutex_t* mutex);
+bool port_mutex_trylock(port_mutex_t* mutex);  // false when already locked
+void port_mutex_unlock(port_mutex_t* mutex);
+
+// Condition variables
+void port_cond_init(port_cond_t* cond);
+void port_cond_destroy(port_cond_t* cond);
+void port_cond_wait(port_cond_t* cond, port_mutex_t* mutex);
+void port_cond_signal(port_cond_t* cond);
+void port_cond_broadcast(port_cond_t* cond);
+
+// Events: a manual-reset event stays signaled until reset, an auto-reset
+// event releases exactly one waiter per port_event_set
+bool port_event_init(port_event_t* event, bool manual_reset);
+void port_event_destroy(port_event_t* event);
+void port_event_set(port_event_t* event);
+void port_event_reset(port_event_t* event);
+bool port_event_wait(port_event_t* event, unsigned int timeout_ms);  // false on timeout
+
+// Thread-local storage slots. A slot allocated with a destructor calls it with
+// the thread's value when a thread that set a non-NULL value exits.
+typedef void (*port_tls_destructor)(void* value);
+bool port_tls_alloc(port_tls_t* key);
+bool port_tls_alloc_destructor(port_tls_t* key, port_tls_destructor destructor);
+void port_tls_free(port_tls_t key);
+bool port_tls_set(port_tls_t key, void* value);
+void* port_tls_get(port_tls_t key);
+
+// Time and system information
+#define PORT_INFINITE 0xFFFFFFFFu
+void port_sleep_ms(unsigned int ms);
+uint64_t port_time_ns(void);
+int port_cpu_count(void);
+int port_last_error(void);
+
+#endif // THREAD_PORT_H
@@ -0,0 +1,148 @@
+/**
+ * @file thread_port_futex.c
+ * @brief Linux futex implementation of the portability layer's blocking primitives
+ *
+ * Mutexes follow the three-state design from Ulrich Drepper's "Futexes Are
+ * Tricky": the uncontended lock and unlock are a single atomic operation and
+ * only contended paths enter the kernel. Condition variables are a sequence
+ * number that waiters sleep on. Events keep their signaled flag in the futex
+ * word itself.
+ */
+
+#define _GNU_SOURCE
+
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include "thread_port.h"
+
+// Sleep while *addr == expected; timeout is relative, NULL for no timeout
+static int futex_wait(void* addr, int expected, const struct timespec* timeout) {
+    return (int)syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, timeout, NULL, 0);
+}
+
+// Wake up to count threads sleeping on addr
+static void futex_wake(void* addr, int count) {
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+void port_mutex_init(port_mutex_t* mutex) {
+    atomic_init(&mutex->state, 0);
+}
+
+void port_mutex_destroy(port_mutex_t* mutex) {
+    (void)mutex;
+}
+
+// Acquire assuming there may be waiters, so the matching unlock wakes one
+static void port_mutex_lock_contended(port_mutex_t* mutex, int state) {
+    if (state != 2) {
+        state = atomic_exchange_explicit(&mutex->state, 2, memory_order_acquire);
+    }
+    while (state != 0) {
+        futex_wait(&mutex->state, 2, NULL);
+        state = atomic_exchange_explicit(&mutex->state, 2, memory_order_acquire);
+    }
+}
+
+void port_mutex_lock(port_mutex_t* mutex) {
+    int state = 0;
+    if (!atomic_compare_exchange_strong_explicit(
+            &mutex->state, &state, 1, memory_order_acquire, memory_order_relaxed)) {
+        port_mutex_lock_contended(mutex, state);
+    }
+}
+
+bool port_mutex_trylock(port_mutex_t* mutex) {
+    int state = 0;
+    return atomic_compare_exchange_strong_explicit(
+        &mutex->state, &state, 1, memory_order_acquire, memory_order_relaxed);
+}
+
+void port_mutex_unlock(port_mutex_t* mutex) {
+    // 1 -> 0 needs no syscall; 2 means someone may be sleeping
+    if (atomic_fetch_sub_explicit(&mutex->state, 1, memory_order_release) != 1) {
+        atomic_store_explicit(&mutex->state, 0, memory_order_release);
+        futex_wake(&mutex->state, 1);
+    }
+}
+
+void port_cond_init(port_cond_t* cond) {
+    atomic_init(&cond->seq, 0);
+}
+
+void port_cond_destroy(port_cond_t* cond) {
+    (void)cond;
+}
+
+void port_cond_wait(port_cond_t* cond, port_mutex_t* mutex) {
+    // Sample the sequence before unlocking so a signal in between is not lost
+    unsigned int seq = atomic_load_explicit(&cond->seq, memory_order_relaxed);
+    port_mutex_unlock(mutex);
+    futex_wait(&cond->seq, (int)seq, NULL);
+    
+    // Other waiters may have been woken too, so reacquire as contended
+    port_mutex_lock_contended(mutex, 1);
+}
+
+void port_cond_signal(port_cond_t* cond) {
+    atomic_fetch_add_explicit(&cond->seq, 1, memory_order_relaxed);
+    futex_wake(&cond->seq, 1);
+}
+
+void port_cond_broadcast(port_cond_t* cond) {
+    atomic_fetch_add_explicit(&cond->seq, 1, memory_order_relaxed);
+    futex_wake(&cond->seq, INT_MAX);
+}
+
+bool port_event_init(port_event_t* event, bool manual_reset) {
+    atomic_init(&event->signaled, 0);
+    event->manual_reset = manual_reset;
+    return true;
+}
+
+void port_event_destroy(port_event_t* event) {
+    (void)event;
+}
+
+void port_event_set(port_event_t* event) {
+    atomic_store_explicit(&event->signaled, 1, memory_order_release);
+    futex_wake(&event->signaled, event->manual_reset ? INT_MAX : 1);
+}
+
+void port_event_reset(port_event_t* event) {
+    atomic_store_explicit(&event->signaled, 0, memory_order_relaxed);
+}
+
+// Consume the signal of an auto-reset event, or observe a manual-reset one
+static bool port_event_try(port_event_t* event) {
+    if (event->manual_reset) {
+        return atomic_load_explicit(&event->signaled, memory_order_acquire) == 1;
+    }
+    int expected = 1;
+    return atomic_compare_exchange_strong_explicit(
+        &event->signaled, &expected, 0, memory_order_acquire, memory_order_relaxed);
+}
+
+bool port_event_wait(port_event_t* event, unsigned int timeout_ms) {
+    uint64_t deadline = port_time_ns() + (uint64_t)timeout_ms * 1000000ULL;
+    
+    while (!port_event_try(event)) {
+        if (timeout_ms == PORT_INFINITE) {
+            futex_wait(&event->signaled, 0, NULL);
+            continue;
+        }
+        
+        uint64_t now = port_time_ns();
+        if (now >= deadline) {
+            return false;
+        }
+        struct timespec remaining;
+        remaining.tv_sec = (time_t)((deadline - now) / 1000000000ULL);
+        remaining.tv_nsec = (long)((deadline - now) % 1000000000ULL);
+        futex_wait(&event->signaled, 0, &remaining);
+    }
+    return true;
+}
@@ -0,0 +1,250 @@
+/**
+ * @file thread_port_posix.c
+ * @brief POSIX threads backend for the threading portability layer
+ *
+ * With the futex backend this file still provides threads, TLS and time;
+ * mutexes, condition variables and events come from thread_port_futex.c.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include "thread_port.h"
+
+const char* port_backend_name(void) {
+#if defined(CTHREADS_BACKEND_FUTEX)
+    return "futex";
+#else
+    return "pthread";
+#endif
+}
+
+// Start block handed to the pthread trampoline
+typedef struct {
+    port_thread_fn fn;
+    void* arg;
+} port_start_t;
+
+// Adapts the portable entry point to the pthread signature
+static void* port_thread_trampoline(void* param) {
+    port_start_t start = *(port_start_t*)param;
+    free(param);
+    return (void*)(intptr_t)start.fn(start.arg);
+}
+
+bool port_thread_create(port_thread_t* thread, port_thread_fn fn, void* arg) {
+    port_start_t* start = (port_start_t*)malloc(sizeof(port_start_t));
+    if (start == NULL) {
+        return false;
+    }
+    start->fn = fn;
+    start->arg = arg;
+    
+    int rc = pthread_create(thread, NULL, port_thread_trampoline, start);
+    if (rc != 0) {
+        free(start);
+        errno = rc;
+        return false;
+    }
+    return true;
+}
+
+bool port_thread_join(port_thread_t thread, int* exit_code) {
+    void* result = NULL;
+    int rc = pthread_join(thread, &result);
+    if (rc != 0) {
+        errno = rc;
+        return false;
+    }
+    if (exit_code != NULL) {
+        // A cancelled thread has no meaningful exit code
+        *exit_code = result == PTHREAD_CANCELED ? -1 : (int)(intptr_t)result;
+    }
+    return true;
+}
+
+bool port_thread_detach(port_thread_t thread) {
+    return pthread_detach(thread) == 0;
+}
+
+bool port_thread_terminate(port_thread_t thread) {
+    // Deferred cancellation: the thread stops at its next cancellation point
+    // (sleep, I/O), then is detached so its resources are reclaimed
+    if (pthread_cancel(thread) != 0) {
+        return false;
+    }
+    pthread_detach(thread);
+    return true;
+}
+
+unsigned long port_thread_get_id(port_thread_t thread) {
+    return (unsigned long)(uintptr_t)thread;
+}
+
+unsigned long port_thread_current_id(void) {
+    return port_thread_get_id(pthread_self());
+}
+
+void port_thread_yield(void) {
+    sched_yield();
+}
+
+#if !defined(CTHREADS_BACKEND_FUTEX)
+
+void port_mutex_init(port_mutex_t* mutex) {
+    pthread_mutex_init(mutex, NULL);
+}
+
+void port_mutex_destroy(port_mutex_t* mutex) {
+    pthread_mutex_destroy(mutex);
+}
+
+void port_mutex_lock(port_mutex_t* mutex) {
+    pthread_mutex_lock(mutex);
+}
+
+bool port_mutex_trylock(port_mutex_t* mutex) {
+    return pthread_mutex_trylock(mutex) == 0;
+}
+
+void port_mutex_unlock(port_mutex_t* mutex) {
+    pthread_mutex_unlock(mutex);
+}
+
+void port_cond_init(port_cond_t* cond) {
+    pthread_cond_init(cond, NULL);
+}
+
+void port_cond_destroy(port_cond_t* cond) {
+    pthread_cond_destroy(cond);
+}
+
+void port_cond_wait(port_cond_t* cond, port_mutex_t* mutex) {
+    pthread_cond_wait(cond, mutex);
+}
+
+void port_cond_signal(port_cond_t* cond) {
+    pthread_cond_signal(cond);
+}
+
+void port_cond_broadcast(port_cond_t* cond) {
+    pthread_cond_broadcast(cond);
+}
+
+bool port_event_init(port_event_t* event, bool manual_reset) {
+    event->signaled = false;
+    event->manual_reset = manual_reset;
+    if (pthread_mutex_init(&event->mutex, NULL) != 0) {
+        return false;
+    }
+    
+    // Time the waits against the monotonic clock so wall-clock jumps do not matter
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    int rc = pthread_cond_init(&event->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    if (rc != 0) {
+        pthread_mutex_destroy(&event->mutex);
+        return false;
+    }
+    return true;
+}
+
+void port_event_destroy(port_event_t* event) {
+    pthread_cond_destroy(&event->cond);
+    pthread_mutex_destroy(&event->mutex);
+}
+
+void port_event_set(port_event_t* event) {
+    pthread_mutex_lock(&event->mutex);
+    event->signaled = true;
+    if (event->manual_reset) {
+        pthread_cond_broadcast(&event->cond);
+    } else {
+        pthread_cond_signal(&event->cond);
+    }
+    pthread_mutex_unlock(&event->mutex);
+}
+
+void port_event_reset(port_event_t* event) {
+    pthread_mutex_lock(&event->mutex);
+    event->signaled = false;
+    pthread_mutex_unlock(&event->mutex);
+}
+
+bool port_event_wait(port_event_t* event, unsigned int timeout_ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    
+    pthread_mutex_lock(&event->mutex);
+    while (!event->signaled) {
+        int rc = timeout_ms == PORT_INFINITE
+            ? pthread_cond_wait(&event->cond, &event->mutex)
+            : pthread_cond_timedwait(&event->cond, &event->mutex, &deadline);
+        if (rc == ETIMEDOUT) {
+            break;
+        }
+    }
+    bool signaled = event->signaled;
+    if (signaled && !event->manual_reset) {
+        event->signaled = false;
+    }
+    pthread_mutex_unlock(&event->mutex);
+    return signaled;
+}
+
+#endif // !CTHREADS_BACKEND_FUTEX
+
+bool port_tls_alloc(port_tls_t* key) {
+    return pthread_key_create(key, NULL) == 0;
+}
+
+bool port_tls_alloc_destructor(port_tls_t* key, port_tls_destructor destructor) {
+    return pthread_key_create(key, destructor) == 0;
+}
+
+void port_tls_free(port_tls_t key) {
+    pthread_key_delete(key);
+}
+
+bool port_tls_set(port_tls_t key, void* value) {
+    return pthread_setspecific(key, value) == 0;
+}
+
+void* port_tls_get(port_tls_t key) {
+    return pthread_getspecific(key);
+}
+
+void port_sleep_ms(unsigned int ms) {
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    // Restart the sleep if a signal interrupts it
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+uint64_t port_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int port_cpu_count(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+}
+
+int port_last_error(void) {
+    return errno;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file thread_port_win32.c
+ * @brief Win32 backend for the threading portability layer
+ */
+
+#include <stdlib.h>
+#include "thread_port.h"
+
+const char* port_backend_name(void) {
+    return "win32";
+}
+
+// Start block handed to the Win32 thread trampoline
+typedef struct {
+    port_thread_fn fn;
+    void* arg;
+} port_start_t;
+
+// Adapts the portable entry point to the WINAPI calling convention
+static DWORD WINAPI port_thread_trampoline(LPVOID param) {
+    port_start_t start = *(port_start_t*)param;
+    free(param);
+    return (DWORD)start.fn(start.arg);
+}
+
+bool port_thread_create(port_thread_t* thread, port_thread_fn fn, void* arg) {
+    port_start_t* start = (port_start_t*)malloc(sizeof(port_start_t));
+    if (start == NULL) {
+        return false;
+    }
+    start->fn = fn;
+    start->arg = arg;
+    
+    *thread = CreateThread(NULL, 0, port_thread_trampoline, start, 0, NULL);
+    if (*thread == NULL) {
+        free(start);
+        return false;
+    }
+    return true;
+}
+
+bool port_thread_join(port_thread_t thread, int* exit_code) {
+    if (WaitForSingleObject(thread, INFINITE) != WAIT_OBJECT_0) {
+        return false;
+    }
+    if (exit_code != NULL) {
+        DWORD code = 0;
+        GetExitCodeThread(thread, &code);
+        *exit_code = (int)code;
+    }
+    CloseHandle(thread);
+    return true;
+}
+
+bool port_thread_detach(port_thread_t thread) {
+    // Closing the handle lets the thread run on without anyone waiting for it
+    return CloseHandle(thread) != 0;
+}
+
+bool port_thread_terminate(port_thread_t thread) {
+    if (!TerminateThread(thread, 1)) {
+        return false;
+    }
+    CloseHandle(thread);
+    return true;
+}
+
+unsigned long port_thread_get_id(port_thread_t thread) {
+    return (unsigned long)GetThreadId(thread);
+}
+
+unsigned long port_thread_current_id(void) {
+    return (unsigned long)GetCurrentThreadId();
+}
+
+void port_thread_yield(void) {
+    SwitchToThread();
+}
+
+void port_mutex_init(port_mutex_t* mutex) {
+    InitializeCriticalSection(mutex);
+}
+
+void port_mutex_destroy(port_mutex_t* mutex) {
+    DeleteCriticalSection(mutex);
+}
+
+void port_mutex_lock(port_mutex_t* mutex) {
+    EnterCriticalSection(mutex);
+}
+
+bool port_mutex_trylock(port_mutex_t* mutex) {
+    return TryEnterCriticalSection(mutex) != 0;
+}
+
+void port_mutex_unlock(port_mutex_t* mutex) {
+    LeaveCriticalSection(mutex);
+}
+
+void port_cond_init(port_cond_t* cond) {
+    InitializeConditionVariable(cond);
+}
+
+void port_cond_destroy(port_cond_t* cond) {
+    // Condition variables do not need explicit cleanup in Windows
+    (void)cond;
+}
+
+void port_cond_wait(port_cond_t* cond, port_mutex_t* mutex) {
+    SleepConditionVariableCS(cond, mutex, INFINITE);
+}
+
+void port_cond_signal(port_cond_t* cond) {
+    WakeConditionVariable(cond);
+}
+
+void port_cond_broadcast(port_cond_t* cond) {
+    WakeAllConditionVariable(cond);
+}
+
+bool port_event_init(port_event_t* event, bool manual_reset) {
+    *event = CreateEvent(
+        NULL,                           // Default security attributes
+        manual_reset ? TRUE : FALSE,    // Manual or automatic reset
+        FALSE,                          // Initial state non-signaled
+        NULL                            // Unnamed event
+    );
+    return *event != NULL;
+}
+
+void port_event_destroy(port_event_t* event) {
+    CloseHandle(*event);
+}
+
+void port_event_set(port_event_t* event) {
+    SetEvent(*event);
+}
+
+void port_event_reset(port_event_t* event) {
+    ResetEvent(*event);
+}
+
+bool port_event_wait(port_event_t* event, unsigned int timeout_ms) {
+    DWORD timeout = timeout_ms == PORT_INFINITE ? INFINITE : (DWORD)timeout_ms;
+    return WaitForSingleObject(*event, timeout) == WAIT_OBJECT_0;
+}
+
+// Fiber-local slots act as thread-local ones for threads that do not switch fibers,
+// and unlike TlsAlloc slots they call a destructor when the thread exits
+bool port_tls_alloc(port_tls_t* key) {
+    return port_tls_alloc_destructor(key, NULL);
+}
+
+bool port_tls_alloc_destructor(port_tls_t* key, port_tls_destructor destructor) {
+    *key = FlsAlloc((PFLS_CALLBACK_FUNCTION)destructor);
+    return *key != FLS_OUT_OF_INDEXES;
+}
+
+void port_tls_free(port_tls_t key) {
+    FlsFree(key);
+}
+
+bool port_tls_set(port_tls_t key, void* value) {
+    return FlsSetValue(key, value) != 0;
+}
+
+void* port_tls_get(port_tls_t key) {
+    return FlsGetValue(key);
+}
+
+void port_sleep_ms(unsigned int ms) {
+    Sleep(ms);
+}
+
+uint64_t port_time_ns(void) {
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+}
+
+int port_cpu_count(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+}
+
+int port_last_error(void) {
+    return (int)GetLastError();
+}
@@ -1,14 +1,16 @@
 /**
  * @file thread_specific_data.c
- * @brief Thread-local storage demonstration using Windows TLS
+ * @brief Thread-local storage demonstration using TLS slots
  */
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <Windows.h>
+#include <string.h>
+#include "async_log.h"
+#include "thread_port.h"
 
 // Global TLS index - each thread will have its own value at this index
-DWORD tls_index = TLS_OUT_OF_INDEXES;
+port_tls_t tls_index;
 
 // Structure for thread-specific data
 typedef struct {
@@ -21,8 +23,8 @@ typedef struct {
 void cleanup_thread_data(void* data) {
     thread_data_t* tdata = (thread_data_t*)data;
     if (tdata) {
-        printf("Cleanup: Freeing thread-specific data for thread %d (%s)\n", 
-               tdata->thread_id, tdata->thread_name);
+        LOG_INFO("Cleanup: Freeing thread-specific data for thread %d (%s)", 
+                 tdata->thread_id, tdata->thread_name);
         
         // Free the thread name string
         if (tdata->thread_name) {
@@ -35,13 +37,13 @@ void cleanup_thread_data(void* data) {
 }
 
 // Thread function that uses thread-specific data
-DWORD WINAPI tls_thread_function(LPVOID arg) {
+int tls_thread_function(void* arg) {
     int thread_num = *((int*)arg);
     
     // Allocate a thread-specific data structure
     thread_data_t* tdata = (thread_data_t*)malloc(sizeof(thread_data_t));
     if (!tdata) {
-        printf("Thread %d: Failed to allocate thread-specific data\n", thread_num);
+        LOG_ERROR("Thread %d: Failed to allocate thread-specific data", thread_num);
         return 1;
     }
     
@@ -51,24 +53,27 @@ DWORD WINAPI tls_thread_function(LPVOID arg) {
     // Allocate and set the thread name
     char name_buffer[32];
     sprintf(name_buffer, "Worker Thread %d", thread_num);
-    tdata->thread_name = _strdup(name_buffer);
+    tdata->thread_name = (char*)malloc(strlen(name_buffer) + 1);
+    if (tdata->thread_name) {
+        strcpy(tdata->thread_name, name_buffer);
+    }
     tdata->counter = 0;
     
     // Store the pointer in TLS
-    if (!TlsSetValue(tls_index, tdata)) {
-        printf("Thread %d: TlsSetValue failed with error %d\n", thread_num, GetLastError());
+    if (!port_tls_set(tls_index, tdata)) {
+        LOG_ERROR("Thread %d: TLS set failed with error %d", thread_num, port_last_error());
         cleanup_thread_data(tdata);
         return 1;
     }
     
-    printf("Thread %d: Stored thread-specific data at TLS index %u\n", thread_num, tls_index);
+    LOG_INFO("Thread %d: Stored thread-specific data at TLS index %lu", thread_num, (unsigned long)tls_index);
     
     // Simulate some work and access thread-specific data
     for (int i = 0; i < 3; i++) {
         // Get the thread-specific data
-        thread_data_t* my_data = (thread_data_t*)TlsGetValue(tls_index);
+        thread_data_t* my_data = (thread_data_t*)port_tls_get(tls_index);
         if (!my_data) {
-            printf("Thread %d: TlsGetValue failed with error %d\n", thread_num, GetLastError());
+            LOG_ERROR("Thread %d: TLS get failed with error %d", thread_num, port_last_error());
             break;
         }
         
@@ -76,22 +81,22 @@ DWORD WINAPI tls_thread_function(LPVOID arg) {
         my_data->counter++;
         
         // Use the thread-specific data
-        printf("Thread %d (%s): Counter = %d\n", 
-               my_data->thread_id, my_data->thread_name, my_data->counter);
+        LOG_INFO("Thread %d (%s): Counter = %d", 
+                 my_data->thread_id, my_data->thread_name, my_data->counter);
         
         // Sleep to simulate work
-        Sleep(500);
+        port_sleep_ms(500);
     }
     
     // Get the thread-specific data one last time
-    thread_data_t* final_data = (thread_data_t*)TlsGetValue(tls_index);
+    thread_data_t* final_data = (thread_data_t*)port_tls_get(tls_index);
     if (final_data) {
-        printf("Thread %d (%s): Final counter = %d\n", 
-               final_data->thread_id, final_data->thread_name, final_data->counter);
+        LOG_INFO("Thread %d (%s): Final counter = %d", 
+                 final_data->thread_id, final_data->thread_name, final_data->counter);
         
         // Clean up - in a real application, this would be done in a DLL detach or thread exit callback
         cleanup_thread_data(final_data);
-        TlsSetValue(tls_index, NULL);
+        port_tls_set(tls_index, NULL);
     }
     
     return 0;
@@ -99,56 +104,41 @@ DWORD WINAPI tls_thread_function(LPVOID arg) {
 
 // Demo showing TLS (Thread Local Storage) usage
 void thread_local_storage_demo() {
-    HANDLE threads[3];
+    port_thread_t threads[3];
     int thread_ids[3] = {1, 2, 3};
     
     printf("\n=== Thread Local Storage (TLS) Demo ===\n");
     
     // Allocate a TLS index
-    tls_index = TlsAlloc();
-    if (tls_index == TLS_OUT_OF_INDEXES) {
-        fprintf(stderr, "Error: TlsAlloc failed with code %lu\n", GetLastError());
+    if (!port_tls_alloc(&tls_index)) {
+        fprintf(stderr, "Error: TLS allocation failed with code %d\n", port_last_error());
         return;
     }
     
-    printf("Allocated TLS index: %lu\n", tls_index);
+    printf("Allocated TLS index: %lu\n", (unsigned long)tls_index);
     
     // Create multiple threads, each with its own thread-specific data
     for (int i = 0; i < 3; i++) {
-        threads[i] = CreateThread(
-            NULL,                // Default security attributes
-            0,                   // Default stack size
-            tls_thread_function, // Thread function
-            &thread_ids[i],      // Argument to thread function
-            0,                   // Default creation flags
-            NULL                 // Don't store thread ID
-        );
-        
-        if (threads[i] == NULL) {
+        if (!port_thread_create(&threads[i], tls_thread_function, &thread_ids[i])) {
             fprintf(stderr, "Error creating thread %d\n", i + 1);
-            // Close already created threads
+            // Wait for already created threads before freeing their TLS slot
             for (int j = 0; j < i; j++) {
-                CloseHandle(threads[j]);
+                port_thread_join(threads[j], NULL);
             }
-            TlsFree(tls_index);
+            port_tls_free(tls_index);
             return;
         }
     }
     
-    // Wait for all threads to finish
-    WaitForMultipleObjects(3, threads, TRUE, INFINITE);
-    
-    // Close all thread handles
+    // Wait for all threads to finish, then let their log lines out
     for (int i = 0; i < 3; i++) {
-        CloseHandle(threads[i]);
+        port_thread_join(threads[i], NULL);
     }
+    log_flush();
     
     // Free the TLS index
-    if (!TlsFree(tls_index)) {
-        fprintf(stderr, "Error: TlsFree failed with code %lu\n", GetLastError());
-    } else {
-        printf("Freed TLS index: %lu\n", tls_index);
-    }
+    port_tls_free(tls_index);
+    printf("Freed TLS index: %lu\n", (unsigned long)tls_index);
     
     printf("Thread local storage demo completed\n");
 }
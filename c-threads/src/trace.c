@@ -0,0 +1,191 @@
+/**
+ * @file trace.c
+ * @brief Per-thread event buffers and the Chrome trace JSON writer
+ */
+
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// One thread's events. Only the owning thread appends; it publishes each event by
+// storing the new count with release order, so the writer can read up to the count
+// it loaded while the thread keeps recording.
+typedef struct trace_thread_buffer {
+    _Atomic(trace_event_t*) chunks[TRACE_MAX_CHUNKS];
+    _Atomic size_t count;
+    _Atomic uint64_t dropped;
+    size_t thread_id;
+    char name[TRACE_THREAD_NAME_SIZE];       // Guarded by names_lock
+    struct trace_thread_buffer* next;
+} trace_thread_buffer_t;
+
+atomic_bool trace_on = false;
+
+// Every thread buffer ever allocated, newest first; a buffer stays after its thread exits
+static _Atomic(trace_thread_buffer_t*) thread_buffers = NULL;
+static _Atomic size_t thread_count = 0;
+static _Atomic uint64_t start_ns = 0;
+static _Atomic uint64_t next_id = 1;
+
+// Thread names are guarded by a spinlock, which needs no initialization call
+static atomic_flag names_lock = ATOMIC_FLAG_INIT;
+
+static PORT_THREAD_LOCAL trace_thread_buffer_t* tls_buffer = NULL;
+
+static void names_lock_acquire(void) {
+    while (atomic_flag_test_and_set_explicit(&names_lock, memory_order_acquire)) {
+        port_thread_yield();
+    }
+}
+
+static void names_lock_release(void) {
+    atomic_flag_clear_explicit(&names_lock, memory_order_release);
+}
+
+// Allocated on the first event, so threads that never record pay nothing
+static trace_thread_buffer_t* thread_buffer(void) {
+    if (tls_buffer == NULL) {
+        tls_buffer = (trace_thread_buffer_t*)calloc(1, sizeof(trace_thread_buffer_t));
+        if (tls_buffer == NULL) {
+            fprintf(stderr, "Error: Failed to allocate trace buffer\n");
+            exit(EXIT_FAILURE);
+        }
+        tls_buffer->thread_id = atomic_fetch_add(&thread_count, 1) + 1;
+        trace_thread_buffer_t* head = atomic_load_explicit(&thread_buffers, memory_order_relaxed);
+        do {
+            tls_buffer->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&thread_buffers, &head, tls_buffer,
+                                                        memory_order_release, memory_order_relaxed));
+    }
+    return tls_buffer;
+}
+
+void trace_start(void) {
+    atomic_store_explicit(&start_ns, port_time_ns(), memory_order_relaxed);
+    atomic_store_explicit(&trace_on, true, memory_order_release);
+}
+
+void trace_stop(void) {
+    atomic_store_explicit(&trace_on, false, memory_order_release);
+}
+
+uint64_t trace_next_id(void) {
+    return atomic_fetch_add_explicit(&next_id, 1, memory_order_relaxed);
+}
+
+void trace_record(const trace_event_t* event) {
+    trace_thread_buffer_t* buffer = thread_buffer();
+    size_t index = atomic_load_explicit(&buffer->count, memory_order_relaxed);
+    size_t chunk = index / TRACE_CHUNK_EVENTS;
+    if (chunk >= TRACE_MAX_CHUNKS) {
+        atomic_store_explicit(&buffer->dropped,
+                              atomic_load_explicit(&buffer->dropped, memory_order_relaxed) + 1,
+                              memory_order_relaxed);
+        return;
+    }
+    
+    trace_event_t* events = atomic_load_explicit(&buffer->chunks[chunk], memory_order_relaxed);
+    if (events == NULL) {
+        events = (trace_event_t*)malloc(TRACE_CHUNK_EVENTS * sizeof(trace_event_t));
+        if (events == NULL) {
+            atomic_store_explicit(&buffer->dropped,
+                                  atomic_load_explicit(&buffer->dropped, memory_order_relaxed) + 1,
+                                  memory_order_relaxed);
+            return;
+        }
+        atomic_store_explicit(&buffer->chunks[chunk], events, memory_order_relaxed);
+    }
+    events[index % TRACE_CHUNK_EVENTS] = *event;
+    atomic_store_explicit(&buffer->count, index + 1, memory_order_release);
+}
+
+void trace_thread_name(const char* name) {
+    trace_thread_buffer_t* buffer = thread_buffer();
+    names_lock_acquire();
+    snprintf(buffer->name, sizeof(buffer->name), "%s", name);
+    names_lock_release();
+}
+
+static void write_json_string(FILE* out, const char* text) {
+    fputc('"', out);
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(out, "\\%c", *c);
+        } else if ((unsigned char)*c < 0x20) {
+            fprintf(out, "\\u%04x", (unsigned int)(unsigned char)*c);
+        } else {
+            fputc(*c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+// Chrome trace timestamps are microseconds
+static void write_microseconds(FILE* out, uint64_t ns) {
+    fprintf(out, "%llu.%03llu", (unsigned long long)(ns / 1000), (unsigned long long)(ns % 1000));
+}
+
+static void write_event(FILE* out, const trace_event_t* event, size_t thread_id, uint64_t origin_ns) {
+    uint64_t timestamp = event->timestamp_ns > origin_ns ? event->timestamp_ns - origin_ns : 0;
+    
+    fputs("{\"name\":", out);
+    write_json_string(out, event->name);
+    fputs(",\"cat\":", out);
+    write_json_string(out, event->category);
+    fprintf(out, ",\"ph\":\"%c\",\"ts\":", event->phase);
+    write_microseconds(out, timestamp);
+    fprintf(out, ",\"pid\":1,\"tid\":%llu", (unsigned long long)thread_id);
+    if (event->phase == 'X') {
+        fputs(",\"dur\":", out);
+        write_microseconds(out, event->duration_ns);
+    } else if (event->phase == 'b' || event->phase == 'e') {
+        fprintf(out, ",\"id\":%llu", (unsigned long long)event->id);
+    } else if (event->phase == 'C') {
+        fprintf(out, ",\"args\":{\"value\":%lld}", (long long)event->value);
+    }
+    fputc('}', out);
+}
+
+bool trace_write(const char* path) {
+    FILE* out = fopen(path, "w");
+    if (out == NULL) {
+        return false;
+    }
+    
+    uint64_t origin_ns = atomic_load_explicit(&start_ns, memory_order_relaxed);
+    uint64_t dropped = 0;
+    bool first = true;
+    
+    fputs("{\"traceEvents\":[", out);
+    names_lock_acquire();
+    for (trace_thread_buffer_t* buffer = atomic_load_explicit(&thread_buffers, memory_order_acquire);
+         buffer != NULL; buffer = buffer->next) {
+        if (buffer->name[0] != '\0') {
+            fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%llu,\"args\":{\"name\":",
+                    first ? "\n" : ",\n", (unsigned long long)buffer->thread_id);
+            write_json_string(out, buffer->name);
+            fputs("}}", out);
+            first = false;
+        }
+        
+        size_t count = atomic_load_explicit(&buffer->count, memory_order_acquire);
+        for (size_t i = 0; i < count; i++) {
+            const trace_event_t* events =
+                atomic_load_explicit(&buffer->chunks[i / TRACE_CHUNK_EVENTS], memory_order_relaxed);
+            fputs(first ? "\n" : ",\n", out);
+            write_event(out, &events[i % TRACE_CHUNK_EVENTS], buffer->thread_id, origin_ns);
+            first = false;
+        }
+        dropped += atomic_load_explicit(&buffer->dropped, memory_order_relaxed);
+    }
+    names_lock_release();
+    fputs("\n]}\n", out);
+    
+    if (dropped > 0) {
+        fprintf(stderr, "Trace buffers were full: %llu events dropped\n", (unsigned long long)dropped);
+    }
+    bool ok = !ferror(out);
+    return fclose(out) == 0 && ok;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file trace.h
+ * @brief Timeline tracing of threads, jobs and counters in Chrome trace format
+ *
+ * Run CThreads with --trace=FILE and open FILE in chrome://tracing or
+ * https://ui.perfetto.dev to see one row per thread instead of interleaved
+ * printf lines. Spans mark what a thread was doing, async events mark the
+ * time a job spent queued before a worker picked it up, and counters plot
+ * a value such as the queue depth over time.
+ *
+ * Each thread appends to a buffer of its own without locks or shared
+ * writes; the buffers outlive their threads and are written out together.
+ * While tracing is off every call costs one relaxed load.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "thread_port.h"
+
+// Events per chunk of a thread's buffer; chunks are allocated as the thread records
+#define TRACE_CHUNK_EVENTS 4096
+
+// Chunks per thread; events past TRACE_CHUNK_EVENTS * TRACE_MAX_CHUNKS are dropped and counted
+#define TRACE_MAX_CHUNKS 64
+
+// Longest thread name kept, including the terminator
+#define TRACE_THREAD_NAME_SIZE 32
+
+// One recorded event. Names and categories must be string literals (or live as long).
+typedef struct {
+    const char* name;
+    const char* category;
+    char phase;                  // 'X' span, 'b'/'e' async begin/end, 'C' counter
+    uint64_t timestamp_ns;
+    uint64_t duration_ns;        // Spans only
+    uint64_t id;                 // Async events only
+    int64_t value;               // Counters only
+} trace_event_t;
+
+extern atomic_bool trace_on;
+
+static inline bool trace_enabled(void) {
+    return atomic_load_explicit(&trace_on, memory_order_relaxed);
+}
+
+// Start recording; timestamps in the file are relative to this call
+void trace_start(void);
+
+// Stop recording; what was recorded stays for trace_write
+void trace_stop(void);
+
+// Write every recorded event as Chrome trace JSON; false when the file cannot be written
+bool trace_write(const char* path);
+
+// Append to the calling thread's buffer
+void trace_record(const trace_event_t* event);
+
+// Label the calling thread's row in the timeline
+void trace_thread_name(const char* name);
+
+// Identifier that ties an async begin to its end
+uint64_t trace_next_id(void);
+
+// Start of a span, or 0 while tracing is off
+static inline uint64_t trace_span_begin(void) {
+    return trace_enabled() ? port_time_ns() : 0;
+}
+
+// Something the calling thread did since trace_span_begin() returned start_ns
+static inline void trace_span_end(const char* name, const char* category, uint64_t start_ns) {
+    if (start_ns != 0 && trace_enabled()) {
+        uint64_t end_ns = port_time_ns();
+        trace_event_t event = { name, category, 'X', start_ns, end_ns - start_ns, 0, 0 };
+        trace_record(&event);
+    }
+}
+
+// An interval that is not tied to one thread, such as a job waiting in a queue
+static inline void trace_async(const char* name, const char* category, uint64_t id,
+                               uint64_t start_ns, uint64_t end_ns) {
+    if (trace_enabled()) {
+        trace_event_t begin = { name, category, 'b', start_ns, 0, id, 0 };
+        trace_event_t end = { name, category, 'e', end_ns, 0, id, 0 };
+        trace_record(&begin);
+        trace_record(&end);
+    }
+}
+
+static inline void trace_counter(const char* name, int64_t value) {
+    if (trace_enabled()) {
+        trace_event_t event = { name, "counter", 'C', port_time_ns(), 0, 0, value };
+        trace_record(&event);
+    }
+}
+
+#endif // TRACE_H
@@ -0,0 +1,85 @@
+/**
+ * @file adaptive_mutex.cpp
+ * @brief Spinning and parking slow paths of AdaptiveMutex
+ */
+
+#include "adaptive_mutex.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+// Spinning only helps when the owner can run on another CPU at the same time
+static int spin_limit_for_machine() {
+    static const int limit = std::thread::hardware_concurrency() > 1 ? ADAPTIVE_MAX_SPINS : 0;
+    return limit;
+}
+
+// Sleep while *word == expected. Windows 8 and later have the same primitive in
+// WaitOnAddress; elsewhere the thread only yields and keeps polling.
+static void futex_wait(std::atomic<uint32_t>* word, uint32_t expected) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#elif defined(_WIN32) && _WIN32_WINNT >= 0x0602
+    WaitOnAddress(reinterpret_cast<volatile uint32_t*>(word), &expected, sizeof(expected), INFINITE);
+#else
+    (void)word;
+    (void)expected;
+    std::this_thread::yield();
+#endif
+}
+
+static void futex_wake(std::atomic<uint32_t>* word) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#elif defined(_WIN32) && _WIN32_WINNT >= 0x0602
+    WakeByAddressSingle(reinterpret_cast<void*>(word));
+#else
+    (void)word;
+#endif
+}
+
+void AdaptiveMutex::lock_contended() {
+    // Spin for up to twice the recent average, never more than the machine allows
+    int estimate = spin_estimate.load(std::memory_order_relaxed);
+    int max_spins = std::min(spin_limit_for_machine(), estimate * 2 + 10);
+    
+    int backoff = 1;
+    for (int spins = 0; spins < max_spins; ++spins) {
+        // Only attempt the CAS when the lock looks free, so waiters do not steal the line from the owner
+        uint32_t current = state.load(std::memory_order_relaxed);
+        if (current == UNLOCKED &&
+            state.compare_exchange_weak(current, LOCKED, std::memory_order_acquire,
+                                        std::memory_order_relaxed)) {
+            spin_estimate.store(estimate + (spins - estimate) / 8, std::memory_order_relaxed);
+            return;
+        }
+        for (int i = 0; i < backoff; ++i) {
+            cpu_relax();
+        }
+        backoff = std::min(backoff * 2, ADAPTIVE_MAX_BACKOFF);
+    }
+    if (max_spins > 0) {
+        spin_estimate.store(estimate + (max_spins - estimate) / 8, std::memory_order_relaxed);
+    }
+    
+    // Park. Marking the lock contended makes the owner's unlock() wake us; we keep
+    // the contended mark when we take the lock, since other threads may still be parked
+    while (state.exchange(CONTENDED, std::memory_order_acquire) != UNLOCKED) {
+        futex_wait(&state, CONTENDED);
+    }
+}
+
+void AdaptiveMutex::wake_one() {
+    futex_wake(&state);
+}
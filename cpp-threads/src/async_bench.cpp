@@ -0,0 +1,180 @@
+/**
+ * @file async_bench.cpp
+ * @brief Spawn-to-result time of tiny tasks: std::async versus async() on the task pool
+ *
+ * - std_async:  std::async(std::launch::async, ...), a new thread per task on libstdc++
+ * - pool_async: async(default_task_pool(), ...), queued for the pool's fixed workers
+ *
+ * async/spawn_to_result starts one task at a time and waits for its result,
+ * so ns/op is the round trip of a single request. async/burst starts
+ * ASYNC_BENCH_BURST tasks before collecting any of them, the pattern of a
+ * burst of requests, and ns/op is the time per task of the whole burst.
+ * Both run --ops tasks (default 100k) per sample.
+ *
+ * async/fanout is one request fanning out ASYNC_BENCH_FANOUT small jobs and
+ * collecting every result; ns/op is per job, and the p99 is over requests.
+ *
+ * - thread_per_task: a std::packaged_task run by a std::thread of its own
+ * - submit_each:     async() per job, one queue lock and notification each
+ * - async_batch:     async_batch(), one submission and a future per job
+ * - async_all:       async_all(), one submission and one aggregate future
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_harness.h"
+#include "pool_async.h"
+#include "task_pool.h"
+
+// Tasks started before the first result of a burst is collected
+static const size_t ASYNC_BENCH_BURST = 1000;
+
+// Jobs per request in async/fanout
+static const size_t ASYNC_BENCH_FANOUT = 10'000;
+
+static int64_t tiny_task(int64_t value) {
+    return value + 1;
+}
+
+struct StdAsync {
+    std::future<int64_t> operator()(int64_t value) const {
+        return std::async(std::launch::async, tiny_task, value);
+    }
+};
+
+struct PoolAsync {
+    Future<int64_t> operator()(int64_t value) const {
+        return async(default_task_pool(), tiny_task, value);
+    }
+};
+
+// Fail the run when a launch lost or repeated a task's result
+static void check_total(BenchHarness& harness, const std::string& name, const std::string& policy, size_t tasks,
+                        int64_t total) {
+    int64_t expected = static_cast<int64_t>(tasks) * static_cast<int64_t>(tasks + 1) / 2;
+    if (total != expected) {
+        harness.report_failure(name + " " + policy + ": results add up to " + std::to_string(total) +
+                               ", expected " + std::to_string(expected));
+    }
+}
+
+template <typename Launch>
+static void bench_launch(BenchHarness& harness, const std::string& policy, Launch launch) {
+    const size_t tasks = harness.options().ops;
+    
+    std::string name = "async/spawn_to_result";
+    if (harness.enabled(name)) {
+        harness.run(name, policy, 1, tasks, [&]() {
+            int64_t total = 0;
+            uint64_t start = bench_now_ns();
+            for (size_t i = 0; i < tasks; ++i) {
+                total += launch(static_cast<int64_t>(i)).get();
+            }
+            uint64_t elapsed = bench_now_ns() - start;
+            check_total(harness, name, policy, tasks, total);
+            return elapsed;
+        });
+    }
+    
+    name = "async/burst";
+    if (harness.enabled(name)) {
+        harness.run(name, policy, 1, tasks, [&]() {
+            using Result = decltype(launch(0));
+            std::vector<Result> pending;
+            pending.reserve(ASYNC_BENCH_BURST);
+            int64_t total = 0;
+            uint64_t start = bench_now_ns();
+            for (size_t done = 0; done < tasks;) {
+                size_t burst = std::min(ASYNC_BENCH_BURST, tasks - done);
+                for (size_t i = done; i < done + burst; ++i) {
+                    pending.push_back(launch(static_cast<int64_t>(i)));
+                }
+                for (Result& result : pending) {
+                    total += result.get();
+                }
+                pending.clear();
+                done += burst;
+            }
+            uint64_t elapsed = bench_now_ns() - start;
+            check_total(harness, name, policy, tasks, total);
+            return elapsed;
+        });
+    }
+}
+
+// Time fan_out(), which must return the sum of tiny_task(i) over the request's jobs
+template <typename FanOut>
+static void bench_fanout(BenchHarness& harness, const std::string& policy, FanOut fan_out) {
+    const std::string name = "async/fanout";
+    if (!harness.enabled(name)) {
+        return;
+    }
+    harness.run(name, policy, 1, ASYNC_BENCH_FANOUT, [&]() {
+        uint64_t start = bench_now_ns();
+        int64_t total = fan_out();
+        uint64_t elapsed = bench_now_ns() - start;
+        check_total(harness, name, policy, ASYNC_BENCH_FANOUT, total);
+        return elapsed;
+    });
+}
+
+void async_bench(BenchHarness& harness) {
+    bench_launch(harness, "std_async", StdAsync());
+    bench_launch(harness, "pool_async", PoolAsync());
+    
+    bench_fanout(harness, "thread_per_task", []() {
+        std::vector<std::future<int64_t>> futures;
+        std::vector<std::thread> threads;
+        futures.reserve(ASYNC_BENCH_FANOUT);
+        threads.reserve(ASYNC_BENCH_FANOUT);
+        for (size_t i = 0; i < ASYNC_BENCH_FANOUT; ++i) {
+            std::packaged_task<int64_t(int64_t)> task(tiny_task);
+            futures.push_back(task.get_future());
+            threads.emplace_back(std::move(task), static_cast<int64_t>(i));
+        }
+        int64_t total = 0;
+        for (auto& future : futures) {
+            total += future.get();
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return total;
+    });
+    bench_fanout(harness, "submit_each", []() {
+        std::vector<Future<int64_t>> futures;
+        futures.reserve(ASYNC_BENCH_FANOUT);
+        for (size_t i = 0; i < ASYNC_BENCH_FANOUT; ++i) {
+            futures.push_back(async(default_task_pool(), tiny_task, static_cast<int64_t>(i)));
+        }
+        int64_t total = 0;
+        for (auto& future : futures) {
+            total += future.get();
+        }
+        return total;
+    });
+    bench_fanout(harness, "async_batch", []() {
+        std::vector<Future<int64_t>> futures = async_batch(default_task_pool(), ASYNC_BENCH_FANOUT, [](size_t i) {
+            return tiny_task(static_cast<int64_t>(i));
+        });
+        int64_t total = 0;
+        for (auto& future : futures) {
+            total += future.get();
+        }
+        return total;
+    });
+    bench_fanout(harness, "async_all", []() {
+        std::vector<int64_t> results = async_all(default_task_pool(), ASYNC_BENCH_FANOUT, [](size_t i) {
+            return tiny_task(static_cast<int64_t>(i));
+        }).get();
+        int64_t total = 0;
+        for (int64_t result : results) {
+            total += result;
+        }
+        return total;
+    });
+}
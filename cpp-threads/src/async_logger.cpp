@@ -0,0 +1,267 @@
+/**
+ * @file async_logger.cpp
+ * @brief Per-thread message rings and the thread that drains them
+ */
+
+#include "async_logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct LogRecord {
+    uint64_t timestamp_ns;
+    uint32_t thread;                     // Small number of the thread that logged it
+    LogLevel level;
+    char text[LOG_MESSAGE_SIZE];
+};
+
+// Single-producer single-consumer ring. The owning thread advances head, the drain
+// thread advances tail; each side keeps its counter on a cache line of its own.
+struct LogRing {
+    alignas(64) std::atomic<size_t> head{0};
+    size_t cached_tail = 0;              // Producer's last view of tail
+    std::atomic<uint64_t> dropped{0};
+    
+    alignas(64) std::atomic<size_t> tail{0};
+    std::atomic<bool> owned{true};       // Cleared when the owning thread exits
+    
+    LogRecord records[LOG_RING_RECORDS];
+};
+
+struct Logger {
+    std::mutex mutex;                    // Guards everything below
+    std::condition_variable wake;        // Drain thread: a flush was requested or the program ends
+    std::condition_variable flushed;     // Flushing threads: a drain pass finished
+    std::vector<std::unique_ptr<LogRing>> rings;
+    std::FILE* output = stdout;
+    std::thread drainer;
+    bool stopping = false;
+    uint64_t flush_requested = 0;
+    uint64_t flush_completed = 0;
+    uint32_t next_thread = 1;
+    uint64_t start_ns = 0;
+};
+
+static uint64_t log_now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Never destroyed: detached threads may still log while static destructors run
+static Logger& logger() {
+    static Logger* instance = [] {
+        Logger* log = new Logger;
+        log->start_ns = log_now_ns();
+        return log;
+    }();
+    return *instance;
+}
+
+static const char* level_prefix(LogLevel level) {
+    switch (level) {
+    case LogLevel::Debug: return "DEBUG ";
+    case LogLevel::Warn: return "WARN ";
+    case LogLevel::Error: return "ERROR ";
+    default: return "";
+    }
+}
+
+// Write everything the rings hold, oldest first, then hand the slots back to the producers
+static void drain_rings(const std::vector<LogRing*>& rings, std::FILE* out, uint64_t start_ns,
+                        uint64_t& dropped_reported) {
+    std::vector<size_t> heads(rings.size());
+    std::vector<const LogRecord*> batch;
+    for (size_t r = 0; r < rings.size(); ++r) {
+        size_t tail = rings[r]->tail.load(std::memory_order_relaxed);
+        heads[r] = rings[r]->head.load(std::memory_order_acquire);
+        for (size_t i = tail; i != heads[r]; ++i) {
+            batch.push_back(&rings[r]->records[i % LOG_RING_RECORDS]);
+        }
+    }
+    
+    if (out != nullptr && !batch.empty()) {
+        std::stable_sort(batch.begin(), batch.end(), [](const LogRecord* a, const LogRecord* b) {
+            return a->timestamp_ns < b->timestamp_ns;
+        });
+        std::string text;
+        char prefix[64];
+        for (const LogRecord* record : batch) {
+            double ms = static_cast<double>(record->timestamp_ns - start_ns) / 1e6;
+            std::snprintf(prefix, sizeof(prefix), "[+%.3fms T%u] %s", ms, record->thread,
+                          level_prefix(record->level));
+            text += prefix;
+            text += record->text;
+            text += '\n';
+        }
+        std::fwrite(text.data(), 1, text.size(), out);
+    }
+    
+    for (size_t r = 0; r < rings.size(); ++r) {
+        rings[r]->tail.store(heads[r], std::memory_order_release);
+    }
+    
+    uint64_t dropped = 0;
+    for (LogRing* ring : rings) {
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    if (out != nullptr && dropped > dropped_reported) {
+        std::fprintf(out, "[log] %llu messages dropped, their thread's ring was full\n",
+                     static_cast<unsigned long long>(dropped - dropped_reported));
+    }
+    dropped_reported = dropped;
+    if (out != nullptr) {
+        std::fflush(out);
+    }
+}
+
+static void drain_loop(Logger& log) {
+    std::vector<LogRing*> rings;
+    uint64_t dropped_reported = 0;
+    
+    std::unique_lock<std::mutex> lock(log.mutex);
+    for (;;) {
+        log.wake.wait_for(lock, std::chrono::milliseconds(LOG_DRAIN_INTERVAL_MS), [&log]() {
+            return log.stopping || log.flush_requested != log.flush_completed;
+        });
+        uint64_t request = log.flush_requested;
+        bool stop = log.stopping;
+        std::FILE* out = log.output;
+        rings.clear();
+        for (const auto& ring : log.rings) {
+            rings.push_back(ring.get());
+        }
+        
+        lock.unlock();
+        drain_rings(rings, out, log.start_ns, dropped_reported);
+        lock.lock();
+        
+        log.flush_completed = request;
+        log.flushed.notify_all();
+        if (stop) {
+            return;
+        }
+    }
+}
+
+// The calling thread's ring, returned to the logger for reuse when the thread exits
+struct RingLease {
+    LogRing* ring = nullptr;
+    uint32_t thread = 0;
+    
+    ~RingLease() {
+        if (ring != nullptr) {
+            ring->owned.store(false, std::memory_order_release);
+        }
+    }
+};
+
+static void acquire_ring(RingLease& lease) {
+    Logger& log = logger();
+    std::lock_guard<std::mutex> lock(log.mutex);
+    lease.thread = log.next_thread++;
+    
+    // A ring left by an exited thread may still hold messages; they keep their order
+    for (const auto& ring : log.rings) {
+        if (!ring->owned.load(std::memory_order_acquire)) {
+            ring->owned.store(true, std::memory_order_relaxed);
+            lease.ring = ring.get();
+            break;
+        }
+    }
+    if (lease.ring == nullptr) {
+        log.rings.push_back(std::make_unique<LogRing>());
+        lease.ring = log.rings.back().get();
+    }
+    
+    if (!log.drainer.joinable() && !log.stopping) {
+        log.drainer = std::thread(drain_loop, std::ref(log));
+    }
+}
+
+void log_write(LogLevel level, const char* format, ...) {
+    static thread_local RingLease lease;
+    if (lease.ring == nullptr) {
+        acquire_ring(lease);
+    }
+    LogRing& ring = *lease.ring;
+    
+    // Only a ring that looks full costs a read of the drain thread's cache line
+    size_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.cached_tail == LOG_RING_RECORDS) {
+        ring.cached_tail = ring.tail.load(std::memory_order_acquire);
+        if (head - ring.cached_tail == LOG_RING_RECORDS) {
+            ring.dropped.store(ring.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    
+    LogRecord& record = ring.records[head % LOG_RING_RECORDS];
+    record.timestamp_ns = log_now_ns();
+    record.thread = lease.thread;
+    record.level = level;
+    va_list args;
+    va_start(args, format);
+    if (std::vsnprintf(record.text, LOG_MESSAGE_SIZE, format, args) < 0) {
+        record.text[0] = '\0';
+    }
+    va_end(args);
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void log_flush() {
+    Logger& log = logger();
+    std::unique_lock<std::mutex> lock(log.mutex);
+    if (!log.drainer.joinable() || log.stopping) {
+        return;
+    }
+    uint64_t ticket = ++log.flush_requested;
+    log.wake.notify_one();
+    log.flushed.wait(lock, [&log, ticket]() { return log.flush_completed >= ticket; });
+}
+
+void log_set_output(std::FILE* out) {
+    log_flush();
+    {
+        Logger& log = logger();
+        std::lock_guard<std::mutex> lock(log.mutex);
+        log.output = out;
+    }
+    
+    // A drain pass already under way may still write to the old output; wait it out
+    log_flush();
+}
+
+uint64_t log_dropped() {
+    Logger& log = logger();
+    std::lock_guard<std::mutex> lock(log.mutex);
+    uint64_t dropped = 0;
+    for (const auto& ring : log.rings) {
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+// Write what is left and stop the drain thread when the program ends
+static struct LogShutdown {
+    ~LogShutdown() {
+        Logger& log = logger();
+        std::thread drainer;
+        {
+            std::lock_guard<std::mutex> lock(log.mutex);
+            log.stopping = true;
+            std::swap(drainer, log.drainer);
+        }
+        log.wake.notify_one();
+        if (drainer.joinable()) {
+            drainer.join();
+        }
+    }
+} log_shutdown;
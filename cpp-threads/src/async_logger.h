@@ -0,0 +1,70 @@
+/**
+ * @file async_logger.h
+ * @brief Logging from worker threads without serializing them on std::cout
+ *
+ * LOG_INFO("Computing sum of %d and %d", a, b) formats the message into a
+ * ring buffer owned by the calling thread and returns; no lock is taken and
+ * no other thread's cache lines are written. A background thread drains
+ * every ring in batches, orders each batch by timestamp and writes it to
+ * stdout (or another FILE*) with the time and a thread number in front.
+ * When a ring is full the message is dropped and counted rather than
+ * making the producer wait.
+ *
+ * Statements below CPPTHREADS_LOG_LEVEL are discarded at compile time,
+ * arguments included, so a disabled LOG_DEBUG costs nothing.
+ */
+
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+enum class LogLevel { Debug = 0, Info = 1, Warn = 2, Error = 3 };
+
+// Lowest level that is compiled in; override with -DCPPTHREADS_LOG_LEVEL=0..4
+#ifndef CPPTHREADS_LOG_LEVEL
+#define CPPTHREADS_LOG_LEVEL 1
+#endif
+
+// Messages each thread can have waiting for the drain thread
+const size_t LOG_RING_RECORDS = 1024;
+
+// Longest message kept, including the terminator; longer ones are truncated
+const size_t LOG_MESSAGE_SIZE = 200;
+
+// How often the drain thread looks for messages when nobody calls log_flush()
+const int LOG_DRAIN_INTERVAL_MS = 5;
+
+#if defined(__GNUC__) || defined(__clang__)
+#define LOG_PRINTF_FORMAT __attribute__((format(printf, 2, 3)))
+#else
+#define LOG_PRINTF_FORMAT
+#endif
+
+// Format a message into the calling thread's ring; use the LOG_* macros instead
+void log_write(LogLevel level, const char* format, ...) LOG_PRINTF_FORMAT;
+
+// Block until every message logged before the call has been written
+void log_flush();
+
+// Where drained messages go from now on; nullptr discards them. Default: stdout.
+void log_set_output(std::FILE* out);
+
+// Messages dropped so far because their thread's ring was full
+uint64_t log_dropped();
+
+#define LOG_AT(level, ...) \
+    do { \
+        if constexpr (static_cast<int>(level) >= CPPTHREADS_LOG_LEVEL) { \
+            log_write(level, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_DEBUG(...) LOG_AT(LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARN(...) LOG_AT(LogLevel::Warn, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(LogLevel::Error, __VA_ARGS__)
+
+#endif // ASYNC_LOGGER_H
@@ -11,11 +11,17 @@
 #include <random>
 #include <exception>
 #include <functional>
+#include "async_logger.h"
+#include "broadcast.h"
+#include "continuable_future.h"
+#include "pool_async.h"
+#include "task_pool.h"
+#include "trace.h"
 
 // Simple function to be executed asynchronously
 int compute_sum(int a, int b) {
-    std::cout << "Computing sum of " << a << " and " << b 
-              << " in thread " << std::this_thread::get_id() << std::endl;
+    TraceSpan span("compute_sum", "async_patterns");
+    LOG_INFO("Computing sum of %d and %d", a, b);
     
     // Simulate some work
     std::this_thread::sleep_for(std::chrono::milliseconds(500));
@@ -25,8 +31,7 @@ int compute_sum(int a, int b) {
 
 // Function that might throw an exception
 double compute_division(double a, double b) {
-    std::cout << "Computing division " << a << " / " << b 
-              << " in thread " << std::this_thread::get_id() << std::endl;
+    LOG_INFO("Computing division %g / %g", a, b);
     
     // Simulate some work
     std::this_thread::sleep_for(std::chrono::milliseconds(500));
@@ -41,8 +46,7 @@ double compute_division(double a, double b) {
 // Function for promise-future example
 void perform_work(std::promise<int>&& promise, int value) {
     try {
-        std::cout << "Worker thread " << std::this_thread::get_id() 
-                  << " started, computing value..." << std::endl;
+        LOG_INFO("Worker thread started, computing value...");
         
         // Simulate complex calculation
         std::this_thread::sleep_for(std::chrono::milliseconds(1000));
@@ -51,7 +55,7 @@ void perform_work(std::promise<int>&& promise, int value) {
         int result = value * value;
         promise.set_value(result);
         
-        std::cout << "Worker thread completed, result: " << result << std::endl;
+        LOG_INFO("Worker thread completed, result: %d", result);
     }
     catch (...) {
         // Set the exception if something goes wrong
@@ -85,9 +89,10 @@ void async_demo() {
     std::cout << "Calling get(), which will execute the function now." << std::endl;
     std::cout << "Result: " << result2.get() << std::endl;
     
-    // Launch async task with async execution (new thread)
-    std::cout << "\n3. Async execution (guaranteed new thread):" << std::endl;
-    std::future<int> result3 = std::async(std::launch::async, compute_sum, 30, 40);
+    // std::launch::async starts a new thread per call; async() queues the call on
+    // the pool's fixed set of workers instead
+    std::cout << "\n3. Async execution on the task pool (no new thread):" << std::endl;
+    Future<int> result3 = async(default_task_pool(), compute_sum, 30, 40);
     
     std::cout << "Task is running asynchronously now..." << std::endl;
     
@@ -95,8 +100,7 @@ void async_demo() {
     for (int i = 0; i < 10; ++i) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
         
-        auto status = result3.wait_for(std::chrono::milliseconds(0));
-        if (status == std::future_status::ready) {
+        if (result3.is_ready()) {
             std::cout << "Result is ready!" << std::endl;
             break;
         } else {
@@ -109,7 +113,7 @@ void async_demo() {
     
     // Exception handling with async
     std::cout << "\n4. Exception handling with async:" << std::endl;
-    std::future<double> div_result = std::async(std::launch::async, compute_division, 10.0, 0.0);
+    Future<double> div_result = async(default_task_pool(), compute_division, 10.0, 0.0);
     
     try {
         double result = div_result.get();
@@ -163,6 +167,10 @@ void packaged_task_demo() {
     
     // Wait for and get the result
     std::cout << "Main thread waiting for packaged task result..." << std::endl;
+    {
+        TraceSpan wait_span("future.get", "async_patterns");
+        future.wait();
+    }
     std::cout << "Result: " << future.get() << std::endl;
     
     // Join the task thread
@@ -171,36 +179,25 @@ void packaged_task_demo() {
     // Create a vector of packaged tasks
     std::cout << "\nRunning multiple packaged tasks:" << std::endl;
     
-    std::vector<std::packaged_task<int(int, int)>> tasks;
-    std::vector<std::future<int>> futures;
-    
-    // Create 5 tasks
+    // Create 5 tasks, each with its own parameters bound in
+    std::vector<std::packaged_task<int()>> tasks;
     for (int i = 0; i < 5; ++i) {
-        std::packaged_task<int(int, int)> new_task(compute_sum);
-        futures.push_back(new_task.get_future());
-        tasks.push_back(std::move(new_task));
+        tasks.emplace_back([i]() { return compute_sum(i * 10, i * 20); });
     }
     
-    // Launch each task with different parameters
-    std::vector<std::thread> threads;
-    for (int i = 0; i < 5; ++i) {
-        threads.emplace_back(std::move(tasks[i]), i * 10, i * 20);
-    }
+    // Hand all of them to the pool in one submission instead of a thread each
+    std::vector<std::future<int>> futures = submit_packaged(default_task_pool(), tasks);
     
     // Collect and print all results
     int total = 0;
     for (int i = 0; i < 5; ++i) {
+        TraceSpan wait_span("future.get", "async_patterns");
         int result = futures[i].get();
         std::cout << "Task " << i << " result: " << result << std::endl;
         total += result;
     }
     
     std::cout << "Sum of all results: " << total << std::endl;
-    
-    // Join all threads
-    for (auto& thread : threads) {
-        thread.join();
-    }
 }
 
 // Function to demonstrate shared_future
@@ -246,6 +243,17 @@ void shared_future_demo() {
     }
     
     std::cout << "shared_future allows multiple threads to receive the same result" << std::endl;
+    
+    // The same broadcast without a thread per consumer: each consumer registers a
+    // callback, and set_value() runs all of them in one pass on the calling thread
+    std::cout << "\nBroadcast to callbacks instead of consumer threads:" << std::endl;
+    Broadcast<int> broadcast;
+    for (int i = 1; i <= 3; ++i) {
+        broadcast.on_set([i](const int& result) {
+            std::cout << "Consumer " << i << " received result: " << result << std::endl;
+        });
+    }
+    broadcast.set_value(99);
 }
 
 // Function to demonstrate async error handling
@@ -260,8 +268,8 @@ void async_error_handling_demo() {
         // No return statement needed here
     };
     
-    // Start an async task that will throw
-    std::future<int> future = std::async(std::launch::async, throw_error);
+    // Start an async task on the pool that will throw
+    Future<int> future = async(default_task_pool(), throw_error);
     
     std::cout << "Started async task that will throw an exception" << std::endl;
     
@@ -277,55 +285,72 @@ void async_error_handling_demo() {
 }
 
 // Function to demonstrate continuations with then()
-// Note: C++11/14 doesn't have built-in continuation support,
-// this is a simplified example showing how it could be implemented
+// std::future has no then(); Future (continuable_future.h) runs each step when
+// the previous one sets its value, so no thread sits blocked between steps
 void continuation_demo() {
-    std::cout << "\n=== Continuation Demo (manual implementation) ===" << std::endl;
-    
-    // Our manual implementation of a continuation
-    auto then = [](std::future<int>&& future, std::function<double(int)> func) -> std::future<double> {
-        // Create a promise for the continuation's result
-        std::promise<double> promise;
-        std::future<double> result = promise.get_future();
-        
-        // Start a thread to wait for the input future and apply the continuation
-        std::thread([](std::promise<double> p, std::future<int> f, std::function<double(int)> fn) {
-            try {
-                // Wait for the input future
-                int value = f.get();
-                
-                // Apply the continuation function
-                double continued_value = fn(value);
-                
-                // Set the result of the continuation
-                p.set_value(continued_value);
-            }
-            catch (...) {
-                // Propagate any exceptions
-                p.set_exception(std::current_exception());
-            }
-        }, std::move(promise), std::move(future), func).detach();
-        
-        return result;
-    };
-    
-    // Start with a simple async task
-    std::future<int> future = std::async(std::launch::async, []() {
-        std::cout << "Initial computation running..." << std::endl;
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
-        return 42;
-    });
-    
-    // Add a continuation that squares the result
-    std::future<double> continuation = then(std::move(future), [](int value) -> double {
-        std::cout << "Continuation running with input: " << value << std::endl;
+    std::cout << "\n=== Continuation Demo (Future::then) ===" << std::endl;
+    
+    // Three workers, so the delayed tasks of the when_any example overlap
+    TaskPool pool(3);
+    
+    // Attach the steps before the value exists
+    Promise<int> promise;
+    Future<double> continuation = promise.get_future()
+        .then(pool, [](int value) -> double {
+            // Submitted to the pool when the value is set
+            LOG_INFO("Continuation running with input: %d", value);
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            return value * value;
+        })
+        .then([](double squared) {
+            // Runs inline on the worker that finished the previous step
+            LOG_INFO("Second continuation received: %g", squared);
+            return squared;
+        });
+    
+    // Start with a simple asynchronous computation that fulfils the promise
+    std::thread producer([promise = std::move(promise)]() mutable {
+        LOG_INFO("Initial computation running...");
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
-        return value * value;
+        promise.set_value(42);
     });
     
     // Get the final result
     std::cout << "Waiting for continuation result..." << std::endl;
-    std::cout << "Final result: " << continuation.get() << std::endl;
+    double result = continuation.get();
+    producer.join();
+    log_flush();
+    std::cout << "Final result: " << result << std::endl;
+    
+    // Combine futures: when_any takes the first to finish, when_all waits for every one
+    std::cout << "\nCombining futures with when_any and when_all:" << std::endl;
+    auto delayed = [&pool](int value, int delay_ms) {
+        return make_ready_future(delay_ms).then(pool, [value](int delay) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+            return value;
+        });
+    };
+    
+    std::vector<Future<int>> racers;
+    racers.push_back(delayed(1, 300));
+    racers.push_back(delayed(2, 100));
+    racers.push_back(delayed(3, 200));
+    WhenAnyResult<int> first = when_any(std::move(racers)).get();
+    std::cout << "when_any: future " << first.index << " finished first with " << first.value << std::endl;
+    
+    std::vector<Future<int>> parts;
+    for (int i = 1; i <= 3; ++i) {
+        parts.push_back(delayed(i * 10, 50));
+    }
+    Future<int> total = when_all(std::move(parts)).then([](std::vector<int> values) {
+        int sum = 0;
+        for (int value : values) {
+            sum += value;
+        }
+        return sum;
+    });
+    std::cout << "when_all: sum of all results: " << total.get() << std::endl;
+    log_flush();
 }
 
 // Main function to run async pattern demos
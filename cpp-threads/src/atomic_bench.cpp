@@ -0,0 +1,69 @@
+/**
+ * @file atomic_bench.cpp
+ * @brief Atomic benchmarks: seq_cst vs relaxed read-modify-write, loads and stores
+ *
+ * Shared variants hit one counter from every thread; the private variants
+ * give each thread its own cache line, which isolates the cost of the memory
+ * order from the cost of cache-line ping-pong.
+ */
+
+#include <atomic>
+#include <memory>
+#include "bench_harness.h"
+
+// One counter per cache line
+struct alignas(64) PaddedCounter {
+    std::atomic<long> value{0};
+};
+
+// Run one atomic benchmark for every thread count in the sweep; op(thread_index)
+template <typename Op>
+static void sweep_atomic(BenchHarness& harness, const std::string& name, const std::string& policy, Op op) {
+    if (!harness.enabled(name)) {
+        return;
+    }
+    const size_t ops = harness.options().ops;
+    for (int threads : harness.thread_sweep()) {
+        harness.run(name, policy, threads, ops * threads, [&]() {
+            return measure_threads(threads, [&](int index) {
+                for (size_t i = 0; i < ops; ++i) {
+                    op(index);
+                }
+            });
+        });
+    }
+}
+
+void atomic_bench(BenchHarness& harness) {
+    std::atomic<long> shared(0);
+    std::unique_ptr<PaddedCounter[]> private_counters(new PaddedCounter[harness.options().max_threads]);
+    
+    sweep_atomic(harness, "atomic/fetch_add_shared", "seq_cst", [&](int) {
+        shared.fetch_add(1, std::memory_order_seq_cst);
+    });
+    sweep_atomic(harness, "atomic/fetch_add_shared", "relaxed", [&](int) {
+        shared.fetch_add(1, std::memory_order_relaxed);
+    });
+    sweep_atomic(harness, "atomic/fetch_add_private", "seq_cst", [&](int index) {
+        private_counters[index].value.fetch_add(1, std::memory_order_seq_cst);
+    });
+    sweep_atomic(harness, "atomic/fetch_add_private", "relaxed", [&](int index) {
+        private_counters[index].value.fetch_add(1, std::memory_order_relaxed);
+    });
+    
+    // A seq_cst store needs a full fence on x86; release and relaxed stores do not
+    sweep_atomic(harness, "atomic/store_private", "seq_cst", [&](int index) {
+        private_counters[index].value.store(index, std::memory_order_seq_cst);
+    });
+    sweep_atomic(harness, "atomic/store_private", "relaxed", [&](int index) {
+        private_counters[index].value.store(index, std::memory_order_relaxed);
+    });
+    sweep_atomic(harness, "atomic/load_shared", "seq_cst", [&](int) {
+        long value = shared.load(std::memory_order_seq_cst);
+        do_not_optimize(value);
+    });
+    sweep_atomic(harness, "atomic/load_shared", "relaxed", [&](int) {
+        long value = shared.load(std::memory_order_relaxed);
+        do_not_optimize(value);
+    });
+}
@@ -9,14 +9,19 @@
 #include <vector>
 #include <chrono>
 #include <mutex>
+#include "counters.h"
+#include "fair_locks.h"
+#include "lock_profiler.h"
+#include "reclamation.h"
+#include "demo_settings.h"
 
-// Global variables
+// Default thread and increment counts (overridable with --threads and --size)
 const int ATOMIC_NUM_THREADS = 4;
 const int ATOMIC_NUM_INCREMENTS = 10000000;
 
 // Standard non-atomic counter (for comparison)
 int atomic_demo_counter = 0;
-std::mutex atomic_demo_mutex;
+ProfiledMutex atomic_demo_mutex("atomic_demo_mutex");
 
 // Atomic counter with default memory ordering
 std::atomic<int> atomic_demo_atomic_counter(0);
@@ -33,7 +38,7 @@ int r1, r2; // For storing results of memory order tests
 // Function to increment non-atomic counter using mutex
 void atomic_demo_increment_with_mutex(int iterations) {
     for (int i = 0; i < iterations; ++i) {
-        std::lock_guard<std::mutex> lock(atomic_demo_mutex);
+        std::lock_guard<ProfiledMutex> lock(atomic_demo_mutex);
         atomic_demo_counter++;
     }
 }
@@ -56,6 +61,11 @@ void increment_atomic_relaxed(std::atomic<int>& counter, int iterations) {
 void basic_atomic_demo() {
     std::cout << "\n=== Basic Atomic Operations Demo ===" << std::endl;
     
+    // Split the increments evenly between the threads
+    const int num_threads = demo_threads(ATOMIC_NUM_THREADS);
+    const int increments_per_thread = static_cast<int>(demo_size(ATOMIC_NUM_INCREMENTS)) / num_threads;
+    const int expected_count = increments_per_thread * num_threads;
+    
     // Reset counters
     atomic_demo_counter = 0;
     atomic_demo_atomic_counter = 0;
@@ -64,8 +74,8 @@ void basic_atomic_demo() {
     auto start_mutex = std::chrono::high_resolution_clock::now();
     
     std::vector<std::thread> mutex_threads;
-    for (int i = 0; i < ATOMIC_NUM_THREADS; ++i) {
-        mutex_threads.emplace_back(atomic_demo_increment_with_mutex, ATOMIC_NUM_INCREMENTS / ATOMIC_NUM_THREADS);
+    for (int i = 0; i < num_threads; ++i) {
+        mutex_threads.emplace_back(atomic_demo_increment_with_mutex, increments_per_thread);
     }
     
     for (auto& t : mutex_threads) {
@@ -80,8 +90,8 @@ void basic_atomic_demo() {
     auto start_atomic = std::chrono::high_resolution_clock::now();
     
     std::vector<std::thread> atomic_threads;
-    for (int i = 0; i < ATOMIC_NUM_THREADS; ++i) {
-        atomic_threads.emplace_back(increment_atomic_default, ATOMIC_NUM_INCREMENTS / ATOMIC_NUM_THREADS);
+    for (int i = 0; i < num_threads; ++i) {
+        atomic_threads.emplace_back(increment_atomic_default, increments_per_thread);
     }
     
     for (auto& t : atomic_threads) {
@@ -92,14 +102,43 @@ void basic_atomic_demo() {
     auto atomic_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
         end_atomic - start_atomic).count();
     
+    // Test a sharded counter: each thread increments its own cache line
+    ShardedCounter sharded_counter;
+    auto start_sharded = std::chrono::high_resolution_clock::now();
+    
+    std::vector<std::thread> sharded_threads;
+    for (int i = 0; i < num_threads; ++i) {
+        sharded_threads.emplace_back([&sharded_counter, increments_per_thread]() {
+            for (int j = 0; j < increments_per_thread; ++j) {
+                sharded_counter.increment();
+            }
+        });
+    }
+    
+    for (auto& t : sharded_threads) {
+        t.join();
+    }
+    
+    auto end_sharded = std::chrono::high_resolution_clock::now();
+    auto sharded_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        end_sharded - start_sharded).count();
+    
+    // Keep the timings for --format=json/csv reports
+    demo_record("basic_atomic", "mutex", num_threads, expected_count, end_mutex - start_mutex);
+    demo_record("basic_atomic", "seq_cst", num_threads, expected_count, end_atomic - start_atomic);
+    demo_record("basic_atomic", "sharded", num_threads, expected_count, end_sharded - start_sharded);
+    
     // Show results
-    std::cout << "Expected count: " << ATOMIC_NUM_INCREMENTS << std::endl;
+    std::cout << "Expected count: " << expected_count << std::endl;
     std::cout << "Mutex-based counter: " << atomic_demo_counter 
               << " (Time: " << mutex_duration << " ms)" << std::endl;
     std::cout << "Atomic counter: " << atomic_demo_atomic_counter.load() 
               << " (Time: " << atomic_duration << " ms)" << std::endl;
+    std::cout << "Sharded counter: " << sharded_counter.get() 
+              << " (Time: " << sharded_duration << " ms)" << std::endl;
     
     std::cout << "Atomic operations are often faster than mutex for simple operations" << std::endl;
+    std::cout << "Sharding avoids the single contended cache line the atomic counter still has" << std::endl;
 }
 
 // Memory ordering demonstration
@@ -159,15 +198,17 @@ void memory_ordering_demo() {
     
     // Demonstrate relaxed ordering
     auto relaxed_demo = []{
+        const int num_threads = demo_threads(ATOMIC_NUM_THREADS);
+        const int increments_per_thread = static_cast<int>(demo_size(ATOMIC_NUM_INCREMENTS)) / num_threads;
         std::atomic<int> relaxed_counter(0);
         
         auto start_relaxed = std::chrono::high_resolution_clock::now();
         
         std::vector<std::thread> relaxed_threads;
-        for (int i = 0; i < ATOMIC_NUM_THREADS; ++i) {
+        for (int i = 0; i < num_threads; ++i) {
             relaxed_threads.emplace_back(increment_atomic_relaxed, 
                                          std::ref(relaxed_counter), 
-                                         ATOMIC_NUM_INCREMENTS / ATOMIC_NUM_THREADS);
+                                         increments_per_thread);
         }
         
         for (auto& t : relaxed_threads) {
@@ -178,6 +219,9 @@ void memory_ordering_demo() {
         auto relaxed_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
             end_relaxed - start_relaxed).count();
         
+        demo_record("memory_ordering", "relaxed", num_threads, increments_per_thread * num_threads,
+                    end_relaxed - start_relaxed);
+        
         std::cout << "Relaxed counter: " << relaxed_counter.load() 
                   << " (Time: " << relaxed_duration << " ms)" << std::endl;
     };
@@ -185,6 +229,34 @@ void memory_ordering_demo() {
     relaxed_demo();
 }
 
+// Thread 1 takes the lock and threads 2-4 queue behind it, 10 ms apart; print who got it when
+template <typename Lock>
+static void show_arrival_order(Lock& lock, const char* lock_name) {
+    std::mutex order_mutex;
+    std::vector<int> order;
+    std::vector<std::thread> waiters;
+    for (int i = 0; i < 4; ++i) {
+        waiters.emplace_back([&, i]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10 * i));
+            std::lock_guard<Lock> guard(lock);
+            {
+                std::lock_guard<std::mutex> record(order_mutex);
+                order.push_back(i + 1);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        });
+    }
+    for (auto& t : waiters) {
+        t.join();
+    }
+    
+    std::cout << lock_name << " served threads in order:";
+    for (int id : order) {
+        std::cout << " " << id;
+    }
+    std::cout << std::endl;
+}
+
 // Atomic flag for signaling between threads
 void atomic_flag_demo() {
     std::cout << "\n=== Atomic Flag Demo ===" << std::endl;
@@ -219,6 +291,15 @@ void atomic_flag_demo() {
     }
     
     std::cout << "std::atomic_flag provides a simple spinlock mechanism" << std::endl;
+    
+    // A test-and-set lock goes to whichever waiter happens to try first; the FIFO locks
+    // serve threads in the order they asked
+    TicketLock ticket_lock;
+    McsLock mcs_lock;
+    ClhLock clh_lock;
+    show_arrival_order(ticket_lock, "TicketLock");
+    show_arrival_order(mcs_lock, "McsLock");
+    show_arrival_order(clh_lock, "ClhLock");
 }
 
 // Compare-and-exchange operation demonstration
@@ -267,11 +348,16 @@ void atomic_pointer_demo() {
         SharedData(int v) : value(v) {}
         ~SharedData() {
             std::cout << "SharedData with value " << value << " destroyed" << std::endl;
+            
+            // Poison the value, so a reader that still holds this object sees something
+            // that is not a multiple of 100; volatile keeps the store to a dying object
+            *static_cast<volatile int*>(&value) = -1;
         }
     };
     
     // Create an atomic pointer
-    std::atomic<SharedData*> atomic_ptr(nullptr);
+    std::atomic<SharedData*> atomic_ptr(new SharedData(0));
+    std::atomic<bool> updating(true);
     
     // Thread function to update the pointer
     auto update_pointer = [&atomic_ptr](int id) {
@@ -280,17 +366,42 @@ void atomic_pointer_demo() {
         
         // Replace the old pointer with the new one
         SharedData* old_data = atomic_ptr.exchange(new_data);
+        std::cout << "Thread " << id << " replaced SharedData with value "
+                  << old_data->value << std::endl;
         
-        // If there was a previous object, delete it
-        if (old_data) {
-            std::cout << "Thread " << id << " replaced SharedData with value " 
-                      << old_data->value << std::endl;
-            delete old_data;
-        } else {
-            std::cout << "Thread " << id << " set the first SharedData instance" << std::endl;
+        // A reader may still be using old_data, so deleting it here would be a
+        // use-after-free; retire it and let the hazard pointer scan free it
+        hazard_retire(old_data);
+    };
+    
+    // Readers protect the pointer before dereferencing it
+    std::atomic<long> reads(0);
+    std::atomic<long> bad_reads(0);
+    auto read_pointer = [&atomic_ptr, &updating, &reads, &bad_reads]() {
+        while (updating.load()) {
+            HazardPointer hazard;
+            SharedData* data = hazard.protect(atomic_ptr);
+            
+            // Hold the object across a yield, which gives an updater the chance to free it
+            // if the hazard pointer did not protect it; a destroyed object reads -1
+            std::this_thread::yield();
+            if (data->value % 100 != 0) {
+                bad_reads.fetch_add(1, std::memory_order_relaxed);
+            }
+            reads.fetch_add(1, std::memory_order_relaxed);
         }
     };
     
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 2; ++i) {
+        readers.emplace_back(read_pointer);
+    }
+    
+    // Let the readers get going before the pointer starts changing
+    while (reads.load(std::memory_order_relaxed) < 1000) {
+        std::this_thread::yield();
+    }
+    
     // Run multiple threads that update the pointer
     std::vector<std::thread> threads;
     for (int i = 1; i <= 3; ++i) {
@@ -301,6 +412,16 @@ void atomic_pointer_demo() {
     for (auto& t : threads) {
         t.join();
     }
+    updating = false;
+    for (auto& t : readers) {
+        t.join();
+    }
+    std::cout << "Readers dereferenced the shared pointer " << reads.load() << " times, "
+              << bad_reads.load() << " saw a destroyed object" << std::endl;
+    
+    // No reader is left, so every retired object can be freed now
+    size_t freed = hazard_reclaim();
+    std::cout << "Reclaimed " << freed << " retired SharedData objects" << std::endl;
     
     // Clean up the final pointer
     SharedData* final_data = atomic_ptr.load();
@@ -309,7 +430,8 @@ void atomic_pointer_demo() {
         delete final_data;
     }
     
-    std::cout << "Atomic pointers allow thread-safe pointer updates without locks" << std::endl;
+    std::cout << "Atomic pointers allow thread-safe pointer updates without locks;" << std::endl;
+    std::cout << "hazard pointers make it safe to free the objects they replace" << std::endl;
 }
 
 // Main function to run all atomic operations demos
@@ -0,0 +1,100 @@
+/**
+ * @file bench_harness.cpp
+ * @brief Timing and statistics for the CppThreadsBench harness
+ */
+
+#include "bench_harness.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+volatile const void* bench_sink = nullptr;
+
+uint64_t bench_now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t measure_threads(int threads, const std::function<void(int)>& body) {
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back([&, i]() {
+            ready.fetch_add(1, std::memory_order_acq_rel);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            body(i);
+        });
+    }
+    
+    // Thread creation stays outside the timed region
+    while (ready.load(std::memory_order_acquire) < threads) {
+        std::this_thread::yield();
+    }
+    
+    uint64_t start = bench_now_ns();
+    go.store(true, std::memory_order_release);
+    for (auto& t : workers) {
+        t.join();
+    }
+    return bench_now_ns() - start;
+}
+
+BenchHarness::BenchHarness(const BenchOptions& options) : settings(options) {
+    if (settings.max_threads <= 0) {
+        settings.max_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+}
+
+bool BenchHarness::enabled(const std::string& name) const {
+    return settings.filter.empty() || name.find(settings.filter) != std::string::npos;
+}
+
+std::vector<int> BenchHarness::thread_sweep() const {
+    return thread_sweep(settings.max_threads);
+}
+
+std::vector<int> BenchHarness::thread_sweep(int max_threads) const {
+    std::vector<int> counts;
+    for (int t = 1; t < max_threads; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(max_threads);
+    return counts;
+}
+
+const BenchResult& BenchHarness::run(const std::string& name, const std::string& policy, int threads,
+                                     size_t elements, const std::function<uint64_t()>& body,
+                                     const std::function<void(BenchResult&)>& annotate) {
+    for (int i = 0; i < settings.warmup; ++i) {
+        body();
+    }
+    
+    std::vector<double> samples;
+    samples.reserve(settings.repetitions);
+    for (int i = 0; i < settings.repetitions; ++i) {
+        samples.push_back(static_cast<double>(body()) / static_cast<double>(elements));
+    }
+    collected.push_back(summarize_samples(name, policy, threads, elements, samples));
+    if (annotate) {
+        annotate(collected.back());
+    }
+    const BenchResult& result = collected.back();
+    
+    for (ResultSink* sink : sinks) {
+        sink->write(result);
+    }
+    return result;
+}
+
+void BenchHarness::report_failure(const std::string& message) {
+    std::cerr << "FAILED: " << message << std::endl;
+    failure_count++;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file bench_harness.h
+ * @brief Micro-benchmark harness shared by the CppThreadsBench suites
+ *
+ * Every benchmark configuration is run a few times untimed (warmup) and then
+ * repeatedly timed. The harness reports the median and p99 time per
+ * operation together with the coefficient of variation of the samples, so
+ * noisy measurements are visible instead of hidden in a single number.
+ * Results go to every attached ResultSink as soon as they are measured.
+ */
+
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "bench_results.h"
+
+// Harness settings, filled in from the command line
+struct BenchOptions {
+    int warmup = 2;                  // Untimed runs before the measured ones
+    int repetitions = 15;            // Timed runs per configuration
+    int max_threads = 0;             // Upper end of the thread sweep (0 = hardware threads)
+    size_t ops = 100'000;            // Operations per thread for the lock and atomic suites
+    size_t size = 1'000'000;         // Element count for the parallel algorithm suite
+    std::string filter;              // Only run benchmarks whose name contains this text
+};
+
+class BenchHarness {
+public:
+    explicit BenchHarness(const BenchOptions& options);
+    
+    const BenchOptions& options() const { return settings; }
+    
+    // Send every following result to sink as well (the sink must outlive the harness runs)
+    void add_sink(ResultSink& sink) { sinks.push_back(&sink); }
+    
+    // True when the benchmark name passes the --filter option
+    bool enabled(const std::string& name) const;
+    
+    // Thread counts to sweep: powers of two up to max_threads, plus max_threads itself
+    std::vector<int> thread_sweep() const;
+    
+    // The same sweep up to an explicit maximum, for suites that oversubscribe on purpose
+    std::vector<int> thread_sweep(int max_threads) const;
+    
+    // Run body (warmup + repetitions) times. Each call processes `elements`
+    // operations and returns the nanoseconds it spent doing so, which lets the
+    // body keep setup such as copying input data out of the measurement.
+    // annotate, when given, fills in extra fields of the result before it goes
+    // to the sinks.
+    const BenchResult& run(const std::string& name, const std::string& policy, int threads,
+                           size_t elements, const std::function<uint64_t()>& body,
+                           const std::function<void(BenchResult&)>& annotate = nullptr);
+    
+    const std::vector<BenchResult>& results() const { return collected; }
+    
+    // A benchmark's own correctness check failed: print the message to stderr and
+    // make the run end with a failure status, since its timings cannot be trusted
+    void report_failure(const std::string& message);
+    
+    int failures() const { return failure_count; }
+
+private:
+    BenchOptions settings;
+    std::vector<BenchResult> collected;
+    std::vector<ResultSink*> sinks;
+    int failure_count = 0;
+};
+
+// Start `threads` threads, release them together and return the nanoseconds
+// from the release until the last one finishes; body receives the thread index
+uint64_t measure_threads(int threads, const std::function<void(int)>& body);
+
+// Nanoseconds on a monotonic clock
+uint64_t bench_now_ns();
+
+// Keep the optimizer from discarding a value computed only for timing
+extern volatile const void* bench_sink;
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    bench_sink = &value;
+#endif
+}
+
+#endif // BENCH_HARNESS_H
@@ -0,0 +1,181 @@
+/**
+ * @file bench_main.cpp
+ * @brief Entry point for the C++ threading benchmarks
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench_harness.h"
+#include "bench_results.h"
+
+// Benchmark suites from other source files
+extern void sync_bench(BenchHarness& harness);
+extern void atomic_bench(BenchHarness& harness);
+extern void queue_bench(BenchHarness& harness);
+extern void parallel_bench(BenchHarness& harness);
+extern void counter_bench(BenchHarness& harness);
+extern void rcu_bench(BenchHarness& harness);
+extern void rwlock_bench(BenchHarness& harness);
+extern void log_bench(BenchHarness& harness);
+extern void future_bench(BenchHarness& harness);
+extern void async_bench(BenchHarness& harness);
+extern void broadcast_bench(BenchHarness& harness);
+
+static void print_usage() {
+    std::cout << "Usage: CppThreadsBench [options]" << std::endl;
+    std::cout << "       CppThreadsBench compare <baseline> <current> [--threshold=PERCENT]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --filter=TEXT      Only run benchmarks whose name contains TEXT (e.g. lock/, atomic/)" << std::endl;
+    std::cout << "  --warmup=N         Untimed runs before measuring (default 2)" << std::endl;
+    std::cout << "  --repetitions=N    Timed runs per configuration (default 15)" << std::endl;
+    std::cout << "  --max-threads=N    Largest thread count of the sweep (default: hardware threads)" << std::endl;
+    std::cout << "  --ops=N            Operations per thread for lock, atomic and queue benchmarks" << std::endl;
+    std::cout << "  --size=N           Elements for the parallel algorithm benchmarks" << std::endl;
+    std::cout << "  --format=FORMAT    text, json or csv (default text, or from the --output extension)" << std::endl;
+    std::cout << "  --output=FILE      Write results to FILE; the text table still goes to the console" << std::endl;
+    std::cout << "Compare:" << std::endl;
+    std::cout << "  Diffs two JSON/CSV result files and exits with status 2 when any benchmark's" << std::endl;
+    std::cout << "  median ns/op grew by more than the threshold (default 5%)" << std::endl;
+    std::cout << "A run exits with status 3 when a benchmark's own correctness check fails" << std::endl;
+    std::cout << "(e.g. a queue losing or duplicating items)" << std::endl;
+}
+
+// Value of a --name=value argument, or nullptr when arg is a different option
+static const char* option_value(const std::string& arg, const std::string& name) {
+    std::string prefix = "--" + name + "=";
+    return arg.compare(0, prefix.size(), prefix) == 0 ? arg.c_str() + prefix.size() : nullptr;
+}
+
+// Compare two result files; returns the process exit status
+static int compare_main(int argc, char* argv[]) {
+    std::vector<std::string> files;
+    double threshold = 5.0;
+    
+    for (int i = 0; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = nullptr;
+        if ((value = option_value(arg, "threshold")) != nullptr) {
+            threshold = std::atof(value);
+        } else if (arg.compare(0, 2, "--") != 0) {
+            files.push_back(arg);
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    
+    if (files.size() != 2 || threshold < 0.0) {
+        print_usage();
+        return 1;
+    }
+    
+    std::vector<BenchResult> baseline;
+    std::vector<BenchResult> current;
+    std::string error;
+    if (!read_results(files[0], baseline, error) || !read_results(files[1], current, error)) {
+        std::cerr << "Error reading results: " << error << std::endl;
+        return 1;
+    }
+    
+    return compare_results(baseline, current, threshold, std::cout) > 0 ? 2 : 0;
+}
+
+// Guess the output format from a file name, defaulting to JSON
+static ResultFormat format_from_path(const std::string& path) {
+    size_t dot = path.rfind('.');
+    if (dot != std::string::npos && path.substr(dot) == ".csv") {
+        return ResultFormat::Csv;
+    }
+    return ResultFormat::Json;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && std::string(argv[1]) == "compare") {
+        return compare_main(argc - 2, argv + 2);
+    }
+    
+    BenchOptions options;
+    std::string format_name;
+    std::string output_path;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = nullptr;
+        if ((value = option_value(arg, "filter")) != nullptr) {
+            options.filter = value;
+        } else if ((value = option_value(arg, "warmup")) != nullptr) {
+            options.warmup = std::atoi(value);
+        } else if ((value = option_value(arg, "repetitions")) != nullptr) {
+            options.repetitions = std::atoi(value);
+        } else if ((value = option_value(arg, "max-threads")) != nullptr) {
+            options.max_threads = std::atoi(value);
+        } else if ((value = option_value(arg, "ops")) != nullptr) {
+            options.ops = static_cast<size_t>(std::atof(value));
+        } else if ((value = option_value(arg, "size")) != nullptr) {
+            options.size = static_cast<size_t>(std::atof(value));
+        } else if ((value = option_value(arg, "format")) != nullptr) {
+            format_name = value;
+        } else if ((value = option_value(arg, "output")) != nullptr) {
+            output_path = value;
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    
+    if (options.warmup < 0 || options.repetitions <= 0 || options.max_threads < 0 ||
+        options.ops == 0 || options.size < 100) {
+        print_usage();
+        return 1;
+    }
+    
+    ResultFormat format = output_path.empty() ? ResultFormat::Text : format_from_path(output_path);
+    if (!format_name.empty() && !parse_result_format(format_name, format)) {
+        print_usage();
+        return 1;
+    }
+    
+    // The console always gets results; a file, when given, gets the machine-readable copy
+    std::ofstream output_file;
+    std::unique_ptr<ResultSink> console_sink;
+    std::unique_ptr<ResultSink> file_sink;
+    if (output_path.empty()) {
+        console_sink.reset(new ResultSink(format, std::cout));
+    } else {
+        output_file.open(output_path);
+        if (!output_file) {
+            std::cerr << "Cannot write " << output_path << std::endl;
+            return 1;
+        }
+        console_sink.reset(new ResultSink(ResultFormat::Text, std::cout));
+        file_sink.reset(new ResultSink(format, output_file));
+    }
+    
+    BenchHarness harness(options);
+    harness.add_sink(*console_sink);
+    if (file_sink) {
+        harness.add_sink(*file_sink);
+    }
+    
+    sync_bench(harness);
+    atomic_bench(harness);
+    queue_bench(harness);
+    parallel_bench(harness);
+    counter_bench(harness);
+    rcu_bench(harness);
+    rwlock_bench(harness);
+    log_bench(harness);
+    future_bench(harness);
+    async_bench(harness);
+    broadcast_bench(harness);
+    
+    if (harness.failures() > 0) {
+        std::cerr << harness.failures() << " benchmark correctness check(s) failed" << std::endl;
+        return 3;
+    }
+    return 0;
+}
@@ -0,0 +1,453 @@
+/**
+ * @file bench_results.cpp
+ * @brief Text/JSON/CSV writers, readers and the regression comparison for benchmark results
+ */
+
+#include "bench_results.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <tuple>
+
+BenchResult summarize_samples(const std::string& name, const std::string& policy, int threads,
+                              size_t elements, std::vector<double> samples) {
+    BenchResult result;
+    result.name = name;
+    result.policy = policy;
+    result.threads = threads;
+    result.elements = elements;
+    if (samples.empty()) {
+        return result;
+    }
+    std::sort(samples.begin(), samples.end());
+    
+    // Nearest-rank percentiles over the sorted samples
+    auto percentile = [&samples](double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p * samples.size()));
+        return samples[std::min(samples.size(), std::max<size_t>(rank, 1)) - 1];
+    };
+    
+    double mean = 0.0;
+    for (double s : samples) {
+        mean += s;
+    }
+    mean /= samples.size();
+    double variance = 0.0;
+    for (double s : samples) {
+        variance += (s - mean) * (s - mean);
+    }
+    variance /= samples.size();
+    
+    result.median_ns = percentile(0.5);
+    result.p99_ns = percentile(0.99);
+    result.cv = mean > 0.0 ? std::sqrt(variance) / mean : 0.0;
+    result.throughput = result.median_ns > 0.0 ? 1e9 / result.median_ns : 0.0;
+    return result;
+}
+
+bool parse_result_format(const std::string& text, ResultFormat& format) {
+    if (text == "text") {
+        format = ResultFormat::Text;
+    } else if (text == "json") {
+        format = ResultFormat::Json;
+    } else if (text == "csv") {
+        format = ResultFormat::Csv;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// =================== WRITING ===================
+
+static std::string json_escape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+static std::string csv_field(const std::string& text) {
+    if (text.find_first_of(",\"\n") == std::string::npos) {
+        return text;
+    }
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"') {
+            quoted += '"';
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+ResultSink::ResultSink(ResultFormat format, std::ostream& out) : format(format), out(out) {
+    begin();
+}
+
+ResultSink::~ResultSink() {
+    end();
+}
+
+void ResultSink::begin() {
+    switch (format) {
+        case ResultFormat::Text:
+            out << std::left << std::setw(28) << "Benchmark"
+                << std::setw(16) << "Policy"
+                << std::right << std::setw(8) << "Threads"
+                << std::setw(14) << "Median ns/op"
+                << std::setw(14) << "p99 ns/op"
+                << std::setw(8) << "CV %"
+                << std::setw(16) << "Ops/sec" << std::endl;
+            break;
+        case ResultFormat::Json:
+            out << "{\"benchmarks\": [" << std::flush;
+            break;
+        case ResultFormat::Csv:
+            out << "name,policy,threads,elements,ns_per_op,p99_ns_per_op,cv,throughput,slowest_share" << std::endl;
+            break;
+    }
+}
+
+void ResultSink::write(const BenchResult& result) {
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    
+    switch (format) {
+        case ResultFormat::Text:
+            out << std::left << std::setw(28) << result.name
+                << std::setw(16) << result.policy
+                << std::right << std::setw(8) << result.threads
+                << std::fixed << std::setprecision(2)
+                << std::setw(14) << result.median_ns
+                << std::setw(14) << result.p99_ns
+                << std::setprecision(1) << std::setw(8) << result.cv * 100.0
+                << std::setprecision(0) << std::setw(16) << result.throughput;
+            if (result.slowest_share >= 0.0) {
+                out << "  slowest at " << std::setprecision(1) << result.slowest_share * 100.0 << "%";
+            }
+            out << std::endl;
+            break;
+        case ResultFormat::Json:
+            out << (written == 0 ? "\n" : ",\n") << std::setprecision(10)
+                << "  {\"name\": \"" << json_escape(result.name) << "\""
+                << ", \"policy\": \"" << json_escape(result.policy) << "\""
+                << ", \"threads\": " << result.threads
+                << ", \"elements\": " << result.elements
+                << ", \"ns_per_op\": " << result.median_ns
+                << ", \"p99_ns_per_op\": " << result.p99_ns
+                << ", \"cv\": " << result.cv
+                << ", \"throughput\": " << result.throughput;
+            if (result.slowest_share >= 0.0) {
+                out << ", \"slowest_share\": " << result.slowest_share;
+            }
+            out << "}" << std::flush;
+            break;
+        case ResultFormat::Csv:
+            out << std::setprecision(10)
+                << csv_field(result.name) << "," << csv_field(result.policy) << ","
+                << result.threads << "," << result.elements << ","
+                << result.median_ns << "," << result.p99_ns << ","
+                << result.cv << "," << result.throughput << ",";
+            if (result.slowest_share >= 0.0) {
+                out << result.slowest_share;
+            }
+            out << std::endl;
+            break;
+    }
+    
+    out.flags(flags);
+    out.precision(precision);
+    written++;
+}
+
+void ResultSink::end() {
+    if (format == ResultFormat::Json) {
+        out << "\n]}" << std::endl;
+    }
+}
+
+// =================== READING ===================
+
+// Assign one named field of a record; unknown fields are ignored
+static void set_field(BenchResult& result, const std::string& key, const std::string& value) {
+    if (key == "name") {
+        result.name = value;
+    } else if (key == "policy") {
+        result.policy = value;
+    } else if (key == "threads") {
+        result.threads = std::atoi(value.c_str());
+    } else if (key == "elements") {
+        result.elements = static_cast<size_t>(std::strtoull(value.c_str(), nullptr, 10));
+    } else if (key == "ns_per_op") {
+        result.median_ns = std::atof(value.c_str());
+    } else if (key == "p99_ns_per_op") {
+        result.p99_ns = std::atof(value.c_str());
+    } else if (key == "cv") {
+        result.cv = std::atof(value.c_str());
+    } else if (key == "throughput") {
+        result.throughput = std::atof(value.c_str());
+    } else if (key == "slowest_share" && !value.empty()) {
+        result.slowest_share = std::atof(value.c_str());
+    }
+}
+
+// Reader for the JSON written by ResultSink: an object holding an array of
+// flat objects whose values are strings or numbers
+class JsonResultReader {
+private:
+    const std::string& text;
+    size_t pos = 0;
+    
+    void skip_space() {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+            pos++;
+        }
+    }
+    
+    bool consume(char c) {
+        skip_space();
+        if (pos < text.size() && text[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+    
+    bool read_string(std::string& value) {
+        if (!consume('"')) {
+            return false;
+        }
+        value.clear();
+        while (pos < text.size() && text[pos] != '"') {
+            if (text[pos] == '\\' && pos + 1 < text.size()) {
+                pos++;
+            }
+            value += text[pos++];
+        }
+        return consume('"');
+    }
+    
+    // Strings, numbers and bare words (true/false/null) are all kept as text
+    bool read_value(std::string& value) {
+        skip_space();
+        if (pos < text.size() && text[pos] == '"') {
+            return read_string(value);
+        }
+        size_t start = pos;
+        while (pos < text.size() && text[pos] != ',' && text[pos] != '}' &&
+               !std::isspace(static_cast<unsigned char>(text[pos]))) {
+            pos++;
+        }
+        value = text.substr(start, pos - start);
+        return !value.empty();
+    }
+
+public:
+    explicit JsonResultReader(const std::string& text) : text(text) {}
+    
+    bool read(std::vector<BenchResult>& results, std::string& error) {
+        size_t key = text.find("\"benchmarks\"");
+        if (key == std::string::npos) {
+            error = "no \"benchmarks\" array";
+            return false;
+        }
+        pos = key + 12;
+        if (!consume(':') || !consume('[')) {
+            error = "malformed \"benchmarks\" array";
+            return false;
+        }
+        if (consume(']')) {
+            return true;
+        }
+        
+        do {
+            if (!consume('{')) {
+                error = "expected '{' at offset " + std::to_string(pos);
+                return false;
+            }
+            BenchResult result;
+            if (!consume('}')) {
+                do {
+                    std::string name;
+                    std::string value;
+                    if (!read_string(name) || !consume(':') || !read_value(value)) {
+                        error = "malformed record at offset " + std::to_string(pos);
+                        return false;
+                    }
+                    set_field(result, name, value);
+                } while (consume(','));
+                if (!consume('}')) {
+                    error = "expected '}' at offset " + std::to_string(pos);
+                    return false;
+                }
+            }
+            results.push_back(result);
+        } while (consume(','));
+        
+        if (!consume(']')) {
+            error = "expected ']' at offset " + std::to_string(pos);
+            return false;
+        }
+        return true;
+    }
+};
+
+// Split one CSV line, honouring double-quoted fields
+static std::vector<std::string> split_csv_line(const std::string& line) {
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                fields.back() += '"';
+                i++;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                fields.back() += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.emplace_back();
+        } else if (c != '\r') {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+static bool read_csv(const std::string& text, std::vector<BenchResult>& results, std::string& error) {
+    std::istringstream in(text);
+    std::string line;
+    if (!std::getline(in, line)) {
+        error = "empty file";
+        return false;
+    }
+    std::vector<std::string> header = split_csv_line(line);
+    
+    while (std::getline(in, line)) {
+        if (line.empty() || line == "\r") {
+            continue;
+        }
+        std::vector<std::string> fields = split_csv_line(line);
+        if (fields.size() != header.size()) {
+            error = "record has " + std::to_string(fields.size()) + " fields, header has " +
+                    std::to_string(header.size());
+            return false;
+        }
+        BenchResult result;
+        for (size_t i = 0; i < fields.size(); ++i) {
+            set_field(result, header[i], fields[i]);
+        }
+        results.push_back(result);
+    }
+    return true;
+}
+
+bool read_results(const std::string& path, std::vector<BenchResult>& results, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+    
+    size_t first = text.find_first_not_of(" \t\r\n");
+    if (first != std::string::npos && text[first] == '{') {
+        return JsonResultReader(text).read(results, error);
+    }
+    return read_csv(text, results, error);
+}
+
+// =================== COMPARISON ===================
+
+int compare_results(const std::vector<BenchResult>& baseline, const std::vector<BenchResult>& current,
+                    double threshold_percent, std::ostream& out) {
+    // Runs are matched on benchmark, policy and thread count; ns/op is already
+    // normalized, so a different --ops or --size still compares
+    typedef std::tuple<std::string, std::string, int> Key;
+    std::map<Key, const BenchResult*> base_by_key;
+    for (const auto& result : baseline) {
+        base_by_key[Key(result.name, result.policy, result.threads)] = &result;
+    }
+    
+    out << std::left << std::setw(28) << "Benchmark"
+        << std::setw(16) << "Policy"
+        << std::right << std::setw(8) << "Threads"
+        << std::setw(14) << "Base ns/op"
+        << std::setw(14) << "New ns/op"
+        << std::setw(10) << "Change"
+        << "  Status" << std::endl;
+    
+    int regressions = 0;
+    for (const auto& result : current) {
+        auto it = base_by_key.find(Key(result.name, result.policy, result.threads));
+        out << std::left << std::setw(28) << result.name
+            << std::setw(16) << result.policy
+            << std::right << std::setw(8) << result.threads
+            << std::fixed << std::setprecision(2);
+        
+        if (it == base_by_key.end()) {
+            out << std::setw(14) << "-" << std::setw(14) << result.median_ns
+                << std::setw(10) << "-" << "  new" << std::endl;
+            continue;
+        }
+        
+        const BenchResult& base = *it->second;
+        double change = base.median_ns > 0.0
+            ? (result.median_ns - base.median_ns) / base.median_ns * 100.0
+            : 0.0;
+        bool regressed = change > threshold_percent;
+        
+        // Fairness is compared in percentage points of the slowest thread's share
+        std::ostringstream share_text;
+        if (base.slowest_share >= 0.0 && result.slowest_share >= 0.0) {
+            double drop = (base.slowest_share - result.slowest_share) * 100.0;
+            regressed = regressed || drop > threshold_percent;
+            share_text << std::fixed << std::setprecision(1) << "  (slowest at " << base.slowest_share * 100.0
+                       << "% -> " << result.slowest_share * 100.0 << "%)";
+        }
+        const char* status = "";
+        if (regressed) {
+            status = "REGRESSION";
+            regressions++;
+        } else if (change < -threshold_percent) {
+            status = "improved";
+        }
+        
+        std::ostringstream change_text;
+        change_text << std::showpos << std::fixed << std::setprecision(1) << change << "%";
+        out << std::setw(14) << base.median_ns << std::setw(14) << result.median_ns
+            << std::setw(10) << change_text.str() << "  " << status << share_text.str() << std::endl;
+        base_by_key.erase(it);
+    }
+    
+    for (const auto& entry : base_by_key) {
+        const BenchResult& base = *entry.second;
+        out << std::left << std::setw(28) << base.name
+            << std::setw(16) << base.policy
+            << std::right << std::setw(8) << base.threads
+            << std::setw(14) << base.median_ns << std::setw(14) << "-"
+            << std::setw(10) << "-" << "  missing" << std::endl;
+    }
+    
+    out << std::defaultfloat << "\n" << regressions << " regression(s) beyond "
+        << threshold_percent << "% (compared median ns/op, and slowest share in points)" << std::endl;
+    return regressions;
+}
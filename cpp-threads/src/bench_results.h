@@ -0,0 +1,74 @@
+/**
+ * @file bench_results.h
+ * @brief Benchmark result records, their text/JSON/CSV output and regression comparison
+ *
+ * Results are written as they are produced, so an interrupted run still
+ * leaves every finished record behind. Files written in JSON or CSV can be
+ * read back and compared against each other to flag regressions.
+ */
+
+#ifndef BENCH_RESULTS_H
+#define BENCH_RESULTS_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Summary of one benchmark configuration
+struct BenchResult {
+    std::string name;                // Benchmark, e.g. "lock/increment"
+    std::string policy;              // Variant: lock type, memory order or execution policy
+    int threads = 1;                 // Threads taking part in the run
+    size_t elements = 0;             // Operations or elements processed per run
+    double median_ns = 0.0;          // Median nanoseconds per operation
+    double p99_ns = 0.0;             // 99th percentile nanoseconds per operation
+    double cv = 0.0;                 // Standard deviation / mean of the samples
+    double throughput = 0.0;         // Operations per second at the median
+    double slowest_share = -1.0;     // lock/fair: share of its operations the slowest thread had
+                                     // done when the first finished; negative when not measured
+};
+
+// Median, p99 and coefficient of variation of ns/op samples from repeated runs
+BenchResult summarize_samples(const std::string& name, const std::string& policy, int threads,
+                              size_t elements, std::vector<double> samples);
+
+enum class ResultFormat {
+    Text,                            // Aligned table for people
+    Json,                            // {"benchmarks": [ {...}, ... ]}
+    Csv                              // Header line, then one record per line
+};
+
+// Parse "text", "json" or "csv"; false for anything else
+bool parse_result_format(const std::string& text, ResultFormat& format);
+
+// Streams results to an output in one format
+class ResultSink {
+public:
+    ResultSink(ResultFormat format, std::ostream& out);
+    ~ResultSink();
+    
+    ResultSink(const ResultSink&) = delete;
+    ResultSink& operator=(const ResultSink&) = delete;
+    
+    void write(const BenchResult& result);
+
+private:
+    void begin();
+    void end();
+    
+    ResultFormat format;
+    std::ostream& out;
+    size_t written = 0;
+};
+
+// Read a JSON or CSV file written by ResultSink (the format is detected from the content)
+bool read_results(const std::string& path, std::vector<BenchResult>& results, std::string& error);
+
+// Print a baseline/current comparison and return the number of benchmarks whose
+// median ns/op grew by more than threshold_percent, or whose slowest thread's
+// share fell by more than threshold_percent points
+int compare_results(const std::vector<BenchResult>& baseline, const std::vector<BenchResult>& current,
+                    double threshold_percent, std::ostream& out);
+
+#endif // BENCH_RESULTS_H
@@ -0,0 +1,76 @@
+/**
+ * @file big_reader_lock.cpp
+ * @brief Writer side of BigReaderLock
+ */
+
+#include "big_reader_lock.h"
+
+#include <algorithm>
+#include <thread>
+
+BigReaderLock::BigReaderLock(RwPreference preference, ShardSelect select, size_t slots)
+    : select(select), reader_limit(preference == RwPreference::Writer ? WRITER_NONE : WRITER_WAITING) {
+    if (slots == 0) {
+        slots = std::max(1u, std::thread::hardware_concurrency());
+    }
+    
+    // A power of two turns the slot lookup into a mask
+    size_t rounded = 1;
+    while (rounded < slots) {
+        rounded *= 2;
+    }
+    readers.reset(new ReaderSlot[rounded]);
+    slot_mask = rounded - 1;
+}
+
+bool BigReaderLock::no_readers() const {
+    // Per-CPU slots may go negative when a reader unlocks on another CPU, so only the sum counts
+    long sum = 0;
+    for (size_t i = 0; i <= slot_mask; ++i) {
+        sum += readers[i].count.load(std::memory_order_seq_cst);
+    }
+    return sum == 0;
+}
+
+void BigReaderLock::wait_for_writer() const {
+    while (writer_state.load(std::memory_order_relaxed) > reader_limit) {
+        std::this_thread::yield();
+    }
+}
+
+void BigReaderLock::lock() {
+    writer_mutex.lock();
+    writer_state.store(WRITER_WAITING, std::memory_order_seq_cst);
+    
+    for (;;) {
+        while (!no_readers()) {
+            std::this_thread::yield();
+        }
+        
+        // Readers that saw WRITER_WAITING may have entered (reader preference); once the state
+        // is ACTIVE no new reader gets in, so a second empty sweep is final
+        writer_state.store(WRITER_ACTIVE, std::memory_order_seq_cst);
+        if (no_readers()) {
+            return;
+        }
+        writer_state.store(WRITER_WAITING, std::memory_order_seq_cst);
+    }
+}
+
+bool BigReaderLock::try_lock() {
+    if (!writer_mutex.try_lock()) {
+        return false;
+    }
+    writer_state.store(WRITER_ACTIVE, std::memory_order_seq_cst);
+    if (no_readers()) {
+        return true;
+    }
+    writer_state.store(WRITER_NONE, std::memory_order_release);
+    writer_mutex.unlock();
+    return false;
+}
+
+void BigReaderLock::unlock() {
+    writer_state.store(WRITER_NONE, std::memory_order_release);
+    writer_mutex.unlock();
+}
@@ -0,0 +1,100 @@
+/**
+ * @file big_reader_lock.h
+ * @brief Distributed reader-writer lock with one reader slot per thread or per CPU
+ *
+ * std::shared_mutex keeps a single reader count, so every shared_lock()
+ * writes the same cache line and read throughput stops growing with the
+ * number of cores. BigReaderLock gives each thread (or CPU) a padded slot
+ * of its own: a reader increments its slot, checks that no writer is
+ * active and proceeds, touching no line another reader writes. A writer
+ * raises the writer flag and then waits until the slots add up to zero,
+ * so writing gets more expensive with every slot.
+ *
+ * With RwPreference::Writer (the default), readers that arrive while a
+ * writer is waiting step back, so a steady stream of readers cannot starve
+ * the writer. With RwPreference::Reader they only step back for a writer
+ * that already holds the lock.
+ *
+ * Satisfies SharedLockable, so it works with std::unique_lock and
+ * std::shared_lock.
+ */
+
+#ifndef BIG_READER_LOCK_H
+#define BIG_READER_LOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include "counters.h"
+
+// Who goes first when readers and a writer are waiting
+enum class RwPreference {
+    Reader,                          // New readers may overtake a waiting writer
+    Writer                           // New readers wait behind a waiting writer
+};
+
+class BigReaderLock {
+public:
+    // slots == 0 picks the next power of two >= the hardware thread count
+    explicit BigReaderLock(RwPreference preference = RwPreference::Writer,
+                           ShardSelect select = ShardSelect::Thread, size_t slots = 0);
+    
+    BigReaderLock(const BigReaderLock&) = delete;
+    BigReaderLock& operator=(const BigReaderLock&) = delete;
+    
+    void lock_shared() {
+        while (!try_lock_shared()) {
+            wait_for_writer();
+        }
+    }
+    
+    bool try_lock_shared() {
+        std::atomic<long>& slot = readers[shard_slot(select) & slot_mask].count;
+        slot.fetch_add(1, std::memory_order_seq_cst);
+        if (writer_state.load(std::memory_order_seq_cst) <= reader_limit) {
+            return true;
+        }
+        
+        // A writer is in the way: undo on the same slot, so a writer's sum never misses this reader
+        slot.fetch_sub(1, std::memory_order_release);
+        return false;
+    }
+    
+    // The slots are summed by the writer, so unlocking may use another slot than locking
+    // (the thread may have moved to another CPU in the meantime)
+    void unlock_shared() {
+        readers[shard_slot(select) & slot_mask].count.fetch_sub(1, std::memory_order_release);
+    }
+    
+    void lock();
+    bool try_lock();
+    void unlock();
+    
+    size_t slots() const { return slot_mask + 1; }
+
+private:
+    // Writer states; readers step back when the state is above reader_limit
+    static const int WRITER_NONE = 0;
+    static const int WRITER_WAITING = 1;
+    static const int WRITER_ACTIVE = 2;
+    
+    struct alignas(64) ReaderSlot {
+        std::atomic<long> count{0};
+    };
+    
+    // True when no reader holds the lock
+    bool no_readers() const;
+    
+    void wait_for_writer() const;
+    
+    std::unique_ptr<ReaderSlot[]> readers;
+    size_t slot_mask;
+    ShardSelect select;
+    int reader_limit;
+    
+    alignas(64) std::atomic<int> writer_state{WRITER_NONE};
+    std::mutex writer_mutex;             // One writer at a time
+};
+
+#endif // BIG_READER_LOCK_H
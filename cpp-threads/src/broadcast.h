@@ -0,0 +1,183 @@
+/**
+ * @file broadcast.h
+ * @brief One-shot broadcast of a value to many waiters without a thread per waiter
+ *
+ * std::shared_future hands one value to many consumers, but each consumer
+ * is a thread parked in get(). A Broadcast<T> keeps its waiters in an
+ * intrusive lock-free list instead: on_set() registers a callback, and in
+ * CPPTHREADS_COROUTINES builds a coroutine can co_await wait() or
+ * wait(pool). set_value() detaches the whole list with one exchange and
+ * notifies every waiter in a single pass: callbacks and wait() coroutines
+ * run on the setting thread, and wait(pool) coroutines go to the pool in one
+ * submit_batch(). A waiter that arrives after the value is set runs at once.
+ *
+ * Registering a callback allocates its node; a coroutine's node lives in
+ * its frame. The value is set once and is read-only afterwards. A callback
+ * that throws does not stop the pass: every other waiter is still notified,
+ * and set_value() rethrows the first exception at the end.
+ */
+
+#ifndef BROADCAST_H
+#define BROADCAST_H
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "task_pool.h"
+
+#ifdef CPPTHREADS_COROUTINES
+#include <coroutine>
+#endif
+
+template <typename T>
+class Broadcast {
+    // One registered waiter; notify() runs or queues it and may free the node
+    struct Waiter {
+        Waiter* next = nullptr;
+        void (*notify)(Waiter* self, Broadcast& broadcast, std::vector<std::function<void()>>& resumes) = nullptr;
+        TaskPool* pool = nullptr;        // Set for waiters resumed on a pool
+    };
+    
+    struct CallbackWaiter : Waiter {
+        std::function<void(const T&)> callback;
+    };
+
+public:
+    Broadcast() = default;
+    
+    Broadcast(const Broadcast&) = delete;
+    Broadcast& operator=(const Broadcast&) = delete;
+    
+    bool is_set() const { return head.load(std::memory_order_acquire) == set_marker(); }
+    
+    // Only valid once is_set() is true
+    const T& value() const { return *stored; }
+    
+    // Store the value and notify every waiter registered so far, in registration order;
+    // rethrows the first exception a waiter threw once all of them have been notified
+    void set_value(T result) {
+        if (setting.exchange(true, std::memory_order_relaxed)) {
+            throw std::future_error(std::future_errc::promise_already_satisfied);
+        }
+        stored.emplace(std::move(result));
+        Waiter* waiters = head.exchange(set_marker(), std::memory_order_acq_rel);
+        
+        // The list is newest first; reverse it so waiters hear in the order they came
+        Waiter* ordered = nullptr;
+        while (waiters != nullptr) {
+            Waiter* next = waiters->next;
+            waiters->next = ordered;
+            ordered = waiters;
+            waiters = next;
+        }
+        
+        // Coroutines bound for a pool are collected and submitted together
+        std::vector<std::function<void()>> resumes;
+        TaskPool* pool = nullptr;
+        std::exception_ptr error;
+        while (ordered != nullptr) {
+            Waiter* next = ordered->next;
+            if (ordered->pool != nullptr && pool != nullptr && ordered->pool != pool) {
+                pool->submit_batch(std::move(resumes));
+                resumes.clear();
+            }
+            if (ordered->pool != nullptr) {
+                pool = ordered->pool;
+            }
+            try {
+                ordered->notify(ordered, *this, resumes);
+            } catch (...) {
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            ordered = next;
+        }
+        if (pool != nullptr) {
+            pool->submit_batch(std::move(resumes));
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    
+    // Call callback(value) on the thread that sets the value, or now if it is set
+    void on_set(std::function<void(const T&)> callback) {
+        auto waiter = std::make_unique<CallbackWaiter>();
+        waiter->callback = std::move(callback);
+        waiter->notify = [](Waiter* self, Broadcast& broadcast, std::vector<std::function<void()>>&) {
+            // Owned here, so the node is freed even if the callback throws
+            std::unique_ptr<CallbackWaiter> callback_waiter(static_cast<CallbackWaiter*>(self));
+            callback_waiter->callback(broadcast.value());
+        };
+        if (push(waiter.get())) {
+            waiter.release();
+        } else {
+            waiter->callback(value());
+        }
+    }
+
+#ifdef CPPTHREADS_COROUTINES
+    // co_await: suspend until the value is set; resumed on the setting thread,
+    // or on a worker of pool when one is given
+    auto wait(TaskPool* pool = nullptr) {
+        struct Awaiter : Waiter {
+            Broadcast& broadcast;
+            std::coroutine_handle<> coroutine;
+            
+            Awaiter(Broadcast& broadcast, TaskPool* pool) : broadcast(broadcast) {
+                this->pool = pool;
+                this->notify = [](Waiter* self, Broadcast&, std::vector<std::function<void()>>& resumes) {
+                    auto* awaiter = static_cast<Awaiter*>(self);
+                    if (awaiter->pool != nullptr) {
+                        std::coroutine_handle<> coroutine = awaiter->coroutine;
+                        resumes.push_back([coroutine]() { coroutine.resume(); });
+                    } else {
+                        awaiter->coroutine.resume();
+                    }
+                };
+            }
+            
+            bool await_ready() const { return broadcast.is_set(); }
+            
+            bool await_suspend(std::coroutine_handle<> waiting) {
+                coroutine = waiting;
+                return broadcast.push(this);
+            }
+            
+            const T& await_resume() const { return broadcast.value(); }
+        };
+        return Awaiter(*this, pool);
+    }
+    
+    auto wait(TaskPool& pool) { return wait(&pool); }
+#endif
+
+private:
+    // A node address that is never a waiter: head holds it once the value is set
+    Waiter* set_marker() const { return const_cast<Waiter*>(&marker); }
+    
+    // Add waiter to the list; false when the value was set first
+    bool push(Waiter* waiter) {
+        Waiter* first = head.load(std::memory_order_acquire);
+        do {
+            if (first == set_marker()) {
+                return false;
+            }
+            waiter->next = first;
+        } while (!head.compare_exchange_weak(first, waiter, std::memory_order_release, std::memory_order_acquire));
+        return true;
+    }
+    
+    std::atomic<Waiter*> head{nullptr};
+    std::atomic<bool> setting{false};
+    std::optional<T> stored;
+    Waiter marker;
+};
+
+#endif // BROADCAST_H
@@ -0,0 +1,149 @@
+/**
+ * @file broadcast_bench.cpp
+ * @brief Fulfil-to-all-notified latency of a one-shot value with 1000 waiters
+ *
+ * Each sample registers BROADCAST_BENCH_WAITERS waiters, sets the value and
+ * times from the set until the last waiter has run; ns/op is that whole
+ * fan-out, not a per-waiter share.
+ *
+ * - shared_future:  a thread per waiter blocked in std::shared_future::get()
+ * - callback:       Broadcast::on_set() callbacks, run by the setting thread
+ * - coroutine:      coroutines in co_await wait(), resumed by the setting thread
+ * - coroutine_pool: coroutines in co_await wait(pool), resumed by the pool's
+ *                   workers after one batch submission (CPPTHREADS_COROUTINES
+ *                   builds only, like coroutine)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_harness.h"
+#include "broadcast.h"
+#include "task_pool.h"
+
+#ifdef CPPTHREADS_COROUTINES
+#include "coro_task.h"
+#endif
+
+// Waiters per broadcast
+static const size_t BROADCAST_BENCH_WAITERS = 1000;
+
+// How long a coroutine fan-out may take before its missing waiters count as lost
+static const std::chrono::seconds BROADCAST_BENCH_TIMEOUT(10);
+
+// Fail the run when a fan-out did not reach every waiter
+static void check_notified(BenchHarness& harness, const std::string& policy, size_t notified) {
+    if (notified != BROADCAST_BENCH_WAITERS) {
+        harness.report_failure("broadcast/notify_all " + policy + ": " + std::to_string(notified) + " of " +
+                               std::to_string(BROADCAST_BENCH_WAITERS) + " waiters notified");
+    }
+}
+
+static uint64_t shared_future_fanout(BenchHarness& harness) {
+    std::promise<int> promise;
+    std::shared_future<int> value = promise.get_future().share();
+    std::vector<uint64_t> woken(BROADCAST_BENCH_WAITERS, 0);
+    std::atomic<size_t> started{0};
+    std::vector<std::thread> threads;
+    threads.reserve(BROADCAST_BENCH_WAITERS);
+    for (size_t i = 0; i < BROADCAST_BENCH_WAITERS; ++i) {
+        threads.emplace_back([&, i]() {
+            started.fetch_add(1, std::memory_order_relaxed);
+            do_not_optimize(value.get());
+            woken[i] = bench_now_ns();
+        });
+    }
+    
+    // Let every thread reach get() before the value is set
+    while (started.load(std::memory_order_relaxed) < BROADCAST_BENCH_WAITERS) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    
+    uint64_t start = bench_now_ns();
+    promise.set_value(1);
+    size_t notified = 0;
+    uint64_t last = start;
+    for (size_t i = 0; i < BROADCAST_BENCH_WAITERS; ++i) {
+        threads[i].join();
+        notified += woken[i] != 0 ? 1 : 0;
+        last = std::max(last, woken[i]);
+    }
+    check_notified(harness, "shared_future", notified);
+    return last - start;
+}
+
+static uint64_t callback_fanout(BenchHarness& harness) {
+    Broadcast<int> broadcast;
+    size_t notified = 0;
+    for (size_t i = 0; i < BROADCAST_BENCH_WAITERS; ++i) {
+        broadcast.on_set([&notified](const int& value) { notified += static_cast<size_t>(value); });
+    }
+    uint64_t start = bench_now_ns();
+    broadcast.set_value(1);
+    uint64_t elapsed = bench_now_ns() - start;
+    check_notified(harness, "callback", notified);
+    return elapsed;
+}
+
+#ifdef CPPTHREADS_COROUTINES
+// What the waiters of one coroutine fan-out share
+struct CoroutineFanout {
+    Broadcast<int> broadcast;
+    std::atomic<size_t> notified{0};
+    std::atomic<uint64_t> last{0};
+};
+
+// A waiter: suspends in the broadcast and counts itself when resumed; the last one
+// records the time
+static DetachedCoroutine await_broadcast(CoroutineFanout& fanout, TaskPool* pool) {
+    const int& value = co_await fanout.broadcast.wait(pool);
+    if (fanout.notified.fetch_add(static_cast<size_t>(value), std::memory_order_acq_rel) + 1 ==
+        BROADCAST_BENCH_WAITERS) {
+        fanout.last.store(bench_now_ns(), std::memory_order_release);
+    }
+}
+
+static uint64_t coroutine_fanout(BenchHarness& harness, TaskPool* pool, const std::string& policy) {
+    std::unique_ptr<CoroutineFanout> fanout(new CoroutineFanout());
+    for (size_t i = 0; i < BROADCAST_BENCH_WAITERS; ++i) {
+        await_broadcast(*fanout, pool);
+    }
+    uint64_t start = bench_now_ns();
+    fanout->broadcast.set_value(1);
+    auto deadline = std::chrono::steady_clock::now() + BROADCAST_BENCH_TIMEOUT;
+    while (fanout->last.load(std::memory_order_acquire) == 0) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            check_notified(harness, policy, fanout->notified.load(std::memory_order_relaxed));
+            // A late waiter may still resume, so its state is leaked rather than freed under it
+            fanout.release();
+            return bench_now_ns() - start;
+        }
+        std::this_thread::yield();
+    }
+    check_notified(harness, policy, fanout->notified.load(std::memory_order_relaxed));
+    return fanout->last.load(std::memory_order_relaxed) - start;
+}
+#endif
+
+void broadcast_bench(BenchHarness& harness) {
+    const std::string name = "broadcast/notify_all";
+    if (!harness.enabled(name)) {
+        return;
+    }
+    harness.run(name, "shared_future", 1, 1, [&harness]() { return shared_future_fanout(harness); });
+    harness.run(name, "callback", 1, 1, [&harness]() { return callback_fanout(harness); });
+#ifdef CPPTHREADS_COROUTINES
+    harness.run(name, "coroutine", 1, 1, [&harness]() { return coroutine_fanout(harness, nullptr, "coroutine"); });
+    TaskPool& pool = default_task_pool();
+    harness.run(name, "coroutine_pool", pool.size(), 1, [&harness, &pool]() {
+        return coroutine_fanout(harness, &pool, "coroutine_pool");
+    });
+#endif
+}
@@ -0,0 +1,355 @@
+/**
+ * @file continuable_future.h
+ * @brief Promise/Future pair whose continuations run when the value is set
+ *
+ * std::future has no then(), so chaining a step after a result has to park
+ * a thread in get() until the result arrives. Future<T>::then(f) instead
+ * stores f in the shared state; the thread that sets the value runs it
+ * (inline), or submits it to an executor such as a TaskPool, and nothing
+ * blocks in between. If the value was already there, then() runs or submits
+ * f right away. when_all() and when_any() combine futures the same way.
+ *
+ * An exception set on a promise, or thrown by a continuation, skips every
+ * later step of the chain and is rethrown by get() at its end. A Future is
+ * move-only and has one consumer: then(), get() and the combinators all
+ * consume it; on_ready() callbacks do not, and any number of them may be
+ * added before that. Continuations are stored in std::function, so they must
+ * be copyable, and they must return a value (void is not supported).
+ */
+
+#ifndef CONTINUABLE_FUTURE_H
+#define CONTINUABLE_FUTURE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Result and continuation shared by a Promise and its Future
+template <typename T>
+class FutureState {
+    static_assert(!std::is_void_v<T>, "continuations must return a value");
+
+public:
+    void set_value(T result) {
+        complete([&]() { value.emplace(std::move(result)); });
+    }
+    
+    void set_exception(std::exception_ptr exception) {
+        complete([&]() { error = exception; });
+    }
+    
+    // Run callback once the state is ready: now if it already is, otherwise on
+    // the thread that completes it. Several callbacks run in the order they came.
+    void on_ready(std::function<void()> callback) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!ready) {
+                if (!continuation) {
+                    continuation = std::move(callback);
+                } else {
+                    later_continuations.push_back(std::move(callback));
+                }
+                return;
+            }
+        }
+        callback();
+    }
+    
+    bool is_ready() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return ready;
+    }
+    
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        blocked = true;
+        ready_cv.wait(lock, [this]() { return ready; });
+    }
+    
+    // Only meaningful once the state is ready
+    std::exception_ptr exception() const { return error; }
+    T& result() { return *value; }
+
+private:
+    template <typename Store>
+    void complete(Store store) {
+        std::function<void()> callback;
+        std::vector<std::function<void()>> later;
+        bool wake = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ready) {
+                throw std::future_error(std::future_errc::promise_already_satisfied);
+            }
+            store();
+            ready = true;
+            wake = blocked;
+            callback = std::move(continuation);
+            later.swap(later_continuations);
+        }
+        if (wake) {
+            ready_cv.notify_all();
+        }
+        if (callback) {
+            callback();
+        }
+        for (auto& next : later) {
+            next();
+        }
+    }
+    
+    mutable std::mutex mutex;
+    std::condition_variable ready_cv;
+    bool ready = false;
+    bool blocked = false;                // A thread waits in wait(); only then is ready_cv notified
+    std::optional<T> value;
+    std::exception_ptr error;
+    std::function<void()> continuation;                      // First callback; the usual case allocates no vector
+    std::vector<std::function<void()>> later_continuations;  // Any further ones, in order
+};
+
+// Set target from func(args...), or from the exception it throws
+template <typename T, typename F, typename... Args>
+void fulfil_from(FutureState<T>& target, F& func, Args&&... args) {
+    std::optional<T> result;
+    try {
+        result.emplace(std::invoke(func, std::forward<Args>(args)...));
+    } catch (...) {
+        target.set_exception(std::current_exception());
+        return;
+    }
+    target.set_value(std::move(*result));
+}
+
+template <typename T>
+class Promise;
+
+template <typename T>
+class Future;
+
+// Which future of a when_any() finished first, and its value
+template <typename T>
+struct WhenAnyResult {
+    size_t index;
+    T value;
+};
+
+template <typename T>
+Future<std::vector<T>> when_all(std::vector<Future<T>> futures);
+
+template <typename T>
+Future<WhenAnyResult<T>> when_any(std::vector<Future<T>> futures);
+
+template <typename T>
+class Future {
+public:
+    Future() = default;
+    
+    // Adopt a state that an executor or combinator will complete
+    explicit Future(std::shared_ptr<FutureState<T>> state) : state(std::move(state)) {}
+    
+    // Move-only, like std::future: get() and then() move the value out of the state
+    Future(const Future&) = delete;
+    Future& operator=(const Future&) = delete;
+    Future(Future&&) noexcept = default;
+    Future& operator=(Future&&) noexcept = default;
+    
+    // False for a default-constructed future and after it has been consumed
+    bool valid() const { return state != nullptr; }
+    
+    bool is_ready() const { return state->is_ready(); }
+    
+    // Block until the value or exception is set
+    void wait() const { state->wait(); }
+    
+    // Call callback once the value or exception is set, without consuming the
+    // future; get() will then return at once
+    void on_ready(std::function<void()> callback) const {
+        std::shared_ptr<FutureState<T>> keep = state;
+        keep->on_ready(std::move(callback));
+    }
+    
+    // Block for the value, rethrowing the exception the chain ended with
+    T get() {
+        std::shared_ptr<FutureState<T>> taken = std::move(state);
+        taken->wait();
+        if (taken->exception()) {
+            std::rethrow_exception(taken->exception());
+        }
+        return std::move(taken->result());
+    }
+    
+    // Run func(value) on the thread that sets the value, or here if it is already set
+    template <typename F>
+    Future<std::invoke_result_t<F, T>> then(F func) {
+        return chain(std::move(func), [](std::function<void()> step) { step(); });
+    }
+    
+    // Submit func(value) to executor (anything with submit(std::function<void()>))
+    // once the value is set; the executor must outlive the chain
+    template <typename Executor, typename F>
+    Future<std::invoke_result_t<F, T>> then(Executor& executor, F func) {
+        return chain(std::move(func), [&executor](std::function<void()> step) {
+            executor.submit(std::move(step));
+        });
+    }
+
+private:
+    template <typename F, typename Dispatch>
+    Future<std::invoke_result_t<F, T>> chain(F func, Dispatch dispatch) {
+        using U = std::invoke_result_t<F, T>;
+        std::shared_ptr<FutureState<T>> source = std::move(state);
+        auto target = std::make_shared<FutureState<U>>();
+        
+        // The stored callback owns source until it runs, which breaks the cycle
+        source->on_ready([source, target, func = std::move(func), dispatch]() {
+            if (source->exception()) {
+                target->set_exception(source->exception());
+                return;
+            }
+            dispatch([source, target, func]() mutable {
+                fulfil_from(*target, func, std::move(source->result()));
+            });
+        });
+        return Future<U>(target);
+    }
+    
+    template <typename U>
+    friend Future<std::vector<U>> when_all(std::vector<Future<U>> futures);
+    template <typename U>
+    friend Future<WhenAnyResult<U>> when_any(std::vector<Future<U>> futures);
+    
+    std::shared_ptr<FutureState<T>> state;
+};
+
+template <typename T>
+class Promise {
+public:
+    Promise() : state(std::make_shared<FutureState<T>>()) {}
+    
+    // A promise destroyed unfulfilled completes its future with broken_promise
+    ~Promise() { abandon(); }
+    
+    Promise(Promise&& other) noexcept = default;
+    Promise& operator=(Promise&& other) noexcept {
+        abandon();
+        state = std::move(other.state);
+        retrieved = other.retrieved;
+        return *this;
+    }
+    
+    Promise(const Promise&) = delete;
+    Promise& operator=(const Promise&) = delete;
+    
+    Future<T> get_future() {
+        if (retrieved) {
+            throw std::future_error(std::future_errc::future_already_retrieved);
+        }
+        retrieved = true;
+        return Future<T>(state);
+    }
+    
+    // Completes the future; continuations attached inline run on this thread before it returns
+    void set_value(T value) { state->set_value(std::move(value)); }
+    void set_exception(std::exception_ptr exception) { state->set_exception(exception); }
+
+private:
+    void abandon() noexcept {
+        if (state && !state->is_ready()) {
+            state->set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+        }
+    }
+    
+    std::shared_ptr<FutureState<T>> state;
+    bool retrieved = false;
+};
+
+template <typename T>
+Future<std::decay_t<T>> make_ready_future(T&& value) {
+    Promise<std::decay_t<T>> promise;
+    Future<std::decay_t<T>> future = promise.get_future();
+    promise.set_value(std::forward<T>(value));
+    return future;
+}
+
+// Ready with every value, in input order, once all futures are; the first
+// exception completes it early and the other results are discarded
+template <typename T>
+Future<std::vector<T>> when_all(std::vector<Future<T>> futures) {
+    struct Gather {
+        std::vector<std::optional<T>> values;
+        std::atomic<size_t> remaining;
+        std::atomic<bool> failed{false};
+    };
+    
+    auto target = std::make_shared<FutureState<std::vector<T>>>();
+    if (futures.empty()) {
+        target->set_value(std::vector<T>());
+        return Future<std::vector<T>>(target);
+    }
+    
+    auto gather = std::make_shared<Gather>();
+    gather->values.resize(futures.size());
+    gather->remaining.store(futures.size(), std::memory_order_relaxed);
+    for (size_t i = 0; i < futures.size(); ++i) {
+        std::shared_ptr<FutureState<T>> source = std::move(futures[i].state);
+        source->on_ready([source, gather, target, i]() {
+            if (source->exception()) {
+                if (!gather->failed.exchange(true)) {
+                    target->set_exception(source->exception());
+                }
+            } else {
+                gather->values[i].emplace(std::move(source->result()));
+            }
+            
+            // The last input to finish sees every value stored before its decrement
+            if (gather->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1 &&
+                !gather->failed.load(std::memory_order_relaxed)) {
+                std::vector<T> results;
+                results.reserve(gather->values.size());
+                for (auto& value : gather->values) {
+                    results.push_back(std::move(*value));
+                }
+                target->set_value(std::move(results));
+            }
+        });
+    }
+    return Future<std::vector<T>>(target);
+}
+
+// Ready with the first future to finish, value or exception; later results are discarded
+template <typename T>
+Future<WhenAnyResult<T>> when_any(std::vector<Future<T>> futures) {
+    if (futures.empty()) {
+        throw std::invalid_argument("when_any needs at least one future");
+    }
+    
+    auto target = std::make_shared<FutureState<WhenAnyResult<T>>>();
+    auto decided = std::make_shared<std::atomic<bool>>(false);
+    for (size_t i = 0; i < futures.size(); ++i) {
+        std::shared_ptr<FutureState<T>> source = std::move(futures[i].state);
+        source->on_ready([source, decided, target, i]() {
+            if (decided->exchange(true)) {
+                return;
+            }
+            if (source->exception()) {
+                target->set_exception(source->exception());
+            } else {
+                target->set_value(WhenAnyResult<T>{ i, std::move(source->result()) });
+            }
+        });
+    }
+    return Future<WhenAnyResult<T>>(target);
+}
+
+#endif // CONTINUABLE_FUTURE_H
@@ -0,0 +1,99 @@
+/**
+ * @file coro_channel.h
+ * @brief Unbounded multi-producer channel that coroutines receive from without blocking
+ *
+ * send() never suspends: it hands the value straight to a receiver that
+ * is waiting, which the scheduler then resumes on a worker, or appends it to
+ * the buffer. co_await receive() takes the oldest buffered value or
+ * suspends until one is sent. After close(), receivers get the values that
+ * are left and then std::nullopt.
+ */
+
+#ifndef CORO_CHANNEL_H
+#define CORO_CHANNEL_H
+
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include "coro_scheduler.h"
+
+template <typename T>
+class Channel {
+    // A suspended receiver; it lives in the receiving coroutine's frame
+    struct ReceiveAwaiter {
+        Channel& channel;
+        std::optional<T> value;
+        std::coroutine_handle<> coroutine;
+        
+        bool await_ready() noexcept { return false; }
+        
+        bool await_suspend(std::coroutine_handle<> receiver) {
+            std::lock_guard<std::mutex> lock(channel.mutex);
+            if (!channel.buffer.empty()) {
+                value.emplace(std::move(channel.buffer.front()));
+                channel.buffer.pop_front();
+                return false;
+            }
+            if (channel.closed) {
+                return false;
+            }
+            coroutine = receiver;
+            channel.receivers.push_back(this);
+            return true;
+        }
+        
+        std::optional<T> await_resume() { return std::move(value); }
+    };
+
+public:
+    explicit Channel(CoroScheduler& scheduler) : scheduler(scheduler) {}
+    
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+    
+    void send(T value) {
+        std::coroutine_handle<> receiver;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (closed) {
+                throw std::logic_error("send on a closed channel");
+            }
+            if (receivers.empty()) {
+                buffer.push_back(std::move(value));
+                return;
+            }
+            receivers.front()->value.emplace(std::move(value));
+            receiver = receivers.front()->coroutine;
+            receivers.pop_front();
+        }
+        scheduler.resume_later(receiver);
+    }
+    
+    // Wake every waiting receiver with std::nullopt; later sends throw
+    void close() {
+        std::deque<ReceiveAwaiter*> waiting;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+            std::swap(waiting, receivers);
+        }
+        for (ReceiveAwaiter* receiver : waiting) {
+            scheduler.resume_later(receiver->coroutine);
+        }
+    }
+    
+    // co_await: the next value, or std::nullopt once the channel is closed and empty
+    ReceiveAwaiter receive() { return ReceiveAwaiter{ *this, std::nullopt, nullptr }; }
+
+private:
+    CoroScheduler& scheduler;
+    std::mutex mutex;
+    std::deque<T> buffer;
+    std::deque<ReceiveAwaiter*> receivers;
+    bool closed = false;
+};
+
+#endif // CORO_CHANNEL_H
@@ -0,0 +1,67 @@
+/**
+ * @file coro_scheduler.cpp
+ * @brief Timer thread of CoroScheduler
+ */
+
+#include "coro_scheduler.h"
+
+#include "trace.h"
+
+CoroScheduler::CoroScheduler(TaskPool& pool) : workers(pool) {
+    timer_thread = std::thread([this]() {
+        trace_thread_name("coroutine timers");
+        timer_loop();
+    });
+}
+
+CoroScheduler::~CoroScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(timer_mutex);
+        stopping = true;
+    }
+    timer_cv.notify_one();
+    timer_thread.join();
+}
+
+void CoroScheduler::resume_at(Clock::time_point deadline, std::coroutine_handle<> coroutine) {
+    bool earliest;
+    {
+        std::lock_guard<std::mutex> lock(timer_mutex);
+        earliest = timers.empty() || deadline < timers.top().deadline;
+        timers.push(Timer{ deadline, coroutine });
+    }
+    
+    // Only a new earliest deadline changes how long the timer thread sleeps
+    if (earliest) {
+        timer_cv.notify_one();
+    }
+}
+
+void CoroScheduler::timer_loop() {
+    std::vector<std::coroutine_handle<>> due;
+    std::unique_lock<std::mutex> lock(timer_mutex);
+    while (!stopping) {
+        if (timers.empty()) {
+            timer_cv.wait(lock);
+            continue;
+        }
+        
+        // A copy: wait_until keeps a reference, and a push while it waits may move the heap
+        Clock::time_point next = timers.top().deadline;
+        if (timer_cv.wait_until(lock, next) == std::cv_status::no_timeout) {
+            continue;
+        }
+        
+        Clock::time_point now = Clock::now();
+        while (!timers.empty() && timers.top().deadline <= now) {
+            due.push_back(timers.top().coroutine);
+            timers.pop();
+        }
+        lock.unlock();
+        for (std::coroutine_handle<> coroutine : due) {
+            resume_later(coroutine);
+        }
+        due.clear();
+        lock.lock();
+    }
+}
@@ -0,0 +1,137 @@
+/**
+ * @file coro_scheduler.h
+ * @brief Resumes coroutines on a TaskPool: yielding, timers and futures
+ *
+ * Coroutines suspended in one of the awaitables below hold no thread. When
+ * the awaited event happens the coroutine is queued on the pool and a
+ * worker resumes it, so thousands of in-flight operations share the pool's
+ * few threads:
+ *
+ *     co_await scheduler.schedule();             // continue on a worker
+ *     co_await scheduler.sleep_for(500ms);       // timer, no thread sleeps
+ *     int v = co_await scheduler.when_ready(f);  // continuable Future<int>
+ *
+ * One timer thread keeps the pending deadlines in a heap. The scheduler and
+ * its pool must outlive every coroutine that uses them.
+ */
+
+#ifndef CORO_SCHEDULER_H
+#define CORO_SCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "continuable_future.h"
+#include "coro_task.h"
+#include "task_pool.h"
+
+class CoroScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    explicit CoroScheduler(TaskPool& pool);
+    ~CoroScheduler();
+    
+    CoroScheduler(const CoroScheduler&) = delete;
+    CoroScheduler& operator=(const CoroScheduler&) = delete;
+    
+    TaskPool& pool() { return workers; }
+    
+    // Queue a suspended coroutine for a worker
+    void resume_later(std::coroutine_handle<> coroutine) {
+        workers.submit([coroutine]() { coroutine.resume(); });
+    }
+    
+    // Queue it once deadline has passed
+    void resume_at(Clock::time_point deadline, std::coroutine_handle<> coroutine);
+    
+    // co_await: continue on a worker thread
+    auto schedule() {
+        struct Awaiter {
+            CoroScheduler& scheduler;
+            
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> coroutine) { scheduler.resume_later(coroutine); }
+            void await_resume() noexcept {}
+        };
+        return Awaiter{ *this };
+    }
+    
+    // co_await: continue on a worker once delay has passed
+    template <typename Rep, typename Period>
+    auto sleep_for(std::chrono::duration<Rep, Period> delay) {
+        struct Awaiter {
+            CoroScheduler& scheduler;
+            Clock::time_point deadline;
+            
+            bool await_ready() noexcept { return deadline <= Clock::now(); }
+            void await_suspend(std::coroutine_handle<> coroutine) { scheduler.resume_at(deadline, coroutine); }
+            void await_resume() noexcept {}
+        };
+        return Awaiter{ *this, Clock::now() + std::chrono::duration_cast<Clock::duration>(delay) };
+    }
+    
+    // co_await: the future's value on a worker, or its exception rethrown
+    template <typename T>
+    auto when_ready(Future<T> future) {
+        struct Awaiter {
+            CoroScheduler& scheduler;
+            Future<T> future;
+            
+            bool await_ready() { return future.is_ready(); }
+            void await_suspend(std::coroutine_handle<> coroutine) {
+                CoroScheduler* target = &scheduler;
+                future.on_ready([target, coroutine]() { target->resume_later(coroutine); });
+            }
+            T await_resume() { return future.get(); }
+        };
+        return Awaiter{ *this, std::move(future) };
+    }
+
+private:
+    struct Timer {
+        Clock::time_point deadline;
+        std::coroutine_handle<> coroutine;
+        
+        bool operator>(const Timer& other) const { return deadline > other.deadline; }
+    };
+    
+    void timer_loop();
+    
+    TaskPool& workers;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    std::mutex timer_mutex;
+    std::condition_variable timer_cv;
+    bool stopping = false;
+    std::thread timer_thread;
+};
+
+// Start task on a worker and return its result as a continuable future
+template <typename T>
+Future<T> spawn(CoroScheduler& scheduler, Task<T> task) {
+    Promise<T> promise;
+    Future<T> future = promise.get_future();
+    
+    // The task and promise move into the frame of a coroutine that frees itself
+    [](CoroScheduler& scheduler, Task<T> task, Promise<T> promise) -> DetachedCoroutine {
+        co_await scheduler.schedule();
+        std::optional<T> result;
+        try {
+            result.emplace(co_await std::move(task));
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+            co_return;
+        }
+        promise.set_value(std::move(*result));
+    }(scheduler, std::move(task), std::move(promise));
+    return future;
+}
+
+#endif // CORO_SCHEDULER_H
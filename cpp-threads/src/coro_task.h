@@ -0,0 +1,183 @@
+/**
+ * @file coro_task.h
+ * @brief Lazily started C++20 coroutine returning a T
+ *
+ * A function returning Task<T> is a coroutine that does not run until it is
+ * awaited. co_await on it starts it on the awaiting thread and resumes the
+ * awaiting coroutine when it finishes, with its co_return value or its
+ * exception; the hand-over is a symmetric transfer, so long chains of
+ * awaits do not grow the stack. spawn() (coro_scheduler.h) starts a Task<T>
+ * on a worker and returns a continuable Future<T> for code that is not a
+ * coroutine itself.
+ *
+ * A suspended task is only its heap frame: the locals that live across a
+ * co_await plus the promise. Frames are counted in coro_frame_bytes so the
+ * demos can report the memory per in-flight operation.
+ */
+
+#ifndef CORO_TASK_H
+#define CORO_TASK_H
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <optional>
+#include <utility>
+
+// Bytes of Task and DetachedCoroutine frames currently allocated
+inline std::atomic<size_t> coro_frame_bytes{0};
+
+template <typename T>
+class Task;
+
+// What every Task promise has: the awaiting coroutine, the exception and the frame accounting
+class TaskPromiseBase {
+public:
+    // Resumes the coroutine that awaited this task, if any
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> finished) noexcept {
+            std::coroutine_handle<> awaiting = finished.promise().continuation;
+            return awaiting ? awaiting : std::noop_coroutine();
+        }
+        
+        void await_resume() noexcept {}
+    };
+    
+    // Lazy: the body starts when the task is awaited
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+    
+    static void* operator new(size_t size) {
+        coro_frame_bytes.fetch_add(size, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+    
+    static void operator delete(void* frame, size_t size) {
+        coro_frame_bytes.fetch_sub(size, std::memory_order_relaxed);
+        ::operator delete(frame);
+    }
+    
+    std::coroutine_handle<> continuation;
+
+protected:
+    std::exception_ptr error;
+};
+
+template <typename T>
+class TaskPromise : public TaskPromiseBase {
+public:
+    Task<T> get_return_object();
+    void return_value(T result) { value.emplace(std::move(result)); }
+    
+    T take() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return std::move(*value);
+    }
+
+private:
+    std::optional<T> value;
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+    Task<void> get_return_object();
+    void return_void() {}
+    
+    void take() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+template <typename T = void>
+class Task {
+public:
+    using promise_type = TaskPromise<T>;
+    
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) {
+                handle.destroy();
+            }
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    
+    // A task that never ran, or ran to completion, is destroyed with its owner
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+    
+    // Run the task and resume the awaiting coroutine with its result
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+            
+            bool await_ready() noexcept { return false; }
+            
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+            
+            T await_resume() { return handle.promise().take(); }
+        };
+        return Awaiter{ handle };
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    
+    friend class TaskPromise<T>;
+    
+    std::coroutine_handle<promise_type> handle;
+};
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+// Coroutine that starts at once and frees itself when it finishes; spawn() runs tasks in one
+struct DetachedCoroutine {
+    struct promise_type {
+        DetachedCoroutine get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+        
+        static void* operator new(size_t size) {
+            coro_frame_bytes.fetch_add(size, std::memory_order_relaxed);
+            return ::operator new(size);
+        }
+        
+        static void operator delete(void* frame, size_t size) {
+            coro_frame_bytes.fetch_sub(size, std::memory_order_relaxed);
+            ::operator delete(frame);
+        }
+    };
+};
+
+#endif // CORO_TASK_H
@@ -0,0 +1,247 @@
+/**
+ * @file coroutine_patterns.cpp
+ * @brief async_demo and packaged_task_demo rewritten as coroutines on a fixed worker pool
+ *
+ * The thread-based demos in async_patterns.cpp give every asynchronous step
+ * an OS thread that sleeps or blocks in get(). Here each step is a Task that
+ * suspends on a timer, a Future or a Channel instead, and the pool's few
+ * workers resume whichever coroutine is ready. coroutine_memory_demo keeps
+ * the same number of operations in flight both ways and compares the memory
+ * they hold. Built only with CPPTHREADS_COROUTINES (C++20).
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "async_logger.h"
+#include "continuable_future.h"
+#include "coro_channel.h"
+#include "coro_scheduler.h"
+#include "coro_task.h"
+#include "task_pool.h"
+
+// Operations kept in flight at once by coroutine_memory_demo
+const size_t CORO_MEMORY_OPERATIONS = 1000;
+
+// compute_sum as a coroutine: a timer replaces the sleeping thread
+static Task<int> compute_sum_task(CoroScheduler& scheduler, int a, int b) {
+    LOG_INFO("Computing sum of %d and %d", a, b);
+    co_await scheduler.sleep_for(std::chrono::milliseconds(500));
+    co_return a + b;
+}
+
+// compute_division as a coroutine; the exception reaches whoever awaits it
+static Task<double> compute_division_task(CoroScheduler& scheduler, double a, double b) {
+    LOG_INFO("Computing division %g / %g", a, b);
+    co_await scheduler.sleep_for(std::chrono::milliseconds(500));
+    if (b == 0) {
+        throw std::runtime_error("Division by zero");
+    }
+    co_return a / b;
+}
+
+static Task<int> async_demo_task(CoroScheduler& scheduler) {
+    // spawn() starts a task right away, like std::launch::async, without a new thread
+    LOG_INFO("1. Spawned task:");
+    Future<int> spawned = spawn(scheduler, compute_sum_task(scheduler, 10, 20));
+    LOG_INFO("Coroutine doing other work while the spawned task runs...");
+    co_await scheduler.sleep_for(std::chrono::milliseconds(100));
+    int result1 = co_await scheduler.when_ready(std::move(spawned));
+    LOG_INFO("Result: %d", result1);
+    
+    // A Task does not start until it is awaited, like std::launch::deferred
+    LOG_INFO("2. Lazy task:");
+    Task<int> lazy = compute_sum_task(scheduler, 15, 25);
+    LOG_INFO("Task is created, not yet started...");
+    int result2 = co_await std::move(lazy);
+    LOG_INFO("Result: %d", result2);
+    
+    // No polling with wait_for: the coroutine is resumed when the result is there
+    LOG_INFO("3. Awaiting instead of polling:");
+    int result3 = co_await compute_sum_task(scheduler, 30, 40);
+    LOG_INFO("Result: %d", result3);
+    
+    LOG_INFO("4. Exception handling with coroutines:");
+    try {
+        double result = co_await compute_division_task(scheduler, 10.0, 0.0);
+        LOG_INFO("Result: %g", result);
+    }
+    catch (const std::exception& e) {
+        LOG_INFO("Caught exception from coroutine: %s", e.what());
+    }
+    
+    co_return result1 + result2 + result3;
+}
+
+// Function for the coroutine version of async_demo
+void coroutine_async_demo() {
+    std::cout << "\n=== Coroutine async Demo ===" << std::endl;
+    TaskPool& pool = default_task_pool();
+    CoroScheduler scheduler(pool);
+    
+    int total = spawn(scheduler, async_demo_task(scheduler)).get();
+    log_flush();
+    std::cout << "Every step ran on " << pool.size() << " pool worker(s); sum of results: " << total << std::endl;
+}
+
+// One of the packaged tasks: compute, then report the result over the channel
+static Task<int> sum_and_send(CoroScheduler& scheduler, Channel<std::pair<int, int>>& results, int index) {
+    int result = co_await compute_sum_task(scheduler, index * 10, index * 20);
+    results.send({ index, result });
+    co_return result;
+}
+
+static Task<int> packaged_task_demo_task(CoroScheduler& scheduler) {
+    LOG_INFO("Main coroutine waiting for the task result...");
+    int first = co_await compute_sum_task(scheduler, 25, 75);
+    LOG_INFO("Result: %d", first);
+    
+    // Five tasks in flight on the pool; results arrive over a channel as they finish
+    LOG_INFO("Running multiple tasks:");
+    Channel<std::pair<int, int>> results(scheduler);
+    std::vector<Future<int>> futures;
+    for (int i = 0; i < 5; ++i) {
+        futures.push_back(spawn(scheduler, sum_and_send(scheduler, results, i)));
+    }
+    
+    int total = 0;
+    for (int i = 0; i < 5; ++i) {
+        std::optional<std::pair<int, int>> received = co_await results.receive();
+        LOG_INFO("Task %d result: %d", received->first, received->second);
+        total += received->second;
+    }
+    
+    // The same results again through one aggregate future
+    std::vector<int> all = co_await scheduler.when_ready(when_all(std::move(futures)));
+    int check = 0;
+    for (int value : all) {
+        check += value;
+    }
+    if (check != total) {
+        LOG_ERROR("when_all returned %d, the channel %d", check, total);
+    }
+    co_return total;
+}
+
+// Function for the coroutine version of packaged_task_demo
+void coroutine_packaged_task_demo() {
+    std::cout << "\n=== Coroutine Packaged Task Demo ===" << std::endl;
+    CoroScheduler scheduler(default_task_pool());
+    
+    int total = spawn(scheduler, packaged_task_demo_task(scheduler)).get();
+    log_flush();
+    std::cout << "Sum of all results: " << total << std::endl;
+}
+
+// Resident and virtual size of the process in KiB; false where /proc is missing
+static bool process_memory(size_t& rss_kib, size_t& virtual_kib) {
+    std::FILE* status = std::fopen("/proc/self/status", "r");
+    if (status == nullptr) {
+        return false;
+    }
+    char line[256];
+    rss_kib = 0;
+    virtual_kib = 0;
+    while (std::fgets(line, sizeof(line), status) != nullptr) {
+        unsigned long value = 0;
+        if (std::sscanf(line, "VmRSS: %lu", &value) == 1) {
+            rss_kib = value;
+        } else if (std::sscanf(line, "VmSize: %lu", &value) == 1) {
+            virtual_kib = value;
+        }
+    }
+    std::fclose(status);
+    return rss_kib != 0;
+}
+
+static void print_memory_row(const char* label, size_t rss_before, size_t rss_after, size_t virtual_before,
+                             size_t virtual_after, const std::string& frame) {
+    double ops = static_cast<double>(CORO_MEMORY_OPERATIONS);
+    std::streamsize precision = std::cout.precision();
+    std::cout << std::left << std::setw(14) << label << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << (static_cast<double>(rss_after) - static_cast<double>(rss_before)) / ops
+              << std::setw(18) << (static_cast<double>(virtual_after) - static_cast<double>(virtual_before)) / ops
+              << std::setw(14) << frame << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    std::cout.precision(precision);
+}
+
+static Task<int> waiting_operation(CoroScheduler& scheduler, std::atomic<size_t>& started, int value) {
+    started.fetch_add(1, std::memory_order_relaxed);
+    co_await scheduler.sleep_for(std::chrono::milliseconds(300));
+    co_return value;
+}
+
+// Function comparing the memory held by in-flight operations: a thread each versus a coroutine each
+void coroutine_memory_demo() {
+    std::cout << "\n=== Memory per In-flight Operation ===" << std::endl;
+    size_t rss_before = 0;
+    size_t virtual_before = 0;
+    size_t rss_after = 0;
+    size_t virtual_after = 0;
+    if (!process_memory(rss_before, virtual_before)) {
+        std::cout << "Process memory is read from /proc/self/status, which this system lacks" << std::endl;
+        return;
+    }
+    std::cout << CORO_MEMORY_OPERATIONS << " operations in flight, each waiting for its input" << std::endl;
+    std::cout << std::left << std::setw(14) << "Version" << std::right << std::setw(12) << "RSS KiB/op"
+              << std::setw(18) << "Virtual KiB/op" << std::setw(14) << "Frame B/op" << std::endl;
+    
+    // Thread-based: each operation is a thread blocked in get(), as in packaged_task_demo
+    {
+        std::promise<void> release;
+        std::shared_future<void> go = release.get_future().share();
+        std::atomic<size_t> started{0};
+        std::vector<std::thread> threads;
+        threads.reserve(CORO_MEMORY_OPERATIONS);
+        process_memory(rss_before, virtual_before);
+        for (size_t i = 0; i < CORO_MEMORY_OPERATIONS; ++i) {
+            threads.emplace_back([go, &started]() {
+                started.fetch_add(1, std::memory_order_relaxed);
+                go.get();
+            });
+        }
+        while (started.load(std::memory_order_relaxed) < CORO_MEMORY_OPERATIONS) {
+            std::this_thread::yield();
+        }
+        process_memory(rss_after, virtual_after);
+        release.set_value();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        print_memory_row("std::thread", rss_before, rss_after, virtual_before, virtual_after, "-");
+    }
+    
+    // Coroutine-based: each operation is a suspended Task frame, plus the frame spawn() runs it in
+    {
+        CoroScheduler scheduler(default_task_pool());
+        std::atomic<size_t> started{0};
+        std::vector<Future<int>> futures;
+        futures.reserve(CORO_MEMORY_OPERATIONS);
+        process_memory(rss_before, virtual_before);
+        size_t frames_before = coro_frame_bytes.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < CORO_MEMORY_OPERATIONS; ++i) {
+            futures.push_back(spawn(scheduler, waiting_operation(scheduler, started, static_cast<int>(i))));
+        }
+        while (started.load(std::memory_order_relaxed) < CORO_MEMORY_OPERATIONS) {
+            std::this_thread::yield();
+        }
+        process_memory(rss_after, virtual_after);
+        size_t frames = coro_frame_bytes.load(std::memory_order_relaxed) - frames_before;
+        for (auto& future : futures) {
+            future.get();
+        }
+        print_memory_row("coroutine", rss_before, rss_after, virtual_before, virtual_after,
+                         std::to_string(frames / CORO_MEMORY_OPERATIONS));
+    }
+    std::cout << "Virtual size counts each thread's reserved stack; RSS counts the pages touched" << std::endl;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file counter_bench.cpp
+ * @brief Counter benchmarks: ThreadSafeCounter, one shared atomic and ShardedCounter
+ *
+ * The sweep always goes up to 64 threads, beyond the hardware thread count
+ * if necessary, because a single contended cache line typically collapses
+ * somewhere past 8 cores while the sharded counter keeps scaling.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include "bench_harness.h"
+#include "counters.h"
+
+static const int COUNTER_MAX_THREADS = 64;
+
+// Increment one counter from every thread count of the sweep; increment(thread_index).
+// Returns how many increments were made in total, warmup runs included
+template <typename Increment>
+static long sweep_counter(BenchHarness& harness, const std::string& name, const std::string& policy,
+                          Increment increment) {
+    if (!harness.enabled(name)) {
+        return 0;
+    }
+    const size_t ops = harness.options().ops;
+    const int runs = harness.options().warmup + harness.options().repetitions;
+    long total = 0;
+    for (int threads : harness.thread_sweep(std::max(COUNTER_MAX_THREADS, harness.options().max_threads))) {
+        harness.run(name, policy, threads, ops * threads, [&]() {
+            return measure_threads(threads, [&](int index) {
+                for (size_t i = 0; i < ops; ++i) {
+                    increment(index);
+                }
+            });
+        });
+        total += static_cast<long>(ops) * threads * runs;
+    }
+    return total;
+}
+
+// Fail the run when a counter lost or invented increments
+static void check_count(BenchHarness& harness, const std::string& policy, long counted, long expected) {
+    if (counted != expected) {
+        harness.report_failure("counter/increment " + policy + ": counted " + std::to_string(counted) + " of " +
+                               std::to_string(expected) + " increments");
+    }
+}
+
+void counter_bench(BenchHarness& harness) {
+    ThreadSafeCounter mutex_counter;
+    std::atomic<long> atomic_counter(0);
+    ShardedCounter thread_sharded(0, ShardSelect::Thread);
+    ShardedCounter cpu_sharded(0, ShardSelect::Cpu);
+    
+    long expected = sweep_counter(harness, "counter/increment", "mutex", [&](int) {
+        mutex_counter.increment();
+    });
+    check_count(harness, "mutex", mutex_counter.get(), expected);
+    expected = sweep_counter(harness, "counter/increment", "atomic", [&](int) {
+        atomic_counter.fetch_add(1, std::memory_order_relaxed);
+    });
+    check_count(harness, "atomic", atomic_counter.load(), expected);
+    expected = sweep_counter(harness, "counter/increment", "sharded_thread", [&](int) {
+        thread_sharded.increment();
+    });
+    check_count(harness, "sharded_thread", thread_sharded.get(), expected);
+    expected = sweep_counter(harness, "counter/increment", "sharded_cpu", [&](int) {
+        cpu_sharded.increment();
+    });
+    check_count(harness, "sharded_cpu", cpu_sharded.get(), expected);
+    
+    // A hit counter is also read: every 64th operation reads the total
+    sweep_counter(harness, "counter/increment_read", "atomic", [&](int) {
+        long value = atomic_counter.fetch_add(1, std::memory_order_relaxed);
+        if ((value & 63) == 0) {
+            do_not_optimize(value);
+        }
+    });
+    sweep_counter(harness, "counter/increment_read", "sharded_exact", [&](int) {
+        thread_sharded.increment();
+        static thread_local unsigned calls = 0;
+        if ((++calls & 63) == 0) {
+            long value = thread_sharded.get(CounterRead::Exact);
+            do_not_optimize(value);
+        }
+    });
+    sweep_counter(harness, "counter/increment_read", "sharded_approx", [&](int) {
+        thread_sharded.increment();
+        static thread_local unsigned calls = 0;
+        if ((++calls & 63) == 0) {
+            long value = thread_sharded.get(CounterRead::Approximate);
+            do_not_optimize(value);
+        }
+    });
+}
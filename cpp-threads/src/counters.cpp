@@ -0,0 +1,81 @@
+/**
+ * @file counters.cpp
+ * @brief Slot selection and lazy aggregation for ShardedCounter
+ */
+
+#include "counters.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+// Round-robin slot numbers, handed out on a thread's first increment
+static std::atomic<size_t> next_thread_slot(0);
+
+static uint64_t counter_now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+ShardedCounter::ShardedCounter(size_t shards, ShardSelect select, uint64_t max_staleness_ns)
+    : select(select), max_staleness_ns(max_staleness_ns) {
+    if (shards == 0) {
+        shards = std::max(1u, std::thread::hardware_concurrency());
+    }
+    
+    // A power of two turns the slot lookup into a mask
+    size_t rounded = 1;
+    while (rounded < shards) {
+        rounded *= 2;
+    }
+    slots.reset(new Slot[rounded]);
+    shard_mask = rounded - 1;
+}
+
+size_t assign_shard_slot(ShardSelect select) {
+#if defined(__linux__)
+    if (select == ShardSelect::Cpu) {
+        int cpu = sched_getcpu();
+        if (cpu >= 0) {
+            return static_cast<size_t>(cpu);
+        }
+    }
+#endif
+    if (sharded_counter_thread_slot == 0) {
+        sharded_counter_thread_slot = next_thread_slot.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+    return sharded_counter_thread_slot;
+}
+
+long ShardedCounter::get(CounterRead mode) const {
+    uint64_t now = 0;
+    if (mode == CounterRead::Approximate) {
+        now = counter_now_ns();
+        if (now - cached_at_ns.load(std::memory_order_acquire) < max_staleness_ns) {
+            return cached_sum.load(std::memory_order_relaxed);
+        }
+    }
+    
+    long sum = 0;
+    for (size_t i = 0; i <= shard_mask; ++i) {
+        sum += slots[i].value.load(std::memory_order_relaxed);
+    }
+    
+    if (mode == CounterRead::Approximate) {
+        cached_sum.store(sum, std::memory_order_relaxed);
+        cached_at_ns.store(now, std::memory_order_release);
+    }
+    return sum;
+}
+
+void ShardedCounter::reset() {
+    for (size_t i = 0; i <= shard_mask; ++i) {
+        slots[i].value.store(0, std::memory_order_relaxed);
+    }
+    cached_sum.store(0, std::memory_order_relaxed);
+    cached_at_ns.store(0, std::memory_order_release);
+}
@@ -0,0 +1,106 @@
+/**
+ * @file counters.h
+ * @brief Thread-safe event counters: one mutex-protected value, or sharded slots
+ *
+ * ThreadSafeCounter serializes every increment on one mutex, and a single
+ * std::atomic still bounces one cache line between all incrementing cores.
+ * ShardedCounter spreads increments over cache-line-padded slots, chosen
+ * per thread or per CPU, so increments on different cores touch different
+ * lines. The slots are only added up when the value is read, which makes
+ * increments cheap and reads proportional to the number of slots.
+ */
+
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+// Thread-safe counter class
+class ThreadSafeCounter {
+private:
+    long value = 0;
+    mutable std::mutex mutex;
+
+public:
+    // Increment the counter safely
+    void increment() {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++value;
+    }
+    
+    // Get the current value safely
+    long get() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return value;
+    }
+};
+
+// How an incrementing thread picks its slot
+enum class ShardSelect {
+    Thread,                          // Fixed slot per thread, assigned round robin
+    Cpu                              // Slot of the CPU the thread runs on (Linux; else per thread)
+};
+
+// How get() reads the slots
+enum class CounterRead {
+    Exact,                           // Sum every slot; includes all increments that happened before
+    Approximate                      // Reuse a sum at most max_staleness_ns old
+};
+
+// Slot number of the calling thread plus one (0 = not assigned yet); constant
+// initialized, so reading it costs no more than any other thread-local access
+inline thread_local size_t sharded_counter_thread_slot = 0;
+
+// Slow path of shard_slot(): the CPU lookup, or a thread's first call
+size_t assign_shard_slot(ShardSelect select);
+
+// Unmasked slot number of the calling thread; shared by every sharded structure
+inline size_t shard_slot(ShardSelect select) {
+    if (select == ShardSelect::Thread && sharded_counter_thread_slot != 0) {
+        return sharded_counter_thread_slot;
+    }
+    return assign_shard_slot(select);
+}
+
+class ShardedCounter {
+public:
+    // shards == 0 picks the next power of two >= the hardware thread count
+    explicit ShardedCounter(size_t shards = 0, ShardSelect select = ShardSelect::Thread,
+                            uint64_t max_staleness_ns = 1'000'000);
+    
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+    
+    void add(long delta) {
+        slots[shard_slot(select) & shard_mask].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+    
+    void increment() { add(1); }
+    
+    long get(CounterRead mode = CounterRead::Exact) const;
+    
+    // Zero every slot; not atomic with respect to concurrent increments
+    void reset();
+    
+    size_t shards() const { return shard_mask + 1; }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<long> value{0};
+    };
+    
+    std::unique_ptr<Slot[]> slots;
+    size_t shard_mask;
+    ShardSelect select;
+    uint64_t max_staleness_ns;
+    
+    // Approximate reads share the last exact sum
+    mutable std::atomic<long> cached_sum{0};
+    mutable std::atomic<uint64_t> cached_at_ns{0};
+};
+
+#endif // COUNTERS_H
@@ -14,31 +14,15 @@
 #include <sstream>
 #include <iomanip>
 #include <shared_mutex>
+#include "counters.h"
+#include "lock_profiler.h"
+#include "mpmc_queue.h"
+#include "rcu_cell.h"
 
 // Declare global variables with unique names to avoid conflicts
-std::mutex data_race_mutex;
+ProfiledMutex data_race_mutex("data_race_mutex");
 std::atomic<int> data_race_atomic_counter(0);
 
-// Thread-safe counter class
-class ThreadSafeCounter {
-private:
-    int value = 0;
-    mutable std::mutex mutex;
-
-public:
-    // Increment the counter safely
-    void increment() {
-        std::lock_guard<std::mutex> lock(mutex);
-        ++value;
-    }
-    
-    // Get the current value safely
-    int get() const {
-        std::lock_guard<std::mutex> lock(mutex);
-        return value;
-    }
-};
-
 // =================== DATA RACE EXAMPLES ===================
 
 // Example 1: Basic data race
@@ -125,14 +109,13 @@ void mutex_solution_demo() {
     std::cout << "\n=== Mutex Solution Demo ===" << std::endl;
     
     int shared_counter = 0;
-    std::mutex demo_mutex; // Renamed to avoid conflict with global
     const int iterations = 1000000;
     
     // Thread function that increments the counter with mutex protection
-    auto safe_increment_thread = [&shared_counter, &demo_mutex, iterations]() {
+    auto safe_increment_thread = [&shared_counter, iterations]() {
         for (int i = 0; i < iterations; ++i) {
             // Lock the mutex before accessing the shared counter
-            std::lock_guard<std::mutex> lock(demo_mutex);
+            std::lock_guard<ProfiledMutex> lock(data_race_mutex);
             shared_counter++;
         }
     };
@@ -221,6 +204,46 @@ void thread_local_solution_demo() {
     std::cout << "Actual combined value: " << shared_counter.load() << std::endl;
 }
 
+// Sharded counter: per-thread slots like the thread-local solution, but the
+// total can be read at any time instead of only after the threads finish
+void sharded_counter_demo() {
+    std::cout << "\n=== Sharded Counter Demo ===" << std::endl;
+    
+    ThreadSafeCounter mutex_counter;
+    ShardedCounter sharded_counter;
+    const int num_threads = 4;
+    const int iterations = 1000000;
+    
+    // Run the same increments against one counter and return the elapsed time
+    auto run_increments = [num_threads, iterations](auto& counter) {
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&counter, iterations]() {
+                for (int i = 0; i < iterations; ++i) {
+                    counter.increment();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start).count();
+    };
+    
+    auto mutex_ms = run_increments(mutex_counter);
+    auto sharded_ms = run_increments(sharded_counter);
+    
+    std::cout << "Expected counter value: " << (num_threads * iterations) << std::endl;
+    std::cout << "ThreadSafeCounter (one mutex): " << mutex_counter.get()
+              << " (Time: " << mutex_ms << " ms)" << std::endl;
+    std::cout << "ShardedCounter (" << sharded_counter.shards() << " slots): "
+              << sharded_counter.get(CounterRead::Exact) << " (Time: " << sharded_ms << " ms)" << std::endl;
+    std::cout << "Approximate read (may lag by up to 1 ms): "
+              << sharded_counter.get(CounterRead::Approximate) << std::endl;
+}
+
 // =================== ADVANCED THREAD SAFETY PATTERNS ===================
 
 // Example 6: Reader-writer lock pattern
@@ -279,6 +302,60 @@ void reader_writer_lock_demo() {
     std::cout << "Reader-writer lock demo completed. Multiple readers could read simultaneously." << std::endl;
 }
 
+// Example 6b: The same readers and writer with read-copy-update
+void rcu_cell_demo() {
+    std::cout << "\n=== RCU Cell Demo ===" << std::endl;
+    
+    // Readers never lock; the writer publishes a new copy of the value
+    RcuCell<int> shared_data(0);
+    
+    // Function that writes to the shared data
+    auto writer_fn = [&shared_data](int iterations) {
+        for (int i = 0; i < iterations; ++i) {
+            // Old versions are freed in batches, after the readers that may see them are done
+            shared_data.store(i);
+            
+            // Simulate some work
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    };
+    
+    // Function that reads from the shared data
+    auto reader_fn = [&shared_data](int reader_id, int iterations) {
+        int sum = 0;
+        for (int i = 0; i < iterations; ++i) {
+            // Wait-free read: no lock, no shared write
+            sum += shared_data.read([](const int& value) { return value; });
+            
+            // Simulate some work
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::cout << "Reader " << reader_id << " sum: " << sum << std::endl;
+    };
+    
+    std::cout << "Launching writer and reader threads..." << std::endl;
+    
+    const int write_iterations = 100;
+    const int read_iterations = 200;
+    
+    std::thread writer(writer_fn, write_iterations);
+    
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) {
+        readers.emplace_back(reader_fn, i + 1, read_iterations);
+    }
+    
+    // Wait for all threads
+    writer.join();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    
+    std::cout << "Old versions still waiting for a grace period: " << shared_data.pending() << std::endl;
+    shared_data.synchronize();
+    std::cout << "RCU cell demo completed. Readers never waited for the writer or for each other." << std::endl;
+}
+
 // Example 7: Double-checked locking pattern (Singleton)
 // Singleton class declared outside to allow static members
 class Singleton {
@@ -350,65 +427,21 @@ void double_checked_locking_demo() {
     std::cout << "Double-checked locking demo completed. Singleton should only be created once." << std::endl;
 }
 
-// Example 8: Lock-free queue
-// LockFreeQueue class declared outside the function to allow static constants
-class LockFreeQueue {
-private:
-    static const int MAX_SIZE = 100;
-    std::atomic<int> items[MAX_SIZE];
-    std::atomic<int> head{0};
-    std::atomic<int> tail{0};
-    
-public:
-    LockFreeQueue() {
-        // Initialize all slots to empty (-1)
-        for (int i = 0; i < MAX_SIZE; ++i) {
-            items[i].store(-1, std::memory_order_relaxed);
-        }
-    }
-    
-    bool enqueue(int value) {
-        int current_tail = tail.load(std::memory_order_relaxed);
-        int next_tail = (current_tail + 1) % MAX_SIZE;
-        
-        // Check if queue is full
-        if (next_tail == head.load(std::memory_order_acquire)) {
-            return false;  // Queue full
-        }
-        
-        // Add item to the queue
-        items[current_tail].store(value, std::memory_order_relaxed);
-        
-        // Update tail with release memory ordering
-        tail.store(next_tail, std::memory_order_release);
-        return true;
-    }
-    
-    bool dequeue(int& result) {
-        int current_head = head.load(std::memory_order_relaxed);
-        
-        // Check if queue is empty
-        if (current_head == tail.load(std::memory_order_acquire)) {
-            return false;  // Queue empty
-        }
-        
-        // Get the item
-        result = items[current_head].load(std::memory_order_relaxed);
-        
-        // Mark slot as empty for debugging
-        items[current_head].store(-1, std::memory_order_relaxed);
-        
-        // Update head with release memory ordering
-        head.store((current_head + 1) % MAX_SIZE, std::memory_order_release);
-        return true;
-    }
-};
-
+// Example 8: Lock-free queue (MpmcQueue is defined in mpmc_queue.h)
 void lock_free_queue_demo() {
     std::cout << "\n=== Lock-Free Programming Demo ===" << std::endl;
     
-    // Create a shared queue
-    LockFreeQueue queue;
+    // Create a shared queue; two producers and two consumers need a
+    // multi-producer/multi-consumer queue (LockFreeQueue in lock_free_queue.h is single-producer)
+    MpmcQueue<int, 128> queue;
+    
+    const int items_per_producer = 1000;
+    const int num_producers = 2;
+    const int num_consumers = 2;
+    const int items_per_consumer = (items_per_producer * num_producers) / num_consumers;
+    
+    // How often each value was received; every entry must end up at exactly 1
+    std::vector<std::atomic<int>> received(items_per_producer * num_producers);
     
     // Producer thread
     auto producer_fn = [&queue](int start_value, int count) {
@@ -422,13 +455,14 @@ void lock_free_queue_demo() {
     };
     
     // Consumer thread
-    auto consumer_fn = [&queue](int expected_count, int consumer_id) {
+    auto consumer_fn = [&queue, &received](int expected_count, int consumer_id) {
         int value;
         int received_count = 0;
         int sum = 0;
         
         while (received_count < expected_count) {
             if (queue.dequeue(value)) {
+                received[value].fetch_add(1, std::memory_order_relaxed);
                 sum += value;
                 received_count++;
             } else {
@@ -444,11 +478,6 @@ void lock_free_queue_demo() {
     // Launch producer and consumer threads
     std::cout << "Launching producer and consumer threads..." << std::endl;
     
-    const int items_per_producer = 1000;
-    const int num_producers = 2;
-    const int num_consumers = 2;
-    const int items_per_consumer = (items_per_producer * num_producers) / num_consumers;
-    
     std::vector<std::thread> producers;
     for (int i = 0; i < num_producers; ++i) {
         producers.emplace_back(producer_fn, i * items_per_producer, items_per_producer);
@@ -468,6 +497,11 @@ void lock_free_queue_demo() {
         consumer.join();
     }
     
+    bool exactly_once = true;
+    for (const auto& count : received) {
+        exactly_once = exactly_once && count.load() == 1;
+    }
+    std::cout << "Every item arrived exactly once: " << (exactly_once ? "Yes" : "No") << std::endl;
     std::cout << "Lock-free queue demo completed. No locks were used." << std::endl;
 }
 
@@ -485,10 +519,12 @@ int data_races_main() {
     mutex_solution_demo();
     atomic_solution_demo();
     thread_local_solution_demo();
+    sharded_counter_demo();
     
     // Run demos of advanced thread safety patterns
     std::cout << "\n--- Part 3: Advanced Thread Safety Patterns ---" << std::endl;
     reader_writer_lock_demo();
+    rcu_cell_demo();
     double_checked_locking_demo();
     lock_free_queue_demo();
     
@@ -0,0 +1,61 @@
+/**
+ * @file demo_settings.cpp
+ * @brief Storage for the demo runtime parameters and timing records
+ */
+
+#include "demo_settings.h"
+
+#include <map>
+#include <mutex>
+#include <tuple>
+
+// Samples of one timed section across repetitions
+struct DemoSamples {
+    size_t elements = 0;
+    std::vector<double> ns_per_op;
+};
+
+typedef std::tuple<std::string, std::string, int> DemoKey;
+
+// Keys keep first-recorded order so the report follows the demo output
+static std::vector<DemoKey> demo_record_order;
+static std::map<DemoKey, DemoSamples> demo_records;
+static std::mutex demo_records_mutex;
+
+DemoSettings& demo_settings() {
+    static DemoSettings settings;
+    return settings;
+}
+
+size_t demo_size(size_t default_size) {
+    return demo_settings().size > 0 ? demo_settings().size : default_size;
+}
+
+int demo_threads(int default_threads) {
+    return demo_settings().threads > 0 ? demo_settings().threads : default_threads;
+}
+
+void demo_record(const std::string& name, const std::string& policy, int threads, size_t elements,
+                 std::chrono::nanoseconds elapsed) {
+    std::lock_guard<std::mutex> lock(demo_records_mutex);
+    DemoKey key(name, policy, threads);
+    auto it = demo_records.find(key);
+    if (it == demo_records.end()) {
+        demo_record_order.push_back(key);
+        it = demo_records.emplace(key, DemoSamples()).first;
+    }
+    it->second.elements = elements;
+    it->second.ns_per_op.push_back(static_cast<double>(elapsed.count()) /
+                                   static_cast<double>(elements > 0 ? elements : 1));
+}
+
+std::vector<BenchResult> demo_results() {
+    std::lock_guard<std::mutex> lock(demo_records_mutex);
+    std::vector<BenchResult> results;
+    for (const auto& key : demo_record_order) {
+        const DemoSamples& samples = demo_records[key];
+        results.push_back(summarize_samples(std::get<0>(key), std::get<1>(key), std::get<2>(key),
+                                            samples.elements, samples.ns_per_op));
+    }
+    return results;
+}
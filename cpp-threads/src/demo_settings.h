@@ -0,0 +1,39 @@
+/**
+ * @file demo_settings.h
+ * @brief Runtime parameters and timing records shared by the demos and the command-line runner
+ *
+ * main.cpp fills the settings from --size and --threads before running a
+ * demo; each demo asks for its element count and thread count through
+ * demo_size() and demo_threads(), passing its own default. Timed sections
+ * call demo_record() so batch runs can report them as JSON or CSV.
+ */
+
+#ifndef DEMO_SETTINGS_H
+#define DEMO_SETTINGS_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "bench_results.h"
+
+struct DemoSettings {
+    size_t size = 0;                 // Elements or iterations per demo (0 = demo default)
+    int threads = 0;                 // Worker threads per demo (0 = demo default)
+    bool perf = false;               // Print perf_event counters around timed sections
+};
+
+DemoSettings& demo_settings();
+
+// The configured size or thread count, or the demo's default when none was given
+size_t demo_size(size_t default_size);
+int demo_threads(int default_threads);
+
+// Record one timed section: `elements` operations on `threads` threads took `elapsed`
+void demo_record(const std::string& name, const std::string& policy, int threads, size_t elements,
+                 std::chrono::nanoseconds elapsed);
+
+// Every recorded section, summarized over its repetitions
+std::vector<BenchResult> demo_results();
+
+#endif // DEMO_SETTINGS_H
@@ -0,0 +1,119 @@
+/**
+ * @file fair_locks.cpp
+ * @brief Queue handling of McsLock and ClhLock
+ */
+
+#include "fair_locks.h"
+
+#include <vector>
+
+// Queue nodes the calling thread owns but has not put in any lock's queue
+template <typename Node>
+class NodeCache {
+public:
+    ~NodeCache() {
+        for (Node* node : spare) {
+            delete node;
+        }
+    }
+    
+    Node* take() {
+        if (spare.empty()) {
+            return new Node;
+        }
+        Node* node = spare.back();
+        spare.pop_back();
+        return node;
+    }
+    
+    void give(Node* node) {
+        spare.push_back(node);
+    }
+
+private:
+    std::vector<Node*> spare;
+};
+
+static thread_local NodeCache<McsNode> mcs_nodes;
+static thread_local NodeCache<ClhNode> clh_nodes;
+
+void McsLock::lock() {
+    McsNode* node = mcs_nodes.take();
+    node->next.store(nullptr, std::memory_order_relaxed);
+    node->locked.store(true, std::memory_order_relaxed);
+    
+    // Join the queue; with a predecessor, wait until it hands the lock over
+    McsNode* predecessor = tail.exchange(node, std::memory_order_acq_rel);
+    if (predecessor != nullptr) {
+        predecessor->next.store(node, std::memory_order_release);
+        SpinWait spin;
+        while (node->locked.load(std::memory_order_acquire)) {
+            spin.wait();
+        }
+    }
+    owner = node;
+}
+
+bool McsLock::try_lock() {
+    McsNode* node = mcs_nodes.take();
+    node->next.store(nullptr, std::memory_order_relaxed);
+    
+    McsNode* expected = nullptr;
+    if (!tail.compare_exchange_strong(expected, node, std::memory_order_acquire,
+                                      std::memory_order_relaxed)) {
+        mcs_nodes.give(node);
+        return false;
+    }
+    owner = node;
+    return true;
+}
+
+void McsLock::unlock() {
+    McsNode* node = owner;
+    McsNode* successor = node->next.load(std::memory_order_acquire);
+    if (successor == nullptr) {
+        // Nobody behind us: leave the lock free
+        McsNode* expected = node;
+        if (tail.compare_exchange_strong(expected, nullptr, std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+            mcs_nodes.give(node);
+            return;
+        }
+        
+        // A thread has swapped itself into the tail but not linked in yet
+        SpinWait spin;
+        while ((successor = node->next.load(std::memory_order_acquire)) == nullptr) {
+            spin.wait();
+        }
+    }
+    successor->locked.store(false, std::memory_order_release);
+    mcs_nodes.give(node);
+}
+
+ClhLock::ClhLock() : tail(new ClhNode) {
+}
+
+ClhLock::~ClhLock() {
+    delete tail.load(std::memory_order_relaxed);
+}
+
+void ClhLock::lock() {
+    ClhNode* node = clh_nodes.take();
+    node->locked.store(true, std::memory_order_relaxed);
+    
+    ClhNode* predecessor = tail.exchange(node, std::memory_order_acq_rel);
+    SpinWait spin;
+    while (predecessor->locked.load(std::memory_order_acquire)) {
+        spin.wait();
+    }
+    owner = node;
+    owner_predecessor = predecessor;
+}
+
+void ClhLock::unlock() {
+    // Read the holder fields before releasing: the next holder overwrites them
+    ClhNode* node = owner;
+    ClhNode* predecessor = owner_predecessor;
+    node->locked.store(false, std::memory_order_release);
+    clh_nodes.give(predecessor);
+}
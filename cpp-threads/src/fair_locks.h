@@ -0,0 +1,118 @@
+/**
+ * @file fair_locks.h
+ * @brief First-come, first-served spinlocks: ticket, MCS and CLH
+ *
+ * The test-and-set spinlock of atomic_flag_demo hands the lock to whichever
+ * waiter's test_and_set happens to land first, so one thread can take it
+ * again and again while another starves, and every waiter writes the same
+ * cache line on every attempt. The locks here serve waiters in arrival
+ * order:
+ *
+ * - TicketLock: a waiter draws a number and watches the "now serving"
+ *   counter. It is two integers, but all waiters still read one line that
+ *   every unlock invalidates.
+ * - McsLock: waiters form a linked queue of nodes and each spins on a flag
+ *   in its own node, which its predecessor clears on unlock.
+ * - ClhLock: waiters form an implicit queue and each spins on its
+ *   predecessor's node. A thread leaves its node in the queue on unlock
+ *   and adopts its predecessor's node for the next acquisition.
+ *
+ * TicketLock and McsLock meet the Lockable requirements (lock, try_lock,
+ * unlock), so they work with std::lock_guard, std::unique_lock and
+ * std::lock like std::mutex. ClhLock is only BasicLockable (lock, unlock):
+ * its tail is always some thread's recycled node, so a try_lock could not
+ * tell a free lock from a node that was released and queued again, and
+ * once in the queue it could not back out without waiting. The MCS and CLH
+ * queue nodes come from a small per-thread cache, so a thread may hold
+ * several of these locks at once and release them in any order.
+ *
+ * Strict FIFO order has a price: when the next thread in line is not
+ * running, nobody gets the lock until it is scheduled again. Waiters
+ * therefore yield after a short spin (see SpinWait).
+ */
+
+#ifndef FAIR_LOCKS_H
+#define FAIR_LOCKS_H
+
+#include <atomic>
+#include <cstdint>
+#include "spin_wait.h"
+
+class TicketLock {
+public:
+    TicketLock() = default;
+    TicketLock(const TicketLock&) = delete;
+    TicketLock& operator=(const TicketLock&) = delete;
+    
+    void lock() {
+        const uint32_t ticket = next_ticket.fetch_add(1, std::memory_order_relaxed);
+        SpinWait spin;
+        while (now_serving.load(std::memory_order_acquire) != ticket) {
+            spin.wait();
+        }
+    }
+    
+    // Draw a ticket only if it would be served right away
+    bool try_lock() {
+        uint32_t serving = now_serving.load(std::memory_order_acquire);
+        uint32_t expected = serving;
+        return next_ticket.compare_exchange_strong(expected, serving + 1, std::memory_order_acquire,
+                                                   std::memory_order_relaxed);
+    }
+    
+    // Only the holder writes now_serving, so a plain increment is enough
+    void unlock() {
+        now_serving.store(now_serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+    // Separate lines, so arriving threads do not disturb the line the waiters watch
+    alignas(64) std::atomic<uint32_t> next_ticket{0};
+    alignas(64) std::atomic<uint32_t> now_serving{0};
+};
+
+// Queue node of an MCS waiter
+struct alignas(64) McsNode {
+    std::atomic<McsNode*> next{nullptr};
+    std::atomic<bool> locked{false};
+};
+
+class McsLock {
+public:
+    McsLock() = default;
+    McsLock(const McsLock&) = delete;
+    McsLock& operator=(const McsLock&) = delete;
+    
+    void lock();
+    bool try_lock();
+    void unlock();
+
+private:
+    std::atomic<McsNode*> tail{nullptr};     // Last waiter in line, nullptr when the lock is free
+    McsNode* owner = nullptr;                // Node of the holder, written only under the lock
+};
+
+// Queue node of a CLH waiter
+struct alignas(64) ClhNode {
+    std::atomic<bool> locked{false};
+};
+
+class ClhLock {
+public:
+    ClhLock();
+    ~ClhLock();
+    
+    ClhLock(const ClhLock&) = delete;
+    ClhLock& operator=(const ClhLock&) = delete;
+    
+    // No try_lock(): see the file comment
+    void lock();
+    void unlock();
+
+private:
+    std::atomic<ClhNode*> tail;              // Last node in line; starts as an unlocked dummy
+    ClhNode* owner = nullptr;                // Holder's node, left in the queue on unlock
+    ClhNode* owner_predecessor = nullptr;    // Node the holder waited on, adopted on unlock
+};
+
+#endif // FAIR_LOCKS_H
@@ -0,0 +1,163 @@
+/**
+ * @file future_bench.cpp
+ * @brief Ten-stage continuation chains: a thread per then() versus Future::then
+ *
+ * - detach_thread: the then() continuation_demo used to have, which starts a
+ *                  detached std::thread per stage that blocks in get()
+ * - inline:        Future::then, every stage runs on the thread that set the value
+ * - pool:          Future::then(pool, ...), every stage is a TaskPool task
+ *
+ * future/chain_latency builds a chain, then times one run from setting the
+ * first value to get() returning the last. future/chain_throughput builds
+ * FUTURE_BENCH_CHAINS chains at once, fulfils them all and waits for every
+ * result; building the chains is timed too, because that is where the
+ * detach-based version creates its threads.
+ */
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_harness.h"
+#include "continuable_future.h"
+#include "task_pool.h"
+
+// Stages per chain
+static const int FUTURE_BENCH_STAGES = 10;
+
+// Chains timed one after another per latency sample
+static const size_t FUTURE_BENCH_RUNS = 100;
+
+// Chains in flight at once per throughput sample
+static const size_t FUTURE_BENCH_CHAINS = 100;
+
+static int64_t stage(int64_t value) {
+    return value + 1;
+}
+
+// The continuation_demo then(): one detached thread per stage, parked in get()
+static std::future<int64_t> detach_then(std::future<int64_t>&& future, std::function<int64_t(int64_t)> func) {
+    std::promise<int64_t> promise;
+    std::future<int64_t> result = promise.get_future();
+    std::thread([](std::promise<int64_t> p, std::future<int64_t> f, std::function<int64_t(int64_t)> fn) {
+        try {
+            p.set_value(fn(f.get()));
+        } catch (...) {
+            p.set_exception(std::current_exception());
+        }
+    }, std::move(promise), std::move(future), std::move(func)).detach();
+    return result;
+}
+
+// One chain per policy: start() builds it, fulfil() sets the first value, finish() gets the last
+class DetachChain {
+public:
+    void start() {
+        std::future<int64_t> future = first.get_future();
+        for (int i = 0; i < FUTURE_BENCH_STAGES; ++i) {
+            future = detach_then(std::move(future), stage);
+        }
+        last = std::move(future);
+    }
+    void fulfil(int64_t value) { first.set_value(value); }
+    int64_t finish() { return last.get(); }
+
+private:
+    std::promise<int64_t> first;
+    std::future<int64_t> last;
+};
+
+class InlineChain {
+public:
+    void start() {
+        Future<int64_t> future = first.get_future();
+        for (int i = 0; i < FUTURE_BENCH_STAGES; ++i) {
+            future = future.then(stage);
+        }
+        last = std::move(future);
+    }
+    void fulfil(int64_t value) { first.set_value(value); }
+    int64_t finish() { return last.get(); }
+
+private:
+    Promise<int64_t> first;
+    Future<int64_t> last;
+};
+
+class PoolChain {
+public:
+    void start() {
+        Future<int64_t> future = first.get_future();
+        for (int i = 0; i < FUTURE_BENCH_STAGES; ++i) {
+            future = future.then(default_task_pool(), stage);
+        }
+        last = std::move(future);
+    }
+    void fulfil(int64_t value) { first.set_value(value); }
+    int64_t finish() { return last.get(); }
+
+private:
+    Promise<int64_t> first;
+    Future<int64_t> last;
+};
+
+// Fail the run when a chain skipped or repeated a stage
+static void check_result(BenchHarness& harness, const std::string& name, const std::string& policy, int64_t input,
+                         int64_t output) {
+    if (output != input + FUTURE_BENCH_STAGES) {
+        harness.report_failure(name + " " + policy + ": chain returned " + std::to_string(output) + ", expected " +
+                               std::to_string(input + FUTURE_BENCH_STAGES));
+    }
+}
+
+template <typename Chain>
+static void bench_chain(BenchHarness& harness, const std::string& policy) {
+    std::string name = "future/chain_latency";
+    if (harness.enabled(name)) {
+        harness.run(name, policy, 1, FUTURE_BENCH_RUNS, [&]() {
+            uint64_t total = 0;
+            for (size_t run = 0; run < FUTURE_BENCH_RUNS; ++run) {
+                Chain chain;
+                chain.start();
+                uint64_t start = bench_now_ns();
+                chain.fulfil(static_cast<int64_t>(run));
+                int64_t result = chain.finish();
+                total += bench_now_ns() - start;
+                check_result(harness, name, policy, static_cast<int64_t>(run), result);
+            }
+            return total;
+        });
+    }
+    
+    name = "future/chain_throughput";
+    if (harness.enabled(name)) {
+        harness.run(name, policy, 1, FUTURE_BENCH_CHAINS, [&]() {
+            std::vector<Chain> chains(FUTURE_BENCH_CHAINS);
+            uint64_t start = bench_now_ns();
+            for (Chain& chain : chains) {
+                chain.start();
+            }
+            for (size_t i = 0; i < chains.size(); ++i) {
+                chains[i].fulfil(static_cast<int64_t>(i));
+            }
+            std::vector<int64_t> results;
+            results.reserve(chains.size());
+            for (Chain& chain : chains) {
+                results.push_back(chain.finish());
+            }
+            uint64_t elapsed = bench_now_ns() - start;
+            for (size_t i = 0; i < results.size(); ++i) {
+                check_result(harness, name, policy, static_cast<int64_t>(i), results[i]);
+            }
+            return elapsed;
+        });
+    }
+}
+
+void future_bench(BenchHarness& harness) {
+    bench_chain<DetachChain>(harness, "detach_thread");
+    bench_chain<InlineChain>(harness, "inline");
+    bench_chain<PoolChain>(harness, "pool");
+}
@@ -0,0 +1,67 @@
+/**
+ * @file lock_free_queue.h
+ * @brief Fixed-size lock-free ring buffer used by the data races demo and the benchmarks
+ *
+ * One producer and one consumer may use the queue concurrently: the producer
+ * owns tail, the consumer owns head, and acquire/release on the indices
+ * publishes the slots between them.
+ */
+
+#ifndef LOCK_FREE_QUEUE_H
+#define LOCK_FREE_QUEUE_H
+
+#include <atomic>
+
+class LockFreeQueue {
+private:
+    static const int MAX_SIZE = 100;
+    std::atomic<int> items[MAX_SIZE];
+    std::atomic<int> head{0};
+    std::atomic<int> tail{0};
+
+public:
+    LockFreeQueue() {
+        // Initialize all slots to empty (-1)
+        for (int i = 0; i < MAX_SIZE; ++i) {
+            items[i].store(-1, std::memory_order_relaxed);
+        }
+    }
+    
+    bool enqueue(int value) {
+        int current_tail = tail.load(std::memory_order_relaxed);
+        int next_tail = (current_tail + 1) % MAX_SIZE;
+        
+        // Check if queue is full
+        if (next_tail == head.load(std::memory_order_acquire)) {
+            return false;  // Queue full
+        }
+        
+        // Add item to the queue
+        items[current_tail].store(value, std::memory_order_relaxed);
+        
+        // Update tail with release memory ordering
+        tail.store(next_tail, std::memory_order_release);
+        return true;
+    }
+    
+    bool dequeue(int& result) {
+        int current_head = head.load(std::memory_order_relaxed);
+        
+        // Check if queue is empty
+        if (current_head == tail.load(std::memory_order_acquire)) {
+            return false;  // Queue empty
+        }
+        
+        // Get the item
+        result = items[current_head].load(std::memory_order_relaxed);
+        
+        // Mark slot as empty for debugging
+        items[current_head].store(-1, std::memory_order_relaxed);
+        
+        // Update head with release memory ordering
+        head.store((current_head + 1) % MAX_SIZE, std::memory_order_release);
+        return true;
+    }
+};
+
+#endif // LOCK_FREE_QUEUE_H
@@ -0,0 +1,234 @@
+/**
+ * @file lock_profiler.cpp
+ * @brief Per-thread lock statistics, their merging and the contention report
+ */
+
+#include "lock_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// One thread's statistics for one lock. Only the owning thread writes them; the report
+// reads them from another thread, hence the relaxed atomics.
+struct LockCounters {
+    std::atomic<uint64_t> acquisitions{0};
+    std::atomic<uint64_t> contended{0};
+    std::atomic<uint64_t> wait_ns{0};
+    std::atomic<uint64_t> wait_histogram[LOCK_PROFILE_BUCKETS] = {};
+    std::atomic<uint64_t> hold_histogram[LOCK_PROFILE_BUCKETS] = {};
+};
+
+// Statistics of one lock merged over threads
+struct LockTotals {
+    uint64_t acquisitions = 0;
+    uint64_t contended = 0;
+    uint64_t wait_ns = 0;
+    uint64_t wait_histogram[LOCK_PROFILE_BUCKETS] = {};
+    uint64_t hold_histogram[LOCK_PROFILE_BUCKETS] = {};
+    
+    void add(const LockCounters& counters) {
+        acquisitions += counters.acquisitions.load(std::memory_order_relaxed);
+        contended += counters.contended.load(std::memory_order_relaxed);
+        wait_ns += counters.wait_ns.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < LOCK_PROFILE_BUCKETS; ++i) {
+            wait_histogram[i] += counters.wait_histogram[i].load(std::memory_order_relaxed);
+            hold_histogram[i] += counters.hold_histogram[i].load(std::memory_order_relaxed);
+        }
+    }
+};
+
+struct ThreadLockBuffer;
+
+// Lock names, the buffers of running threads and what exited threads left behind
+struct LockProfileRegistry {
+    std::mutex mutex;
+    std::vector<std::string> names;
+    std::vector<ThreadLockBuffer*> live;
+    LockTotals retired[LOCK_PROFILE_MAX_LOCKS];
+    
+    ~LockProfileRegistry();
+};
+
+static LockProfileRegistry& registry() {
+    static LockProfileRegistry instance;
+    return instance;
+}
+
+struct ThreadLockBuffer {
+    LockCounters counters[LOCK_PROFILE_MAX_LOCKS];
+    
+    ThreadLockBuffer() {
+        LockProfileRegistry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.live.push_back(this);
+    }
+    
+    // Hand the statistics over before the thread goes away
+    ~ThreadLockBuffer() {
+        LockProfileRegistry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (size_t i = 0; i < LOCK_PROFILE_MAX_LOCKS; ++i) {
+            reg.retired[i].add(counters[i]);
+        }
+        reg.live.erase(std::find(reg.live.begin(), reg.live.end(), this));
+    }
+};
+
+// Allocated on the first acquisition, so threads that never take a profiled lock pay nothing
+static LockCounters& thread_counters(size_t id) {
+    static thread_local std::unique_ptr<ThreadLockBuffer> buffer(new ThreadLockBuffer);
+    return buffer->counters[id];
+}
+
+// The owner is the only writer, so a load and a store replace the locked read-modify-write
+static void bump(std::atomic<uint64_t>& value, uint64_t amount) {
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+static size_t histogram_bucket(uint64_t ns) {
+    if (ns == 0) {
+        return 0;
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    size_t bucket = 64 - static_cast<size_t>(__builtin_clzll(ns));
+#else
+    size_t bucket = 0;
+    while (ns != 0) {
+        ns >>= 1;
+        ++bucket;
+    }
+#endif
+    return std::min(bucket, LOCK_PROFILE_BUCKETS - 1);
+}
+
+size_t lock_profile_register(const char* name) {
+    LockProfileRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (size_t i = 0; i < reg.names.size(); ++i) {
+        if (reg.names[i] == name) {
+            return i;
+        }
+    }
+    if (reg.names.size() == LOCK_PROFILE_MAX_LOCKS - 1) {
+        reg.names.push_back("(other locks)");
+    }
+    if (reg.names.size() == LOCK_PROFILE_MAX_LOCKS) {
+        return LOCK_PROFILE_MAX_LOCKS - 1;
+    }
+    reg.names.push_back(name);
+    return reg.names.size() - 1;
+}
+
+uint64_t lock_profile_now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void lock_profile_acquired(size_t id, bool contended, uint64_t wait_ns) {
+    LockCounters& counters = thread_counters(id);
+    bump(counters.acquisitions, 1);
+    if (contended) {
+        bump(counters.contended, 1);
+        bump(counters.wait_ns, wait_ns);
+        bump(counters.wait_histogram[histogram_bucket(wait_ns)], 1);
+    }
+}
+
+void lock_profile_released(size_t id, uint64_t hold_ns) {
+    bump(thread_counters(id).hold_histogram[histogram_bucket(hold_ns)], 1);
+}
+
+// Upper bound of the bucket that holds the given fraction of the samples
+static std::string histogram_percentile(const uint64_t (&histogram)[LOCK_PROFILE_BUCKETS], double fraction) {
+    uint64_t total = 0;
+    for (uint64_t count : histogram) {
+        total += count;
+    }
+    if (total == 0) {
+        return "-";
+    }
+    
+    uint64_t seen = 0;
+    size_t bucket = 0;
+    for (; bucket < LOCK_PROFILE_BUCKETS; ++bucket) {
+        seen += histogram[bucket];
+        if (static_cast<double>(seen) >= fraction * static_cast<double>(total)) {
+            break;
+        }
+    }
+    
+    if (bucket == 0) {
+        return "0";
+    }
+    uint64_t bound = uint64_t(1) << std::min(bucket, LOCK_PROFILE_BUCKETS - 1);
+    std::ostringstream text;
+    if (bound < 10'000) {
+        text << "<" << bound << "ns";
+    } else if (bound < 10'000'000) {
+        text << "<" << bound / 1000 << "us";
+    } else {
+        text << "<" << bound / 1'000'000 << "ms";
+    }
+    return text.str();
+}
+
+static void write_report(LockProfileRegistry& reg, std::ostream& out, size_t top_n) {
+    std::vector<std::pair<std::string, LockTotals>> locks;
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (size_t i = 0; i < reg.names.size(); ++i) {
+            LockTotals totals = reg.retired[i];
+            for (ThreadLockBuffer* buffer : reg.live) {
+                totals.add(buffer->counters[i]);
+            }
+            if (totals.acquisitions > 0) {
+                locks.emplace_back(reg.names[i], totals);
+            }
+        }
+    }
+    if (locks.empty()) {
+        return;
+    }
+    
+    std::sort(locks.begin(), locks.end(), [](const auto& a, const auto& b) {
+        return a.second.wait_ns > b.second.wait_ns;
+    });
+    locks.resize(std::min(locks.size(), top_n));
+    
+    out << "\n=== Lock Contention (top " << locks.size() << " by total wait) ===" << std::endl;
+    out << std::left << std::setw(20) << "Lock" << std::right
+        << std::setw(12) << "Acquired" << std::setw(12) << "Contended" << std::setw(9) << "%"
+        << std::setw(14) << "Wait total ms" << std::setw(10) << "Wait p50" << std::setw(10) << "Wait p99"
+        << std::setw(10) << "Hold p50" << std::setw(10) << "Hold p99" << std::endl;
+    for (const auto& entry : locks) {
+        const LockTotals& totals = entry.second;
+        double contended_percent = 100.0 * static_cast<double>(totals.contended) /
+                                   static_cast<double>(totals.acquisitions);
+        out << std::left << std::setw(20) << entry.first << std::right
+            << std::setw(12) << totals.acquisitions << std::setw(12) << totals.contended
+            << std::setw(9) << std::fixed << std::setprecision(2) << contended_percent
+            << std::setw(14) << std::setprecision(2) << static_cast<double>(totals.wait_ns) / 1e6
+            << std::defaultfloat
+            << std::setw(10) << histogram_percentile(totals.wait_histogram, 0.50)
+            << std::setw(10) << histogram_percentile(totals.wait_histogram, 0.99)
+            << std::setw(10) << histogram_percentile(totals.hold_histogram, 0.50)
+            << std::setw(10) << histogram_percentile(totals.hold_histogram, 0.99) << std::endl;
+    }
+}
+
+void lock_profile_report(std::ostream& out, size_t top_n) {
+    write_report(registry(), out, top_n);
+}
+
+// Static destructors run after every thread_local of the main thread, so the main
+// thread's statistics have been merged by now
+LockProfileRegistry::~LockProfileRegistry() {
+    write_report(*this, std::cerr, LOCK_PROFILE_TOP_N);
+}
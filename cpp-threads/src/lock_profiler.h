@@ -0,0 +1,100 @@
+/**
+ * @file lock_profiler.h
+ * @brief Named mutex that records how often and how long threads wait for it
+ *
+ * Configure with -DCPPTHREADS_LOCK_PROFILING=ON to find out which lock
+ * hurts. Every ProfiledMutex has a name, and locks sharing a name share one
+ * set of statistics: acquisitions, contended acquisitions (the lock was
+ * held when the thread arrived), and log2 histograms of how long contended
+ * acquisitions waited and how long the lock was held. Each thread records
+ * into a buffer of its own, so profiling costs two clock reads per
+ * acquisition and writes no shared cache line. At exit the locks with the
+ * most total wait time are printed to stderr.
+ *
+ * Without the option, ProfiledMutex is a std::mutex whose constructor
+ * ignores the name.
+ */
+
+#ifndef LOCK_PROFILER_H
+#define LOCK_PROFILER_H
+
+#include <mutex>
+
+#if defined(CPPTHREADS_LOCK_PROFILING)
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+// Distinct lock names that get their own statistics; later names share the last slot
+const size_t LOCK_PROFILE_MAX_LOCKS = 64;
+
+// Histogram buckets: bucket 0 counts 0 ns, bucket i counts [2^(i-1), 2^i) ns
+const size_t LOCK_PROFILE_BUCKETS = 40;
+
+// Locks listed by the report printed at exit
+const size_t LOCK_PROFILE_TOP_N = 10;
+
+// Statistics slot for a lock name
+size_t lock_profile_register(const char* name);
+
+// Monotonic clock used for the wait and hold times
+uint64_t lock_profile_now_ns();
+
+// Record into the calling thread's buffer
+void lock_profile_acquired(size_t id, bool contended, uint64_t wait_ns);
+void lock_profile_released(size_t id, uint64_t hold_ns);
+
+// Print the top_n locks by total wait time, merged over all threads
+void lock_profile_report(std::ostream& out, size_t top_n = LOCK_PROFILE_TOP_N);
+
+class ProfiledMutex {
+public:
+    explicit ProfiledMutex(const char* name) : id(lock_profile_register(name)) {}
+    
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+    
+    void lock() {
+        // A failed try_lock is what makes an acquisition contended
+        if (mutex.try_lock()) {
+            acquired_at = lock_profile_now_ns();
+            lock_profile_acquired(id, false, 0);
+            return;
+        }
+        uint64_t start = lock_profile_now_ns();
+        mutex.lock();
+        acquired_at = lock_profile_now_ns();
+        lock_profile_acquired(id, true, acquired_at - start);
+    }
+    
+    bool try_lock() {
+        if (!mutex.try_lock()) {
+            return false;
+        }
+        acquired_at = lock_profile_now_ns();
+        lock_profile_acquired(id, false, 0);
+        return true;
+    }
+    
+    void unlock() {
+        lock_profile_released(id, lock_profile_now_ns() - acquired_at);
+        mutex.unlock();
+    }
+
+private:
+    std::mutex mutex;
+    size_t id;
+    uint64_t acquired_at = 0;            // Written only by the holder
+};
+
+#else
+
+class ProfiledMutex : public std::mutex {
+public:
+    explicit ProfiledMutex(const char*) {}
+};
+
+#endif
+
+#endif // LOCK_PROFILER_H
@@ -0,0 +1,98 @@
+/**
+ * @file log_bench.cpp
+ * @brief Producer-side cost of one log call: locked ostream, fprintf and the async logger
+ *
+ * Every thread logs in bursts of half a ring and only the time spent inside
+ * the log calls is counted; the async logger is flushed between bursts, so
+ * no message is dropped and the drain thread's work is not billed to the
+ * producer. The reported ns/op is the average time a thread spends in one
+ * call, including any waiting for the other threads.
+ *
+ * - ostream_mutex: std::endl-terminated line to a shared stream under a mutex,
+ *                  the pattern of the demos' std::cout lines
+ * - fprintf:       a line to a shared FILE*, serialized by the stdio lock
+ * - async:         LOG_INFO into the calling thread's ring
+ * - filtered:      LOG_DEBUG below the compiled-in level, which should cost nothing
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+#include "async_logger.h"
+#include "bench_harness.h"
+
+#if defined(_WIN32)
+static const char* NULL_DEVICE = "NUL";
+#else
+static const char* NULL_DEVICE = "/dev/null";
+#endif
+
+// Calls timed back to back before the async logger is flushed
+static const size_t LOG_BENCH_BURST = LOG_RING_RECORDS / 2;
+
+// Time log_one(thread_index, i) over ops calls per thread
+template <typename Log>
+static void sweep_log(BenchHarness& harness, const std::string& policy, Log log_one) {
+    const std::string name = "log/call";
+    if (!harness.enabled(name)) {
+        return;
+    }
+    const size_t ops = harness.options().ops;
+    for (int threads : harness.thread_sweep()) {
+        harness.run(name, policy, threads, ops * threads, [&]() {
+            std::vector<uint64_t> busy(threads, 0);
+            measure_threads(threads, [&](int index) {
+                for (size_t done = 0; done < ops;) {
+                    size_t burst = std::min(LOG_BENCH_BURST, ops - done);
+                    uint64_t start = bench_now_ns();
+                    for (size_t i = done; i < done + burst; ++i) {
+                        log_one(index, i);
+                    }
+                    busy[index] += bench_now_ns() - start;
+                    done += burst;
+                    log_flush();
+                }
+            });
+            uint64_t total = 0;
+            for (uint64_t ns : busy) {
+                total += ns;
+            }
+            return total;
+        });
+    }
+}
+
+void log_bench(BenchHarness& harness) {
+    std::ofstream null_stream(NULL_DEVICE);
+    std::FILE* null_file = std::fopen(NULL_DEVICE, "w");
+    if (!null_stream || null_file == nullptr) {
+        std::cerr << "log/call: cannot open " << NULL_DEVICE << std::endl;
+        return;
+    }
+    log_set_output(null_file);
+    
+    std::mutex stream_mutex;
+    sweep_log(harness, "ostream_mutex", [&](int index, size_t i) {
+        std::lock_guard<std::mutex> lock(stream_mutex);
+        null_stream << "Thread " << index << " processed item " << i << std::endl;
+    });
+    sweep_log(harness, "fprintf", [&](int index, size_t i) {
+        std::fprintf(null_file, "Thread %d processed item %zu\n", index, i);
+        std::fflush(null_file);
+    });
+    sweep_log(harness, "async", [](int index, size_t i) {
+        LOG_INFO("Thread %d processed item %zu", index, i);
+    });
+    sweep_log(harness, "filtered", [](int index, size_t i) {
+        LOG_DEBUG("Thread %d processed item %zu", index, i);
+    });
+    
+    if (log_dropped() != 0) {
+        std::cerr << "log/call async: " << log_dropped() << " messages dropped" << std::endl;
+    }
+    log_set_output(stdout);
+    std::fclose(null_file);
+}
@@ -3,9 +3,16 @@
  * @brief Main entry point for the C++ threading demos
  */
 
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
-#include <Windows.h>
+#include <vector>
+#include "async_logger.h"
+#include "bench_results.h"
+#include "demo_settings.h"
+#include "trace.h"
 
 // Function declarations from other source files
 extern int thread_basics_main();
@@ -15,6 +22,65 @@ extern int async_patterns_main();
 extern int parallel_algorithms_main();
 extern int data_races_main();
 
+// Individual timed demos that can be selected with --demo
+extern void basic_mutex_demo();
+extern void lock_guard_demo();
+extern void unique_lock_demo();
+extern void rcu_config_demo();
+extern void packaged_task_demo();
+extern void continuation_demo();
+#ifdef CPPTHREADS_COROUTINES
+extern void coroutine_async_demo();
+extern void coroutine_packaged_task_demo();
+extern void coroutine_memory_demo();
+#endif
+extern void atomic_demo();
+extern void basic_atomic_demo();
+extern void memory_ordering_demo();
+extern void parallel_for_each_demo();
+extern void parallel_transform_demo();
+extern void parallel_sort_demo();
+extern void parallel_reduce_demo();
+extern void parallel_transform_reduce_demo();
+extern void parallel_find_demo();
+
+// Demos runnable from the command line, by name
+struct NamedDemo {
+    const char* name;
+    void (*run)();
+};
+
+// Whole-module demos come first; they are the default selection
+const int NUM_MODULE_DEMOS = 6;
+static const NamedDemo named_demos[] = {
+    { "thread_basics", [] { thread_basics_main(); } },
+    { "synchronization", [] { synchronization_main(); } },
+    { "atomic_operations", [] { atomic_operations_main(); } },
+    { "async_patterns", [] { async_patterns_main(); } },
+    { "parallel_algorithms", [] { parallel_algorithms_main(); } },
+    { "data_races", [] { data_races_main(); } },
+    { "basic_mutex", basic_mutex_demo },
+    { "lock_guard", lock_guard_demo },
+    { "unique_lock", unique_lock_demo },
+    { "rcu_config", rcu_config_demo },
+    { "packaged_task", packaged_task_demo },
+    { "continuation", continuation_demo },
+#ifdef CPPTHREADS_COROUTINES
+    { "coroutine_async", coroutine_async_demo },
+    { "coroutine_packaged_task", coroutine_packaged_task_demo },
+    { "coroutine_memory", coroutine_memory_demo },
+#endif
+    { "sync_atomic", atomic_demo },
+    { "basic_atomic", basic_atomic_demo },
+    { "memory_ordering", memory_ordering_demo },
+    { "parallel_for_each", parallel_for_each_demo },
+    { "parallel_transform", parallel_transform_demo },
+    { "parallel_sort", parallel_sort_demo },
+    { "parallel_reduce", parallel_reduce_demo },
+    { "parallel_transform_reduce", parallel_transform_reduce_demo },
+    { "parallel_find", parallel_find_demo },
+};
+
 // Main menu display function
 void display_menu() {
     std::cout << "\n=== C++ Threads Programming Demo Menu ===" << std::endl;
@@ -39,12 +105,185 @@ void run_demo(int (*demo_func)(), const std::string& demo_name) {
     std::cout << "\n\n";
     
     demo_func();
+    log_flush();
     
     std::cout << "\n\n" << demo_name << " completed." << std::endl;
     std::cout << "Press Enter to continue...";
     std::cin.get();
 }
 
+void print_usage() {
+    std::cout << "Usage: CppThreads                 Interactive menu" << std::endl;
+    std::cout << "       CppThreads --run-all       Run every demo once" << std::endl;
+    std::cout << "       CppThreads [options]       Run selected demos without prompting" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --demo=NAME[,NAME...]   Demos to run (see --list; default: all)" << std::endl;
+    std::cout << "  --size=N                Elements or increments per demo, e.g. 1e8" << std::endl;
+    std::cout << "  --threads=N[,N...]      Run each demo once per thread count" << std::endl;
+    std::cout << "  --repeat=N              Repetitions; reports give the median" << std::endl;
+    std::cout << "  --format=FORMAT         text, json or csv timing report" << std::endl;
+    std::cout << "  --output=FILE           Write the report to FILE instead of the console" << std::endl;
+    std::cout << "  --trace=FILE            Record a Chrome trace (chrome://tracing, ui.perfetto.dev) to FILE" << std::endl;
+    std::cout << "  --perf                  Print perf_event counters around timed sections (Linux)" << std::endl;
+    std::cout << "  --list                  List the demo names" << std::endl;
+}
+
+// Split "a,b,c" into its parts
+std::vector<std::string> split_list(const std::string& text) {
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, ',')) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+// Value of a --name=value argument, or nullptr when arg is a different option
+const char* option_value(const std::string& arg, const std::string& name) {
+    std::string prefix = "--" + name + "=";
+    return arg.compare(0, prefix.size(), prefix) == 0 ? arg.c_str() + prefix.size() : nullptr;
+}
+
+// Run demos from command-line options; returns the process exit status
+int run_batch(int argc, char* argv[]) {
+    std::vector<const NamedDemo*> demos;
+    std::vector<int> thread_counts;
+    size_t size = 0;
+    int repeat = 1;
+    ResultFormat format = ResultFormat::Text;
+    std::string output_path;
+    std::string trace_path;
+    bool perf = false;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = nullptr;
+        if (arg == "--list") {
+            for (const auto& demo : named_demos) {
+                std::cout << demo.name << std::endl;
+            }
+            return 0;
+        } else if (arg == "--perf") {
+            perf = true;
+        } else if ((value = option_value(arg, "demo")) != nullptr) {
+            for (const auto& name : split_list(value)) {
+                const NamedDemo* found = nullptr;
+                for (const auto& demo : named_demos) {
+                    if (name == demo.name) {
+                        found = &demo;
+                    }
+                }
+                if (found == nullptr) {
+                    std::cerr << "Unknown demo: " << name << " (see --list)" << std::endl;
+                    return 1;
+                }
+                demos.push_back(found);
+            }
+        } else if ((value = option_value(arg, "size")) != nullptr) {
+            size = static_cast<size_t>(std::atof(value));
+        } else if ((value = option_value(arg, "threads")) != nullptr) {
+            for (const auto& count : split_list(value)) {
+                thread_counts.push_back(std::atoi(count.c_str()));
+            }
+        } else if ((value = option_value(arg, "repeat")) != nullptr) {
+            repeat = std::atoi(value);
+        } else if ((value = option_value(arg, "format")) != nullptr) {
+            if (!parse_result_format(value, format)) {
+                print_usage();
+                return 1;
+            }
+        } else if ((value = option_value(arg, "output")) != nullptr) {
+            output_path = value;
+        } else if ((value = option_value(arg, "trace")) != nullptr) {
+            trace_path = value;
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    
+    for (int count : thread_counts) {
+        if (count <= 0) {
+            print_usage();
+            return 1;
+        }
+    }
+    if (repeat <= 0 || (size > 0 && size < 1000)) {
+        print_usage();
+        return 1;
+    }
+    
+    // Defaults: every module demo, each demo's own thread count
+    if (demos.empty()) {
+        for (int i = 0; i < NUM_MODULE_DEMOS; i++) {
+            demos.push_back(&named_demos[i]);
+        }
+    }
+    if (thread_counts.empty()) {
+        thread_counts.push_back(0);
+    }
+    
+    std::ofstream output_file;
+    if (!output_path.empty()) {
+        output_file.open(output_path);
+        if (!output_file) {
+            std::cerr << "Cannot write " << output_path << std::endl;
+            return 1;
+        }
+    }
+    
+    // A JSON or CSV report on the console must not be mixed with demo chatter
+    std::ostream report(output_path.empty() ? std::cout.rdbuf() : output_file.rdbuf());
+    std::ostringstream discarded;
+    std::streambuf* console = std::cout.rdbuf();
+    bool quiet = output_path.empty() && format != ResultFormat::Text;
+    if (quiet) {
+        log_set_output(nullptr);
+    }
+    
+    demo_settings().size = size;
+    demo_settings().perf = perf;
+    if (!trace_path.empty()) {
+        trace_thread_name("main");
+        trace_start();
+    }
+    for (int r = 0; r < repeat; r++) {
+        for (int threads : thread_counts) {
+            demo_settings().threads = threads;
+            for (const NamedDemo* demo : demos) {
+                if (quiet) {
+                    discarded.str("");
+                    std::cout.rdbuf(discarded.rdbuf());
+                }
+                demo->run();
+                log_flush();
+                std::cout.rdbuf(console);
+            }
+        }
+    }
+    if (!trace_path.empty()) {
+        trace_stop();
+        if (!trace_write(trace_path)) {
+            std::cerr << "Cannot write " << trace_path << std::endl;
+            return 1;
+        }
+    }
+    
+    if (format == ResultFormat::Text) {
+        report << "\n=== Timing Summary (median of " << repeat << " run(s)) ===" << std::endl;
+    }
+    {
+        ResultSink sink(format, report);
+        for (const auto& result : demo_results()) {
+            sink.write(result);
+        }
+    }
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     int choice;
     bool interactive = true;
@@ -58,6 +297,10 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    // Any other option selects the non-interactive batch runner
+    if (interactive && argc > 1) {
+        return run_batch(argc, argv);
+    }
     // Interactive mode or automatic run-all mode
     if (interactive) {
         do {
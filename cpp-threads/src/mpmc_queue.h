@@ -0,0 +1,104 @@
+/**
+ * @file mpmc_queue.h
+ * @brief Bounded lock-free multi-producer/multi-consumer queue (Dmitry Vyukov's design)
+ *
+ * Every slot carries a sequence number that says whose turn it is. A slot
+ * at position pos is free for the producer of ticket pos when its sequence
+ * equals pos, and holds an item for the consumer of ticket pos when its
+ * sequence equals pos + 1. Producers and consumers claim tickets with a CAS
+ * on their own position counter and then hand the slot over by publishing
+ * the next sequence number with release ordering, so any number of threads
+ * can use both ends at once and every item is delivered exactly once.
+ */
+
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+template <typename T, size_t Capacity>
+class MpmcQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "MpmcQueue capacity must be a power of two");
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+    
+    static const size_t MASK = Capacity - 1;
+    
+    // The two ends live on separate cache lines so producers and consumers do not collide
+    alignas(64) Cell cells[Capacity];
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) std::atomic<size_t> dequeue_pos{0};
+
+public:
+    MpmcQueue() {
+        for (size_t i = 0; i < Capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+    
+    // False when the queue is full
+    bool enqueue(T value) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & MASK];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                // The slot is free for this ticket; claim the ticket
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // The slot still holds the item from one lap ago
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);  // Another producer took it
+            }
+        }
+        
+        cell->data = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // False when the queue is empty
+    bool dequeue(T& result) {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & MASK];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // No producer has filled this slot yet
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        
+        result = std::move(cell->data);
+        
+        // Free the slot for the producer one lap ahead
+        cell->sequence.store(pos + MASK + 1, std::memory_order_release);
+        return true;
+    }
+    
+    static constexpr size_t capacity() { return Capacity; }
+};
+
+#endif // MPMC_QUEUE_H
@@ -13,25 +13,91 @@
 #include <string>
 #include <functional>
 #include <iomanip>
+#include <memory>
+#include <thread>
+#include "demo_settings.h"
+#include "parallel_sort.h"
+#include "perf_counters.h"
+#include "pool_execution.h"
+#include "task_pool.h"
 
-// Function to measure execution time of a function
+// Print the counters of one measured region (--perf)
+void print_perf(const std::string& label, const PerfSample& sample) {
+    if (!sample.any_valid()) {
+        static bool reported = false;
+        if (!reported) {
+            std::cout << "  perf counters unavailable: " << perf_unavailable_reason() << std::endl;
+            reported = true;
+        }
+        return;
+    }
+    std::cout << "  perf " << label << ": " << format_perf_sample(sample) << std::endl;
+}
+
+// Function to measure execution time of a function; with --perf the
+// region is also wrapped in perf_event counters, opened outside the timing
 template<typename Func, typename... Args>
-auto measure_time(Func func, Args&&... args) {
+auto measure_time(const std::string& label, Func func, Args&&... args) {
+    PerfCounters counters;
+    if (demo_settings().perf) {
+        counters.start();
+    }
+    
     auto start = std::chrono::high_resolution_clock::now();
     
     // Call the function with its arguments
     auto result = func(std::forward<Args>(args)...);
     
     auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
     
-    return std::make_pair(result, duration.count());
+    if (demo_settings().perf) {
+        print_perf(label, counters.stop());
+    }
+    
+    return std::make_pair(result, duration);
 }
 
 // Function to print duration with formatted output
-void print_duration(const std::string& label, long duration) {
+void print_duration(const std::string& label, std::chrono::nanoseconds duration) {
     std::cout << std::left << std::setw(25) << label << ": " 
-              << duration << " ms" << std::endl;
+              << std::fixed << std::setprecision(2) << duration.count() / 1e6 << " ms" << std::endl;
+}
+
+// Speedup of a parallel run over the sequential one
+float speedup(std::chrono::nanoseconds seq_time, std::chrono::nanoseconds par_time) {
+    return static_cast<float>(seq_time.count()) / static_cast<float>(std::max<long long>(par_time.count(), 1));
+}
+
+// Keep the timings of one algorithm for --format=json/csv reports; the
+// parallel policies run on the implementation's default thread count
+void record_policies(const std::string& demo, size_t size, std::chrono::nanoseconds seq_time,
+                     std::chrono::nanoseconds par_time, std::chrono::nanoseconds par_unseq_time) {
+    const int hardware_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    demo_record(demo, "seq", 1, size, seq_time);
+    demo_record(demo, "par", hardware_threads, size, par_time);
+    demo_record(demo, "par_unseq", hardware_threads, size, par_unseq_time);
+}
+
+// Persistent pool behind the project's own parallel policy, sized by
+// --threads; it is only restarted when the thread count changes
+TaskPool& demo_pool() {
+    static std::unique_ptr<TaskPool> pool;
+    const int threads = demo_threads(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+    if (!pool || pool->size() != threads) {
+        pool.reset();
+        pool = std::make_unique<TaskPool>(threads);
+    }
+    return *pool;
+}
+
+// Print and record the pool policy timing of one algorithm
+void report_pool(const std::string& demo, const std::string& label, size_t size,
+                 std::chrono::nanoseconds seq_time, std::chrono::nanoseconds pool_time) {
+    print_duration(label, pool_time);
+    demo_record(demo, "pool_par", demo_pool().size(), size, pool_time);
+    std::cout << label << " speedup (" << demo_pool().size() << " threads): " << std::fixed
+              << std::setprecision(2) << speedup(seq_time, pool_time) << "x" << std::endl;
 }
 
 // Fill a vector with random integers
@@ -50,7 +116,7 @@ void parallel_for_each_demo() {
     std::cout << "\n=== std::for_each with Parallel Execution Policies ===" << std::endl;
     
     // Create a large vector
-    const size_t size = 10'000'000;
+    const size_t size = demo_size(10'000'000);
     std::vector<int> data(size);
     fill_random(data, 1, 100);
     
@@ -60,34 +126,43 @@ void parallel_for_each_demo() {
     };
     
     // Sequential execution
-    auto [_, seq_time] = measure_time([&data, &process]() {
+    auto [_, seq_time] = measure_time("Sequential", [&data, &process]() {
         std::for_each(std::execution::seq, data.begin(), data.end(), process);
         return 0;
     });
     
     // Parallel execution
-    auto [__, par_time] = measure_time([&data, &process]() {
+    auto [__, par_time] = measure_time("Parallel", [&data, &process]() {
         std::for_each(std::execution::par, data.begin(), data.end(), process);
         return 0;
     });
     
     // Parallel unsequenced execution
-    auto [___, par_unseq_time] = measure_time([&data, &process]() {
+    auto [___, par_unseq_time] = measure_time("Parallel Unsequenced", [&data, &process]() {
         std::for_each(std::execution::par_unseq, data.begin(), data.end(), process);
         return 0;
     });
     
+    // The project's own parallel policy
+    PoolPolicy pool_policy(demo_pool());
+    auto [____, pool_time] = measure_time("Pool Parallel", [&data, &process, &pool_policy]() {
+        pool_for_each(pool_policy, data.begin(), data.end(), process);
+        return 0;
+    });
+    
     // Print execution times
     print_duration("Sequential", seq_time);
     print_duration("Parallel", par_time);
     print_duration("Parallel Unsequenced", par_unseq_time);
+    record_policies("parallel_for_each", size, seq_time, par_time, par_unseq_time);
     
     // Calculate speedup
-    float par_speedup = static_cast<float>(seq_time) / par_time;
-    float par_unseq_speedup = static_cast<float>(seq_time) / par_unseq_time;
+    float par_speedup = speedup(seq_time, par_time);
+    float par_unseq_speedup = speedup(seq_time, par_unseq_time);
     
     std::cout << "Parallel speedup: " << std::fixed << std::setprecision(2) << par_speedup << "x" << std::endl;
     std::cout << "Parallel unsequenced speedup: " << std::fixed << std::setprecision(2) << par_unseq_speedup << "x" << std::endl;
+    report_pool("parallel_for_each", "Pool Parallel", size, seq_time, pool_time);
 }
 
 // Parallel transform demonstration
@@ -95,7 +170,7 @@ void parallel_transform_demo() {
     std::cout << "\n=== std::transform with Parallel Execution Policies ===" << std::endl;
     
     // Create a large vector
-    const size_t size = 10'000'000;
+    const size_t size = demo_size(10'000'000);
     std::vector<int> input(size);
     std::vector<int> output(size);
     fill_random(input, 1, 100);
@@ -106,7 +181,7 @@ void parallel_transform_demo() {
     };
     
     // Sequential execution
-    auto [_, seq_time] = measure_time([&input, &output, &transform_func]() {
+    auto [_, seq_time] = measure_time("Sequential", [&input, &output, &transform_func]() {
         std::transform(std::execution::seq, 
                      input.begin(), input.end(), 
                      output.begin(), 
@@ -115,7 +190,7 @@ void parallel_transform_demo() {
     });
     
     // Parallel execution
-    auto [__, par_time] = measure_time([&input, &output, &transform_func]() {
+    auto [__, par_time] = measure_time("Parallel", [&input, &output, &transform_func]() {
         std::transform(std::execution::par, 
                      input.begin(), input.end(), 
                      output.begin(), 
@@ -124,7 +199,7 @@ void parallel_transform_demo() {
     });
     
     // Parallel unsequenced execution
-    auto [___, par_unseq_time] = measure_time([&input, &output, &transform_func]() {
+    auto [___, par_unseq_time] = measure_time("Parallel Unsequenced", [&input, &output, &transform_func]() {
         std::transform(std::execution::par_unseq, 
                      input.begin(), input.end(), 
                      output.begin(), 
@@ -132,66 +207,99 @@ void parallel_transform_demo() {
         return 0;
     });
     
+    // The project's own parallel policy
+    PoolPolicy pool_policy(demo_pool());
+    auto [____, pool_time] = measure_time("Pool Parallel", [&input, &output, &transform_func, &pool_policy]() {
+        pool_transform(pool_policy,
+                       input.begin(), input.end(),
+                       output.begin(),
+                       transform_func);
+        return 0;
+    });
+    
     // Print execution times
     print_duration("Sequential", seq_time);
     print_duration("Parallel", par_time);
     print_duration("Parallel Unsequenced", par_unseq_time);
+    record_policies("parallel_transform", size, seq_time, par_time, par_unseq_time);
     
     // Calculate speedup
-    float par_speedup = static_cast<float>(seq_time) / par_time;
-    float par_unseq_speedup = static_cast<float>(seq_time) / par_unseq_time;
+    float par_speedup = speedup(seq_time, par_time);
+    float par_unseq_speedup = speedup(seq_time, par_unseq_time);
     
     std::cout << "Parallel speedup: " << std::fixed << std::setprecision(2) << par_speedup << "x" << std::endl;
     std::cout << "Parallel unsequenced speedup: " << std::fixed << std::setprecision(2) << par_unseq_speedup << "x" << std::endl;
+    report_pool("parallel_transform", "Pool Parallel", size, seq_time, pool_time);
 }
 
-// Parallel sort demonstration
+// Parallel sort demonstration: the standard policies against the task pool
+// sorts of parallel_sort.h, all on copies of the same input
 void parallel_sort_demo() {
     std::cout << "\n=== std::sort with Parallel Execution Policies ===" << std::endl;
     
     // Create a large vector
-    const size_t size = 10'000'000;
-    
-    // Function to create and return a sorted copy of the data
-    auto sorted_copy = [size]() {
-        // Create the vector
-        std::vector<int> data(size);
-        fill_random(data, 1, 1'000'000);
-        return data;
-    };
+    const size_t size = demo_size(10'000'000);
+    std::vector<int> input(size);
+    fill_random(input, 1, 1'000'000);
     
     // Sequential sort
-    auto data1 = sorted_copy();
-    auto [_, seq_time] = measure_time([&data1]() {
+    auto data1 = input;
+    auto [_, seq_time] = measure_time("Sequential Sort", [&data1]() {
         std::sort(std::execution::seq, data1.begin(), data1.end());
         return 0;
     });
     
     // Parallel sort
-    auto data2 = sorted_copy();
-    auto [__, par_time] = measure_time([&data2]() {
+    auto data2 = input;
+    auto [__, par_time] = measure_time("Parallel Sort", [&data2]() {
         std::sort(std::execution::par, data2.begin(), data2.end());
         return 0;
     });
     
     // Parallel unsequenced sort
-    auto data3 = sorted_copy();
-    auto [___, par_unseq_time] = measure_time([&data3]() {
+    auto data3 = input;
+    auto [___, par_unseq_time] = measure_time("Parallel Unsequenced Sort", [&data3]() {
         std::sort(std::execution::par_unseq, data3.begin(), data3.end());
         return 0;
     });
     
+    // The project's own sorts; the pool is started before timing
+    TaskPool& pool = demo_pool();
+    auto data4 = input;
+    auto [____, merge_time] = measure_time("Task Pool Merge Sort", [&pool, &data4]() {
+        parallel_merge_sort(pool, data4);
+        return 0;
+    });
+    
+    auto data5 = input;
+    auto [_____, radix_time] = measure_time("Task Pool Radix Sort", [&pool, &data5]() {
+        parallel_radix_sort(pool, data5);
+        return 0;
+    });
+    
     // Print execution times
     print_duration("Sequential Sort", seq_time);
     print_duration("Parallel Sort", par_time);
     print_duration("Parallel Unsequenced Sort", par_unseq_time);
+    print_duration("Task Pool Merge Sort", merge_time);
+    print_duration("Task Pool Radix Sort", radix_time);
+    record_policies("parallel_sort", size, seq_time, par_time, par_unseq_time);
+    demo_record("parallel_sort", "pool_merge", pool.size(), size, merge_time);
+    demo_record("parallel_sort", "pool_radix", pool.size(), size, radix_time);
+    
+    bool all_sorted = data2 == data1 && data3 == data1 && data4 == data1 && data5 == data1;
+    std::cout << "All results match the sequential sort: " << (all_sorted ? "Yes" : "No") << std::endl;
     
     // Calculate speedup
-    float par_speedup = static_cast<float>(seq_time) / par_time;
-    float par_unseq_speedup = static_cast<float>(seq_time) / par_unseq_time;
+    float par_speedup = speedup(seq_time, par_time);
+    float par_unseq_speedup = speedup(seq_time, par_unseq_time);
+    float merge_speedup = speedup(seq_time, merge_time);
+    float radix_speedup = speedup(seq_time, radix_time);
     
     std::cout << "Parallel sort speedup: " << std::fixed << std::setprecision(2) << par_speedup << "x" << std::endl;
     std::cout << "Parallel unsequenced sort speedup: " << std::fixed << std::setprecision(2) << par_unseq_speedup << "x" << std::endl;
+    std::cout << "Task pool merge sort speedup (" << pool.size() << " threads): " << std::fixed << std::setprecision(2) << merge_speedup << "x" << std::endl;
+    std::cout << "Task pool radix sort speedup (" << pool.size() << " threads): " << std::fixed << std::setprecision(2) << radix_speedup << "x" << std::endl;
 }
 
 // Parallel reduce demonstration
@@ -199,39 +307,48 @@ void parallel_reduce_demo() {
     std::cout << "\n=== std::reduce with Parallel Execution Policies ===" << std::endl;
     
     // Create a large vector
-    const size_t size = 100'000'000;
+    const size_t size = demo_size(100'000'000);
     std::vector<double> data(size, 1.0);  // Initialize with 1.0
     
     // Sequential reduce (same as std::accumulate)
-    auto [seq_result, seq_time] = measure_time([&data]() {
+    auto [seq_result, seq_time] = measure_time("Sequential Reduce", [&data]() {
         return std::reduce(std::execution::seq, data.begin(), data.end(), 0.0);
     });
     
     // Parallel reduce
-    auto [par_result, par_time] = measure_time([&data]() {
+    auto [par_result, par_time] = measure_time("Parallel Reduce", [&data]() {
         return std::reduce(std::execution::par, data.begin(), data.end(), 0.0);
     });
     
     // Parallel unsequenced reduce
-    auto [par_unseq_result, par_unseq_time] = measure_time([&data]() {
+    auto [par_unseq_result, par_unseq_time] = measure_time("Parallel Unsequenced Reduce", [&data]() {
         return std::reduce(std::execution::par_unseq, data.begin(), data.end(), 0.0);
     });
     
+    // The project's own parallel policy
+    PoolPolicy pool_policy(demo_pool());
+    auto [pool_result, pool_time] = measure_time("Pool Parallel Reduce", [&data, &pool_policy]() {
+        return pool_reduce(pool_policy, data.begin(), data.end(), 0.0);
+    });
+    
     // Print results and execution times
     std::cout << "Sequential reduce result: " << seq_result << std::endl;
     std::cout << "Parallel reduce result: " << par_result << std::endl;
     std::cout << "Parallel unsequenced reduce result: " << par_unseq_result << std::endl;
+    std::cout << "Pool parallel reduce result: " << pool_result << std::endl;
     
     print_duration("Sequential Reduce", seq_time);
     print_duration("Parallel Reduce", par_time);
     print_duration("Parallel Unsequenced Reduce", par_unseq_time);
+    record_policies("parallel_reduce", size, seq_time, par_time, par_unseq_time);
     
     // Calculate speedup
-    float par_speedup = static_cast<float>(seq_time) / par_time;
-    float par_unseq_speedup = static_cast<float>(seq_time) / par_unseq_time;
+    float par_speedup = speedup(seq_time, par_time);
+    float par_unseq_speedup = speedup(seq_time, par_unseq_time);
     
     std::cout << "Parallel reduce speedup: " << std::fixed << std::setprecision(2) << par_speedup << "x" << std::endl;
     std::cout << "Parallel unsequenced reduce speedup: " << std::fixed << std::setprecision(2) << par_unseq_speedup << "x" << std::endl;
+    report_pool("parallel_reduce", "Pool Parallel Reduce", size, seq_time, pool_time);
 }
 
 // Parallel transform_reduce demonstration
@@ -239,7 +356,7 @@ void parallel_transform_reduce_demo() {
     std::cout << "\n=== std::transform_reduce with Parallel Execution Policies ===" << std::endl;
     
     // Create two large vectors
-    const size_t size = 50'000'000;
+    const size_t size = demo_size(50'000'000);
     std::vector<double> v1(size);
     std::vector<double> v2(size);
     
@@ -255,7 +372,7 @@ void parallel_transform_reduce_demo() {
     
     // Compute dot product: sum(v1[i] * v2[i])
     // Sequential transform_reduce
-    auto [seq_result, seq_time] = measure_time([&v1, &v2]() {
+    auto [seq_result, seq_time] = measure_time("Sequential", [&v1, &v2]() {
         return std::transform_reduce(std::execution::seq,
                                   v1.begin(), v1.end(),
                                   v2.begin(),
@@ -263,7 +380,7 @@ void parallel_transform_reduce_demo() {
     });
     
     // Parallel transform_reduce
-    auto [par_result, par_time] = measure_time([&v1, &v2]() {
+    auto [par_result, par_time] = measure_time("Parallel", [&v1, &v2]() {
         return std::transform_reduce(std::execution::par,
                                   v1.begin(), v1.end(),
                                   v2.begin(),
@@ -271,28 +388,40 @@ void parallel_transform_reduce_demo() {
     });
     
     // Parallel unsequenced transform_reduce
-    auto [par_unseq_result, par_unseq_time] = measure_time([&v1, &v2]() {
+    auto [par_unseq_result, par_unseq_time] = measure_time("Parallel Unsequenced", [&v1, &v2]() {
         return std::transform_reduce(std::execution::par_unseq,
                                   v1.begin(), v1.end(),
                                   v2.begin(),
                                   0.0);
     });
     
+    // The project's own parallel policy
+    PoolPolicy pool_policy(demo_pool());
+    auto [pool_result, pool_time] = measure_time("Pool Parallel", [&v1, &v2, &pool_policy]() {
+        return pool_transform_reduce(pool_policy,
+                                     v1.begin(), v1.end(),
+                                     v2.begin(),
+                                     0.0);
+    });
+    
     // Print results and execution times
     std::cout << "Dot product sequential: " << seq_result << std::endl;
     std::cout << "Dot product parallel: " << par_result << std::endl;
     std::cout << "Dot product parallel unsequenced: " << par_unseq_result << std::endl;
+    std::cout << "Dot product pool parallel: " << pool_result << std::endl;
     
     print_duration("Sequential", seq_time);
     print_duration("Parallel", par_time);
     print_duration("Parallel Unsequenced", par_unseq_time);
+    record_policies("parallel_transform_reduce", size, seq_time, par_time, par_unseq_time);
     
     // Calculate speedup
-    float par_speedup = static_cast<float>(seq_time) / par_time;
-    float par_unseq_speedup = static_cast<float>(seq_time) / par_unseq_time;
+    float par_speedup = speedup(seq_time, par_time);
+    float par_unseq_speedup = speedup(seq_time, par_unseq_time);
     
     std::cout << "Parallel speedup: " << std::fixed << std::setprecision(2) << par_speedup << "x" << std::endl;
     std::cout << "Parallel unsequenced speedup: " << std::fixed << std::setprecision(2) << par_unseq_speedup << "x" << std::endl;
+    report_pool("parallel_transform_reduce", "Pool Parallel", size, seq_time, pool_time);
 }
 
 // Find first occurrence in parallel
@@ -300,43 +429,50 @@ void parallel_find_demo() {
     std::cout << "\n=== std::find and std::find_if with Parallel Execution Policies ===" << std::endl;
     
     // Create a large vector
-    const size_t size = 100'000'000;
+    const size_t size = demo_size(100'000'000);
     std::vector<int> data(size);
     
     // Fill with ascending values
     std::iota(data.begin(), data.end(), 0);
     
     // Value to find (near the end of the vector to maximize search time)
-    const int value_to_find = size - 100;
+    const int value_to_find = static_cast<int>(size) - 100;
     
     // Predicate for find_if
     auto is_target = [value_to_find](int x) { return x == value_to_find; };
     
     // Sequential find
-    auto [seq_result, seq_time] = measure_time([&data, value_to_find]() {
+    auto [seq_result, seq_time] = measure_time("Sequential find", [&data, value_to_find]() {
         return std::find(std::execution::seq, data.begin(), data.end(), value_to_find);
     });
     
     // Parallel find
-    auto [par_result, par_time] = measure_time([&data, value_to_find]() {
+    auto [par_result, par_time] = measure_time("Parallel find", [&data, value_to_find]() {
         return std::find(std::execution::par, data.begin(), data.end(), value_to_find);
     });
     
     // Sequential find_if
-    auto [seq_if_result, seq_if_time] = measure_time([&data, &is_target]() {
+    auto [seq_if_result, seq_if_time] = measure_time("Sequential find_if", [&data, &is_target]() {
         return std::find_if(std::execution::seq, data.begin(), data.end(), is_target);
     });
     
     // Parallel find_if
-    auto [par_if_result, par_if_time] = measure_time([&data, &is_target]() {
+    auto [par_if_result, par_if_time] = measure_time("Parallel find_if", [&data, &is_target]() {
         return std::find_if(std::execution::par, data.begin(), data.end(), is_target);
     });
     
+    // The project's own parallel policy
+    PoolPolicy pool_policy(demo_pool());
+    auto [pool_if_result, pool_if_time] = measure_time("Pool Parallel find_if", [&data, &is_target, &pool_policy]() {
+        return pool_find_if(pool_policy, data.begin(), data.end(), is_target);
+    });
+    
     // Verify all results are correct
     if (*seq_result == value_to_find && 
         *par_result == value_to_find &&
         *seq_if_result == value_to_find &&
-        *par_if_result == value_to_find) {
+        *par_if_result == value_to_find &&
+        *pool_if_result == value_to_find) {
         std::cout << "All find operations found the correct value: " << value_to_find << std::endl;
     } else {
         std::cout << "Error: Not all find operations found the correct value!" << std::endl;
@@ -348,12 +484,20 @@ void parallel_find_demo() {
     print_duration("Sequential find_if", seq_if_time);
     print_duration("Parallel find_if", par_if_time);
     
+    // Keep the timings for --format=json/csv reports
+    const int hardware_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    demo_record("parallel_find", "seq", 1, size, seq_time);
+    demo_record("parallel_find", "par", hardware_threads, size, par_time);
+    demo_record("parallel_find_if", "seq", 1, size, seq_if_time);
+    demo_record("parallel_find_if", "par", hardware_threads, size, par_if_time);
+    
     // Calculate speedup
-    float find_speedup = static_cast<float>(seq_time) / par_time;
-    float find_if_speedup = static_cast<float>(seq_if_time) / par_if_time;
+    float find_speedup = speedup(seq_time, par_time);
+    float find_if_speedup = speedup(seq_if_time, par_if_time);
     
     std::cout << "Parallel find speedup: " << std::fixed << std::setprecision(2) << find_speedup << "x" << std::endl;
     std::cout << "Parallel find_if speedup: " << std::fixed << std::setprecision(2) << find_if_speedup << "x" << std::endl;
+    report_pool("parallel_find_if", "Pool Parallel find_if", size, seq_if_time, pool_if_time);
 }
 
 // Main function to run the parallel algorithms demos
@@ -0,0 +1,231 @@
+/**
+ * @file parallel_bench.cpp
+ * @brief Parallel algorithm benchmarks: the algorithms of parallel_algorithms.cpp under seq, par and par_unseq
+ *
+ * The standard execution policies do not let the caller pick a thread count,
+ * so the parallel policies are reported with the implementation's default
+ * (the number of hardware threads) instead of being swept. The project's
+ * own pool policy (pool_par) and the task pool sorts of parallel_sort.h run
+ * next to them and are swept.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_harness.h"
+#include "parallel_sort.h"
+#include "pool_execution.h"
+#include "task_pool.h"
+
+// Deterministic input so every run and every policy sees the same data
+static std::vector<int> random_ints(size_t size, int min, int max) {
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<> distrib(min, max);
+    std::vector<int> data(size);
+    for (auto& element : data) {
+        element = distrib(gen);
+    }
+    return data;
+}
+
+// Fail the run when one of the project's own sorts left data out of order
+template <typename T>
+static void check_sorted(BenchHarness& harness, const std::string& name, const std::string& policy, int threads,
+                         const std::vector<T>& data) {
+    if (!std::is_sorted(data.begin(), data.end())) {
+        harness.report_failure(name + " " + policy + " " + std::to_string(threads) + " threads: output not sorted");
+    }
+}
+
+// Run body once per execution policy; body(policy) does the timed work
+template <typename Body>
+static void for_each_policy(BenchHarness& harness, const std::string& name, size_t elements, Body body) {
+    if (!harness.enabled(name)) {
+        return;
+    }
+    const int hardware_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    
+    harness.run(name, "seq", 1, elements, [&]() { return body(std::execution::seq); });
+    harness.run(name, "par", hardware_threads, elements, [&]() { return body(std::execution::par); });
+    harness.run(name, "par_unseq", hardware_threads, elements, [&]() { return body(std::execution::par_unseq); });
+}
+
+// Run body with the project's pool policy (pool_execution.h) at every thread
+// count of the sweep; body(policy) does the timed work
+template <typename Body>
+static void for_each_pool_size(BenchHarness& harness, const std::string& name, size_t elements, Body body) {
+    if (!harness.enabled(name)) {
+        return;
+    }
+    for (int threads : harness.thread_sweep()) {
+        TaskPool pool(threads);
+        PoolPolicy policy(pool);
+        harness.run(name, "pool_par", threads, elements, [&]() { return body(policy); });
+    }
+}
+
+void parallel_bench(BenchHarness& harness) {
+    const size_t size = harness.options().size;
+    const std::vector<int> input = random_ints(size, 1, 1'000'000);
+    std::vector<int> work(size);
+    std::vector<double> v1(size, 0.5);
+    std::vector<double> v2(size, 2.0);
+    
+    for_each_policy(harness, "parallel/for_each", size, [&](auto policy) {
+        std::copy(input.begin(), input.end(), work.begin());
+        uint64_t start = bench_now_ns();
+        std::for_each(policy, work.begin(), work.end(), [](int& x) {
+            x = static_cast<int>(std::sqrt(x) * 10);
+        });
+        return bench_now_ns() - start;
+    });
+    for_each_pool_size(harness, "parallel/for_each", size, [&](const PoolPolicy& policy) {
+        std::copy(input.begin(), input.end(), work.begin());
+        uint64_t start = bench_now_ns();
+        pool_for_each(policy, work.begin(), work.end(), [](int& x) {
+            x = static_cast<int>(std::sqrt(x) * 10);
+        });
+        return bench_now_ns() - start;
+    });
+    
+    for_each_policy(harness, "parallel/transform", size, [&](auto policy) {
+        uint64_t start = bench_now_ns();
+        std::transform(policy, input.begin(), input.end(), work.begin(), [](int x) {
+            return static_cast<int>(std::pow(x, 1.5));
+        });
+        return bench_now_ns() - start;
+    });
+    for_each_pool_size(harness, "parallel/transform", size, [&](const PoolPolicy& policy) {
+        uint64_t start = bench_now_ns();
+        pool_transform(policy, input.begin(), input.end(), work.begin(), [](int x) {
+            return static_cast<int>(std::pow(x, 1.5));
+        });
+        return bench_now_ns() - start;
+    });
+    
+    // Sorting is destructive, so each run sorts a fresh copy made outside the timer
+    for_each_policy(harness, "parallel/sort", size, [&](auto policy) {
+        std::copy(input.begin(), input.end(), work.begin());
+        uint64_t start = bench_now_ns();
+        std::sort(policy, work.begin(), work.end());
+        return bench_now_ns() - start;
+    });
+    
+    // The task pool sorts take a thread count, so unlike the policies they are swept
+    if (harness.enabled("parallel/sort")) {
+        for (int threads : harness.thread_sweep()) {
+            TaskPool pool(threads);
+            harness.run("parallel/sort", "pool_merge", threads, size, [&]() {
+                std::copy(input.begin(), input.end(), work.begin());
+                uint64_t start = bench_now_ns();
+                pool_sort(PoolPolicy(pool), work.begin(), work.end());
+                uint64_t elapsed = bench_now_ns() - start;
+                check_sorted(harness, "parallel/sort", "pool_merge", threads, work);
+                return elapsed;
+            });
+            harness.run("parallel/sort", "pool_radix", threads, size, [&]() {
+                std::copy(input.begin(), input.end(), work.begin());
+                uint64_t start = bench_now_ns();
+                parallel_radix_sort(pool, work);
+                uint64_t elapsed = bench_now_ns() - start;
+                check_sorted(harness, "parallel/sort", "pool_radix", threads, work);
+                return elapsed;
+            });
+        }
+    }
+    
+    // 64-bit keys use all eight radix passes
+    if (harness.enabled("parallel/sort64")) {
+        std::mt19937_64 gen(12345);
+        std::vector<uint64_t> input64(size);
+        for (auto& element : input64) {
+            element = gen();
+        }
+        std::vector<uint64_t> work64(size);
+        for_each_policy(harness, "parallel/sort64", size, [&](auto policy) {
+            std::copy(input64.begin(), input64.end(), work64.begin());
+            uint64_t start = bench_now_ns();
+            std::sort(policy, work64.begin(), work64.end());
+            return bench_now_ns() - start;
+        });
+        for (int threads : harness.thread_sweep()) {
+            TaskPool pool(threads);
+            harness.run("parallel/sort64", "pool_radix", threads, size, [&]() {
+                std::copy(input64.begin(), input64.end(), work64.begin());
+                uint64_t start = bench_now_ns();
+                parallel_radix_sort(pool, work64);
+                uint64_t elapsed = bench_now_ns() - start;
+                check_sorted(harness, "parallel/sort64", "pool_radix", threads, work64);
+                return elapsed;
+            });
+        }
+    }
+    
+    for_each_policy(harness, "parallel/reduce", size, [&](auto policy) {
+        uint64_t start = bench_now_ns();
+        double sum = std::reduce(policy, v1.begin(), v1.end(), 0.0);
+        uint64_t elapsed = bench_now_ns() - start;
+        do_not_optimize(sum);
+        return elapsed;
+    });
+    for_each_pool_size(harness, "parallel/reduce", size, [&](const PoolPolicy& policy) {
+        uint64_t start = bench_now_ns();
+        double sum = pool_reduce(policy, v1.begin(), v1.end(), 0.0);
+        uint64_t elapsed = bench_now_ns() - start;
+        // Halves add up exactly, so a lost or repeated chunk shows as a different sum
+        if (sum != static_cast<double>(size) * 0.5) {
+            harness.report_failure("parallel/reduce pool_par: sum " + std::to_string(sum) + ", expected " +
+                                   std::to_string(static_cast<double>(size) * 0.5));
+        }
+        return elapsed;
+    });
+    
+    for_each_policy(harness, "parallel/transform_reduce", size, [&](auto policy) {
+        uint64_t start = bench_now_ns();
+        double dot = std::transform_reduce(policy, v1.begin(), v1.end(), v2.begin(), 0.0);
+        uint64_t elapsed = bench_now_ns() - start;
+        do_not_optimize(dot);
+        return elapsed;
+    });
+    for_each_pool_size(harness, "parallel/transform_reduce", size, [&](const PoolPolicy& policy) {
+        uint64_t start = bench_now_ns();
+        double dot = pool_transform_reduce(policy, v1.begin(), v1.end(), v2.begin(), 0.0);
+        uint64_t elapsed = bench_now_ns() - start;
+        if (dot != static_cast<double>(size)) {
+            harness.report_failure("parallel/transform_reduce pool_par: dot product " + std::to_string(dot) +
+                                   ", expected " + std::to_string(static_cast<double>(size)));
+        }
+        return elapsed;
+    });
+    
+    // Search for a value planted near the end, as in parallel_find_demo
+    std::vector<int> sequence(size);
+    std::iota(sequence.begin(), sequence.end(), 0);
+    const int target = static_cast<int>(size) - 100;
+    for_each_policy(harness, "parallel/find_if", size, [&](auto policy) {
+        uint64_t start = bench_now_ns();
+        auto it = std::find_if(policy, sequence.begin(), sequence.end(), [target](int x) {
+            return x == target;
+        });
+        uint64_t elapsed = bench_now_ns() - start;
+        do_not_optimize(it);
+        return elapsed;
+    });
+    for_each_pool_size(harness, "parallel/find_if", size, [&](const PoolPolicy& policy) {
+        uint64_t start = bench_now_ns();
+        auto it = pool_find_if(policy, sequence.begin(), sequence.end(), [target](int x) {
+            return x == target;
+        });
+        uint64_t elapsed = bench_now_ns() - start;
+        if (it != sequence.begin() + target) {
+            harness.report_failure("parallel/find_if pool_par: found position " +
+                                   std::to_string(it - sequence.begin()) + ", expected " + std::to_string(target));
+        }
+        return elapsed;
+    });
+}
@@ -0,0 +1,163 @@
+/**
+ * @file parallel_sort.h
+ * @brief Parallel merge sort and parallel LSD radix sort on a TaskPool
+ *
+ * Neither sort depends on the standard library's parallel backend, so they
+ * scale the same with or without TBB.
+ *
+ * parallel_merge_sort() splits the range recursively, sorts small pieces
+ * with std::sort and merges back up. Levels alternate between the data and
+ * one scratch buffer, and large merges are themselves split in parallel
+ * (the median of the larger run is located in the other run by binary
+ * search), so the final merges are not a sequential bottleneck.
+ *
+ * parallel_radix_sort() sorts 32- or 64-bit integer keys one byte per pass,
+ * least significant byte first. Each pass gives every chunk of the input
+ * its own 256-bucket histogram, turns the histograms into per-chunk write
+ * offsets with one prefix sum, and lets every chunk scatter its keys
+ * without any synchronization. Passes where all keys share the same byte
+ * are skipped.
+ */
+
+#ifndef PARALLEL_SORT_H
+#define PARALLEL_SORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+#include "task_pool.h"
+
+// Ranges below this size are sorted or merged sequentially
+const size_t PARALLEL_SORT_CUTOFF = 16384;
+
+// Merge the sorted runs [a, a_end) and [b, b_end) into out, in parallel for large runs
+template <typename InIt, typename OutIt, typename Compare>
+void parallel_merge(TaskPool& pool, InIt a, InIt a_end, InIt b, InIt b_end, OutIt out, Compare comp) {
+    size_t a_size = static_cast<size_t>(a_end - a);
+    size_t b_size = static_cast<size_t>(b_end - b);
+    if (a_size + b_size <= PARALLEL_SORT_CUTOFF) {
+        std::merge(std::make_move_iterator(a), std::make_move_iterator(a_end),
+                   std::make_move_iterator(b), std::make_move_iterator(b_end), out, comp);
+        return;
+    }
+    
+    // Split the larger run in the middle and the other one where its median belongs
+    if (a_size < b_size) {
+        std::swap(a, b);
+        std::swap(a_end, b_end);
+        std::swap(a_size, b_size);
+    }
+    InIt a_mid = a + a_size / 2;
+    InIt b_mid = std::lower_bound(b, b_end, *a_mid, comp);
+    OutIt out_mid = out + (a_mid - a) + (b_mid - b);
+    
+    TaskGroup group(pool);
+    group.run([&]() { parallel_merge(pool, a, a_mid, b, b_mid, out, comp); });
+    parallel_merge(pool, a_mid, a_end, b_mid, b_end, out_mid, comp);
+    group.wait();
+}
+
+// Sort [data, data + n); the result ends up in data when in_place, otherwise in buffer
+template <typename T, typename Compare>
+void parallel_merge_sort_into(TaskPool& pool, T* data, T* buffer, size_t n, bool in_place, Compare comp) {
+    if (n <= PARALLEL_SORT_CUTOFF) {
+        std::sort(data, data + n, comp);
+        if (!in_place) {
+            std::move(data, data + n, buffer);
+        }
+        return;
+    }
+    
+    // Sort both halves into the other array, then merge them back into the target
+    size_t half = n / 2;
+    TaskGroup group(pool);
+    group.run([&]() { parallel_merge_sort_into(pool, data, buffer, half, !in_place, comp); });
+    parallel_merge_sort_into(pool, data + half, buffer + half, n - half, !in_place, comp);
+    group.wait();
+    
+    T* from = in_place ? buffer : data;
+    T* to = in_place ? data : buffer;
+    parallel_merge(pool, from, from + half, from + half, from + n, to, comp);
+}
+
+template <typename T, typename Compare = std::less<T>>
+void parallel_merge_sort(TaskPool& pool, std::vector<T>& data, Compare comp = Compare()) {
+    std::vector<T> buffer(data.size());
+    parallel_merge_sort_into(pool, data.data(), buffer.data(), data.size(), true, comp);
+}
+
+template <typename Key>
+void parallel_radix_sort(TaskPool& pool, std::vector<Key>& keys) {
+    static_assert(std::is_integral<Key>::value && (sizeof(Key) == 4 || sizeof(Key) == 8),
+                  "parallel_radix_sort sorts 32- or 64-bit integer keys");
+    typedef typename std::make_unsigned<Key>::type Bits;
+    const int BUCKETS = 256;
+    const int PASSES = sizeof(Key);
+    
+    // Flipping the sign bit makes signed keys sort correctly as unsigned bytes
+    const Bits sign_flip = std::is_signed<Key>::value ? Bits(1) << (sizeof(Key) * 8 - 1) : 0;
+    
+    const size_t n = keys.size();
+    const size_t chunks = std::max<size_t>(1, std::min<size_t>(pool.size() + 1, n / PARALLEL_SORT_CUTOFF));
+    const size_t chunk_size = (n + chunks - 1) / chunks;
+    std::vector<Key> buffer(n);
+    std::vector<size_t> offsets(chunks * BUCKETS);
+    
+    Key* from = keys.data();
+    Key* to = buffer.data();
+    for (int pass = 0; pass < PASSES; ++pass) {
+        const int shift = pass * 8;
+        auto digit = [shift, sign_flip](Key key) {
+            return static_cast<size_t>(((static_cast<Bits>(key) ^ sign_flip) >> shift) & 0xff);
+        };
+        
+        // Per-chunk histograms
+        std::fill(offsets.begin(), offsets.end(), 0);
+        parallel_for_index(pool, chunks, [&](size_t c) {
+            size_t* histogram = &offsets[c * BUCKETS];
+            const Key* end = from + std::min(n, (c + 1) * chunk_size);
+            for (const Key* key = from + std::min(n, c * chunk_size); key < end; ++key) {
+                ++histogram[digit(*key)];
+            }
+        });
+        
+        // Prefix sum in (bucket, chunk) order: each chunk writes its part of a
+        // bucket after the same bucket of the chunks before it, keeping the sort stable
+        size_t total = 0;
+        bool single_bucket = false;
+        for (int d = 0; d < BUCKETS; ++d) {
+            for (size_t c = 0; c < chunks; ++c) {
+                size_t count = offsets[c * BUCKETS + d];
+                offsets[c * BUCKETS + d] = total;
+                total += count;
+            }
+            if (total == n && offsets[d] == 0 && n > 0) {
+                single_bucket = true;
+                break;
+            }
+        }
+        if (single_bucket) {
+            continue;
+        }
+        
+        // Scatter
+        parallel_for_index(pool, chunks, [&](size_t c) {
+            size_t* next = &offsets[c * BUCKETS];
+            const Key* end = from + std::min(n, (c + 1) * chunk_size);
+            for (const Key* key = from + std::min(n, c * chunk_size); key < end; ++key) {
+                to[next[digit(*key)]++] = *key;
+            }
+        });
+        std::swap(from, to);
+    }
+    
+    if (from != keys.data()) {
+        keys.swap(buffer);
+    }
+}
+
+#endif // PARALLEL_SORT_H
@@ -0,0 +1,232 @@
+/**
+ * @file perf_counters.cpp
+ * @brief perf_event_open implementation of the region counters, with a stub for other platforms
+ */
+
+#include "perf_counters.h"
+
+#include <cstdio>
+#include <sstream>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const char* const perf_event_names[PERF_EVENT_COUNT] = {
+    "cycles", "instructions", "llc-misses", "branch-misses", "context-switches"
+};
+
+const char* perf_event_name(PerfEvent event) {
+    return perf_event_names[event];
+}
+
+bool PerfSample::any_valid() const {
+    for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+        if (valid[e]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+PerfCounters::~PerfCounters() {
+    close_all();
+}
+
+#if defined(__linux__)
+
+// Fill in the perf_event_attr of one event. Hardware events count user space
+// only so the default perf_event_paranoid setting (2) is enough; context
+// switches happen inside the kernel and would always read 0 that way
+static void perf_event_attr_for(PerfEvent event, perf_event_attr& attr) {
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    
+    switch (event) {
+        case PERF_CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PERF_INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PERF_LLC_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_LL |
+                          (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case PERF_BRANCH_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case PERF_CONTEXT_SWITCHES:
+            attr.type = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_CONTEXT_SWITCHES;
+            attr.exclude_kernel = 0;
+            break;
+        default:
+            break;
+    }
+}
+
+static int perf_event_open_on(PerfEvent event, pid_t tid) {
+    perf_event_attr attr;
+    perf_event_attr_for(event, attr);
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0));
+}
+
+// Thread ids of every thread currently in the process
+static std::vector<pid_t> process_threads() {
+    std::vector<pid_t> tids;
+    DIR* dir = opendir("/proc/self/task");
+    if (dir == nullptr) {
+        tids.push_back(static_cast<pid_t>(syscall(SYS_gettid)));
+        return tids;
+    }
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') {
+            tids.push_back(static_cast<pid_t>(std::atoi(entry->d_name)));
+        }
+    }
+    closedir(dir);
+    return tids;
+}
+
+void PerfCounters::start() {
+    close_all();
+    for (pid_t tid : process_threads()) {
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            fds.push_back(perf_event_open_on(static_cast<PerfEvent>(e), tid));
+        }
+    }
+    for (int fd : fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+PerfSample PerfCounters::stop() {
+    for (int fd : fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    
+    PerfSample sample;
+    for (size_t i = 0; i < fds.size(); ++i) {
+        uint64_t data[3];  // value, time enabled, time running
+        if (fds[i] < 0 || read(fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+            continue;
+        }
+        
+        // Scale up when the kernel had to multiplex more events than the PMU has counters
+        double value = static_cast<double>(data[0]);
+        if (data[2] > 0 && data[2] < data[1]) {
+            value *= static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        }
+        int e = static_cast<int>(i % PERF_EVENT_COUNT);
+        sample.values[e] += static_cast<uint64_t>(value);
+        sample.valid[e] = true;
+    }
+    
+    close_all();
+    return sample;
+}
+
+void PerfCounters::close_all() {
+    for (int fd : fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    fds.clear();
+}
+
+std::string perf_unavailable_reason() {
+    static const std::string reason = [] {
+        std::ostringstream missing;
+        pid_t self = static_cast<pid_t>(syscall(SYS_gettid));
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            int fd = perf_event_open_on(static_cast<PerfEvent>(e), self);
+            if (fd >= 0) {
+                close(fd);
+                continue;
+            }
+            int error = errno;
+            missing << (missing.tellp() > 0 ? "; " : "") << perf_event_names[e] << ": " << std::strerror(error);
+            if (error == EACCES || error == EPERM) {
+                missing << " (check /proc/sys/kernel/perf_event_paranoid)";
+            }
+        }
+        return missing.str();
+    }();
+    return reason;
+}
+
+#else
+
+void PerfCounters::start() {
+}
+
+PerfSample PerfCounters::stop() {
+    return PerfSample();
+}
+
+void PerfCounters::close_all() {
+}
+
+std::string perf_unavailable_reason() {
+    return "perf_event_open is only available on Linux";
+}
+
+#endif
+
+std::string format_perf_sample(const PerfSample& sample) {
+    std::ostringstream line;
+    for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+        line << (e > 0 ? ", " : "") << perf_event_names[e] << " ";
+        if (sample.valid[e]) {
+            line << sample.values[e];
+        } else {
+            line << "n/a";
+        }
+    }
+    
+    // Derived ratios make seq and par runs of different lengths comparable
+    if (sample.valid[PERF_CYCLES] && sample.valid[PERF_INSTRUCTIONS] && sample.values[PERF_CYCLES] > 0) {
+        char ipc[32];
+        std::snprintf(ipc, sizeof(ipc), "%.2f", static_cast<double>(sample.values[PERF_INSTRUCTIONS]) /
+                                                    static_cast<double>(sample.values[PERF_CYCLES]));
+        line << ", IPC " << ipc;
+    }
+    if (sample.valid[PERF_INSTRUCTIONS] && sample.values[PERF_INSTRUCTIONS] > 0) {
+        double kilo_instructions = static_cast<double>(sample.values[PERF_INSTRUCTIONS]) / 1000.0;
+        char mpki[64];
+        if (sample.valid[PERF_LLC_MISSES]) {
+            std::snprintf(mpki, sizeof(mpki), ", LLC MPKI %.2f",
+                          static_cast<double>(sample.values[PERF_LLC_MISSES]) / kilo_instructions);
+            line << mpki;
+        }
+        if (sample.valid[PERF_BRANCH_MISSES]) {
+            std::snprintf(mpki, sizeof(mpki), ", branch MPKI %.2f",
+                          static_cast<double>(sample.values[PERF_BRANCH_MISSES]) / kilo_instructions);
+            line << mpki;
+        }
+    }
+    return line.str();
+}
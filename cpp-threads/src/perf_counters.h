@@ -0,0 +1,66 @@
+/**
+ * @file perf_counters.h
+ * @brief Hardware and scheduler counters around measured regions (Linux perf_event_open)
+ *
+ * A region is counted on every thread of the process, including pool
+ * threads that already exist, plus any thread those threads create while
+ * the region runs (folded in when it exits). Counters the kernel, the CPU
+ * or a virtual machine does not provide are reported as unavailable; on
+ * other platforms every counter is unavailable.
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum PerfEvent {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_LLC_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_CONTEXT_SWITCHES,
+    PERF_EVENT_COUNT
+};
+
+// Counter values of one region; valid[e] is false when event e could not be counted
+struct PerfSample {
+    uint64_t values[PERF_EVENT_COUNT] = {};
+    bool valid[PERF_EVENT_COUNT] = {};
+    
+    bool any_valid() const;
+};
+
+class PerfCounters {
+public:
+    PerfCounters() = default;
+    ~PerfCounters();
+    
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    
+    // Open and enable the counters on every current thread of the process
+    void start();
+    
+    // Disable, read and close the counters
+    PerfSample stop();
+
+private:
+    void close_all();
+    
+    // One file descriptor per (thread, event), -1 when the event failed to open
+    std::vector<int> fds;
+};
+
+// Short name of an event, e.g. "llc-misses"
+const char* perf_event_name(PerfEvent event);
+
+// Why counters are missing (empty when all of them work); probed once
+std::string perf_unavailable_reason();
+
+// One-line summary: each counter, IPC and misses per 1000 instructions
+std::string format_perf_sample(const PerfSample& sample);
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,143 @@
+/**
+ * @file pool_async.h
+ * @brief std::async-style launching onto a fixed set of worker threads
+ *
+ * On libstdc++ every std::async(std::launch::async, ...) creates and joins
+ * an OS thread, so a burst of requests becomes a burst of thread creations.
+ * async(executor, f, args...) queues the call on an executor such as a
+ * TaskPool instead, whose worker count is fixed, and returns a continuable
+ * Future for the result:
+ *
+ *     Future<double> quotient = async(default_task_pool(), compute_division, 10.0, 0.0);
+ *     quotient.get();   // rethrows the std::runtime_error thrown on the worker
+ *
+ * As with std::async, the arguments are copied (or moved) into the task and
+ * an exception thrown by f is rethrown from get(). f and the arguments must
+ * be copyable, because the executor queues std::function objects, and f
+ * must return a value.
+ *
+ * For a fan-out of many small jobs, async_batch() and async_all() hand the
+ * whole set to TaskPool::submit_batch(): one lock acquisition for the queue
+ * and one wake-up per idle worker at most, instead of a lock and a
+ * notification per job. submit_packaged() does the same for a vector of
+ * std::packaged_task.
+ */
+
+#ifndef POOL_ASYNC_H
+#define POOL_ASYNC_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "continuable_future.h"
+#include "task_pool.h"
+
+template <typename Executor, typename F, typename... Args>
+Future<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>> async(Executor& executor, F&& func,
+                                                                           Args&&... args) {
+    using R = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+    auto state = std::make_shared<FutureState<R>>();
+    executor.submit([state, func = std::forward<F>(func),
+                     bound = std::tuple<std::decay_t<Args>...>(std::forward<Args>(args)...)]() mutable {
+        std::apply([&](auto&... unpacked) { fulfil_from(*state, func, std::move(unpacked)...); }, bound);
+    });
+    return Future<R>(state);
+}
+
+// Run func(i) for every i in [0, count) with one batch submission; a future
+// per job. The jobs share func and may call it concurrently.
+template <typename Executor, typename F>
+std::vector<Future<std::invoke_result_t<F, size_t>>> async_batch(Executor& executor, size_t count, F func) {
+    using R = std::invoke_result_t<F, size_t>;
+    std::vector<Future<R>> futures;
+    std::vector<std::function<void()>> batch;
+    futures.reserve(count);
+    batch.reserve(count);
+    auto shared_func = std::make_shared<F>(std::move(func));
+    for (size_t i = 0; i < count; ++i) {
+        auto state = std::make_shared<FutureState<R>>();
+        futures.push_back(Future<R>(state));
+        batch.push_back([state, shared_func, i]() { fulfil_from(*state, *shared_func, i); });
+    }
+    executor.submit_batch(std::move(batch));
+    return futures;
+}
+
+// Like async_batch(), but one future for all the results, in index order, or
+// for the first exception; nothing is allocated per job beyond its queue entry
+template <typename Executor, typename F>
+Future<std::vector<std::invoke_result_t<F, size_t>>> async_all(Executor& executor, size_t count, F func) {
+    using R = std::invoke_result_t<F, size_t>;
+    struct Gather {
+        explicit Gather(size_t count, F func) : func(std::move(func)), values(count), remaining(count) {}
+        
+        F func;
+        std::vector<std::optional<R>> values;
+        std::atomic<size_t> remaining;
+        std::atomic<bool> failed{false};
+        FutureState<std::vector<R>> target;
+    };
+    
+    auto gather = std::make_shared<Gather>(count, std::move(func));
+    Future<std::vector<R>> future(std::shared_ptr<FutureState<std::vector<R>>>(gather, &gather->target));
+    if (count == 0) {
+        gather->target.set_value(std::vector<R>());
+        return future;
+    }
+    
+    std::vector<std::function<void()>> batch;
+    batch.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        batch.push_back([gather, i]() {
+            try {
+                gather->values[i].emplace(gather->func(i));
+            } catch (...) {
+                if (!gather->failed.exchange(true)) {
+                    gather->target.set_exception(std::current_exception());
+                }
+            }
+            
+            // The last job to finish sees every value stored before its decrement
+            if (gather->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1 &&
+                !gather->failed.load(std::memory_order_relaxed)) {
+                std::vector<R> results;
+                results.reserve(gather->values.size());
+                for (auto& value : gather->values) {
+                    results.push_back(std::move(*value));
+                }
+                gather->target.set_value(std::move(results));
+            }
+        });
+    }
+    executor.submit_batch(std::move(batch));
+    return future;
+}
+
+// Queue a vector of packaged tasks with one batch submission; the tasks are
+// moved out of the vector and their futures returned in the same order
+template <typename R>
+std::vector<std::future<R>> submit_packaged(TaskPool& pool, std::vector<std::packaged_task<R()>>& tasks) {
+    std::vector<std::future<R>> futures;
+    std::vector<std::function<void()>> batch;
+    futures.reserve(tasks.size());
+    batch.reserve(tasks.size());
+    for (auto& task : tasks) {
+        futures.push_back(task.get_future());
+        
+        // std::function needs a copyable callable; the packaged task is move-only
+        auto shared_task = std::make_shared<std::packaged_task<R()>>(std::move(task));
+        batch.push_back([shared_task]() { (*shared_task)(); });
+    }
+    tasks.clear();
+    pool.submit_batch(std::move(batch));
+    return futures;
+}
+
+#endif // POOL_ASYNC_H
@@ -0,0 +1,205 @@
+/**
+ * @file pool_execution.h
+ * @brief Project-owned parallel policy: the standard parallel algorithms on a TaskPool
+ *
+ * With GCC the std::execution::par overloads only run in parallel when
+ * libstdc++ finds TBB; otherwise they silently run sequentially. The
+ * pool_* algorithms here take a PoolPolicy instead and always run on the
+ * policy's persistent TaskPool, so their speedups do not depend on how
+ * the standard library was built.
+ *
+ * Work is handed out with guided self-scheduling: every participating
+ * thread (the pool workers plus the caller) repeatedly claims the next
+ * chunk of the remaining range from a shared cursor, sized at
+ * remaining / (2 * participants) but never below the policy's grain. Early
+ * chunks are large, which keeps the scheduling overhead low, and the
+ * chunks shrink towards the end, which keeps threads that fell behind from
+ * delaying the finish. Ranges shorter than two grains run on the caller.
+ */
+
+#ifndef POOL_EXECUTION_H
+#define POOL_EXECUTION_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <vector>
+#include "parallel_sort.h"
+#include "task_pool.h"
+
+class PoolPolicy {
+public:
+    // Runs on default_task_pool()
+    PoolPolicy() : workers(&default_task_pool()) {}
+    explicit PoolPolicy(TaskPool& pool, size_t grain = 4096) : workers(&pool), grain(grain) {}
+    
+    TaskPool& pool() const { return *workers; }
+    
+    // Smallest chunk handed to one thread
+    size_t min_chunk() const { return grain; }
+    
+    // Threads that can work on one call: the pool workers and the caller
+    size_t participants() const { return static_cast<size_t>(workers->size()) + 1; }
+
+private:
+    TaskPool* workers;
+    size_t grain = 4096;
+};
+
+// Split [0, n) into guided chunks and call body(participant, begin, end) for
+// each; a participant stops claiming chunks once body returns false
+template <typename Body>
+void pool_for_chunks(const PoolPolicy& policy, size_t n, Body body) {
+    const size_t grain = std::max<size_t>(1, policy.min_chunk());
+    const size_t participants = std::min(policy.participants(), std::max<size_t>(1, n / grain));
+    if (participants <= 1) {
+        if (n > 0) {
+            body(0, 0, n);
+        }
+        return;
+    }
+    
+    std::atomic<size_t> cursor(0);
+    parallel_for_index(policy.pool(), participants, [&](size_t participant) {
+        size_t begin = cursor.load(std::memory_order_relaxed);
+        for (;;) {
+            size_t end;
+            do {
+                if (begin >= n) {
+                    return;
+                }
+                end = std::min(n, begin + std::max(grain, (n - begin) / (2 * participants)));
+            } while (!cursor.compare_exchange_weak(begin, end, std::memory_order_relaxed));
+            
+            if (!body(participant, begin, end)) {
+                return;
+            }
+            begin = cursor.load(std::memory_order_relaxed);
+        }
+    });
+}
+
+// One partial result per participant, padded so neighbours do not share a cache line
+template <typename T>
+struct alignas(64) PoolPartial {
+    std::optional<T> value;
+};
+
+template <typename RandomIt, typename Function>
+void pool_for_each(const PoolPolicy& policy, RandomIt first, RandomIt last, Function f) {
+    pool_for_chunks(policy, static_cast<size_t>(last - first), [&](size_t, size_t begin, size_t end) {
+        std::for_each(first + begin, first + end, f);
+        return true;
+    });
+}
+
+template <typename RandomIt, typename OutputIt, typename UnaryOp>
+OutputIt pool_transform(const PoolPolicy& policy, RandomIt first, RandomIt last, OutputIt out, UnaryOp op) {
+    pool_for_chunks(policy, static_cast<size_t>(last - first), [&](size_t, size_t begin, size_t end) {
+        std::transform(first + begin, first + end, out + begin, op);
+        return true;
+    });
+    return out + (last - first);
+}
+
+// Unary transform_reduce; as with std::reduce, reduce must be associative and
+// commutative because partial results are combined in no particular order
+template <typename RandomIt, typename T, typename BinaryReduce, typename UnaryTransform>
+T pool_transform_reduce(const PoolPolicy& policy, RandomIt first, RandomIt last, T init,
+                        BinaryReduce reduce, UnaryTransform transform) {
+    std::vector<PoolPartial<T>> partials(policy.participants());
+    pool_for_chunks(policy, static_cast<size_t>(last - first), [&](size_t participant, size_t begin, size_t end) {
+        std::optional<T>& partial = partials[participant].value;
+        RandomIt it = first + begin;
+        if (!partial) {
+            partial = transform(*it++);
+        }
+        
+        // The sequential algorithm keeps several accumulators in flight
+        partial = std::transform_reduce(it, first + end, *partial, reduce, transform);
+        return true;
+    });
+    
+    for (const auto& partial : partials) {
+        if (partial.value) {
+            init = reduce(init, *partial.value);
+        }
+    }
+    return init;
+}
+
+// Binary transform_reduce over two ranges of equal length
+template <typename RandomIt1, typename RandomIt2, typename T, typename BinaryReduce, typename BinaryTransform>
+T pool_transform_reduce(const PoolPolicy& policy, RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, T init,
+                        BinaryReduce reduce, BinaryTransform transform) {
+    std::vector<PoolPartial<T>> partials(policy.participants());
+    pool_for_chunks(policy, static_cast<size_t>(last1 - first1), [&](size_t participant, size_t begin, size_t end) {
+        std::optional<T>& partial = partials[participant].value;
+        size_t i = begin;
+        if (!partial) {
+            partial = transform(first1[i], first2[i]);
+            ++i;
+        }
+        partial = std::transform_reduce(first1 + i, first1 + end, first2 + i, *partial, reduce, transform);
+        return true;
+    });
+    
+    for (const auto& partial : partials) {
+        if (partial.value) {
+            init = reduce(init, *partial.value);
+        }
+    }
+    return init;
+}
+
+// Inner product, like std::transform_reduce(policy, first1, last1, first2, init)
+template <typename RandomIt1, typename RandomIt2, typename T>
+T pool_transform_reduce(const PoolPolicy& policy, RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, T init) {
+    return pool_transform_reduce(policy, first1, last1, first2, init, std::plus<>(), std::multiplies<>());
+}
+
+template <typename RandomIt, typename T, typename BinaryOp = std::plus<>>
+T pool_reduce(const PoolPolicy& policy, RandomIt first, RandomIt last, T init, BinaryOp op = BinaryOp()) {
+    return pool_transform_reduce(policy, first, last, init, op, [](const auto& x) { return x; });
+}
+
+// First element satisfying pred. Chunks are claimed in increasing order, so
+// a thread can stop as soon as its next chunk starts after the best match
+template <typename RandomIt, typename Predicate>
+RandomIt pool_find_if(const PoolPolicy& policy, RandomIt first, RandomIt last, Predicate pred) {
+    const size_t n = static_cast<size_t>(last - first);
+    std::atomic<size_t> found(n);
+    pool_for_chunks(policy, n, [&](size_t, size_t begin, size_t end) {
+        if (begin >= found.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        RandomIt it = std::find_if(first + begin, first + end, pred);
+        if (it == first + end) {
+            return true;
+        }
+        size_t i = static_cast<size_t>(it - first);
+        size_t best = found.load(std::memory_order_relaxed);
+        while (i < best && !found.compare_exchange_weak(best, i, std::memory_order_relaxed)) {
+        }
+        return false;
+    });
+    return first + found.load(std::memory_order_relaxed);
+}
+
+// Parallel merge sort of a contiguous range (vector or array iterators)
+template <typename RandomIt, typename Compare = std::less<>>
+void pool_sort(const PoolPolicy& policy, RandomIt first, RandomIt last, Compare comp = Compare()) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    const size_t n = static_cast<size_t>(last - first);
+    if (n == 0) {
+        return;
+    }
+    std::vector<T> buffer(n);
+    parallel_merge_sort_into(policy.pool(), &*first, buffer.data(), n, true, comp);
+}
+
+#endif // POOL_EXECUTION_H
@@ -0,0 +1,202 @@
+/**
+ * @file queue_bench.cpp
+ * @brief Queue benchmarks: the LockFreeQueue SPSC ring and the MpmcQueue of the data races demo
+ *
+ * LockFreeQueue is a single-producer/single-consumer ring, so it is measured
+ * with exactly one producer and one consumer. MpmcQueue is measured across
+ * producer/consumer ratios, and every run doubles as a stress test: each
+ * item is tagged with its producer and sequence number, and a run in which
+ * any item is lost or delivered twice fails the whole benchmark run (exit
+ * status 3). The SPSC transfers check the sum of the items they received.
+ * The time per operation is the time to move one item from a producer to a
+ * consumer.
+ *
+ * SpscRing is measured next to LockFreeQueue, one item at a time and in
+ * batches of SPSC_BATCH items per enqueue_bulk()/dequeue_bulk() call.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench_harness.h"
+#include "lock_free_queue.h"
+#include "mpmc_queue.h"
+#include "spsc_ring.h"
+
+// Move `items` items through an MpmcQueue with the given number of producers
+// and consumers; returns the elapsed nanoseconds
+static uint64_t mpmc_transfer(BenchHarness& harness, int producers, int consumers, size_t items) {
+    auto queue = std::make_unique<MpmcQueue<size_t, 1024>>();
+    std::unique_ptr<std::atomic<unsigned char>[]> received(new std::atomic<unsigned char>[items]);
+    for (size_t i = 0; i < items; ++i) {
+        received[i].store(0, std::memory_order_relaxed);
+    }
+    
+    // Producer p sends items p, p + producers, ...; consumer c takes a fixed share
+    uint64_t elapsed = measure_threads(producers + consumers, [&](int index) {
+        if (index < producers) {
+            for (size_t item = index; item < items; item += producers) {
+                while (!queue->enqueue(item)) {
+                    std::this_thread::yield();
+                }
+            }
+        } else {
+            int consumer = index - producers;
+            size_t share = items / consumers + (static_cast<size_t>(consumer) < items % consumers ? 1 : 0);
+            size_t item;
+            for (size_t i = 0; i < share; ++i) {
+                while (!queue->dequeue(item)) {
+                    std::this_thread::yield();
+                }
+                received[item].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    });
+    
+    size_t wrong = 0;
+    for (size_t i = 0; i < items; ++i) {
+        wrong += received[i].load(std::memory_order_relaxed) != 1 ? 1 : 0;
+    }
+    if (wrong > 0) {
+        harness.report_failure("MpmcQueue " + std::to_string(producers) + "p" + std::to_string(consumers) +
+                               "c: " + std::to_string(wrong) + " items lost or duplicated");
+    }
+    return elapsed;
+}
+
+const size_t SPSC_BATCH = 64;
+
+// Fail the run when a transfer's items did not all arrive
+static void check_transfer_sum(BenchHarness& harness, const std::string& queue, long long received_sum,
+                               size_t items) {
+    long long expected_sum = static_cast<long long>(items) * (static_cast<long long>(items) - 1) / 2;
+    if (received_sum != expected_sum) {
+        harness.report_failure(queue + " lost items: sum " + std::to_string(received_sum) + ", expected " +
+                               std::to_string(expected_sum));
+    }
+}
+
+// Move items 0..items-1 through an SpscRing, one at a time or in batches
+static uint64_t spsc_ring_transfer(BenchHarness& harness, size_t items, bool bulk) {
+    auto ring = std::make_unique<SpscRing<size_t, 4096>>();
+    long long received_sum = 0;
+    
+    uint64_t elapsed = measure_threads(2, [&](int index) {
+        if (index == 0 && !bulk) {
+            for (size_t i = 0; i < items; ++i) {
+                while (!ring->enqueue(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        } else if (index == 0) {
+            size_t batch[SPSC_BATCH];
+            for (size_t next = 0; next < items;) {
+                size_t count = std::min(SPSC_BATCH, items - next);
+                for (size_t i = 0; i < count; ++i) {
+                    batch[i] = next + i;
+                }
+                for (size_t sent = 0; sent < count;) {
+                    size_t n = ring->enqueue_bulk(batch + sent, count - sent);
+                    if (n == 0) {
+                        std::this_thread::yield();
+                    }
+                    sent += n;
+                }
+                next += count;
+            }
+        } else if (!bulk) {
+            size_t value;
+            for (size_t i = 0; i < items; ++i) {
+                while (!ring->dequeue(value)) {
+                    std::this_thread::yield();
+                }
+                received_sum += static_cast<long long>(value);
+            }
+        } else {
+            size_t batch[SPSC_BATCH];
+            for (size_t received = 0; received < items;) {
+                size_t n = ring->dequeue_bulk(batch, SPSC_BATCH);
+                if (n == 0) {
+                    std::this_thread::yield();
+                }
+                for (size_t i = 0; i < n; ++i) {
+                    received_sum += static_cast<long long>(batch[i]);
+                }
+                received += n;
+            }
+        }
+    });
+    
+    check_transfer_sum(harness, bulk ? "SpscRing bulk" : "SpscRing", received_sum, items);
+    return elapsed;
+}
+
+static void mpmc_bench(BenchHarness& harness) {
+    const std::string name = "queue/mpmc_transfer";
+    if (!harness.enabled(name)) {
+        return;
+    }
+    
+    const size_t items = harness.options().ops;
+    const int counts[] = { 1, 2, 4 };
+    for (int producers : counts) {
+        for (int consumers : counts) {
+            std::string ratio = std::to_string(producers) + "p" + std::to_string(consumers) + "c";
+            harness.run(name, ratio, producers + consumers, items, [&]() {
+                return mpmc_transfer(harness, producers, consumers, items);
+            });
+        }
+    }
+}
+
+void queue_bench(BenchHarness& harness) {
+    mpmc_bench(harness);
+    
+    const std::string name = "queue/spsc_transfer";
+    if (!harness.enabled(name)) {
+        return;
+    }
+    
+    const size_t items = harness.options().ops;
+    harness.run(name, "LockFreeQueue", 2, items, [&]() {
+        LockFreeQueue queue;
+        long long received_sum = 0;
+        
+        uint64_t elapsed = measure_threads(2, [&](int index) {
+            if (index == 0) {
+                for (size_t i = 0; i < items; ++i) {
+                    while (!queue.enqueue(static_cast<int>(i))) {
+                        std::this_thread::yield();
+                    }
+                }
+            } else {
+                int value;
+                for (size_t i = 0; i < items; ++i) {
+                    while (!queue.dequeue(value)) {
+                        std::this_thread::yield();
+                    }
+                    received_sum += value;
+                }
+            }
+        });
+        
+        // A lost or duplicated item would invalidate the timing
+        check_transfer_sum(harness, "LockFreeQueue", received_sum, items);
+        return elapsed;
+    });
+    
+    harness.run(name, "SpscRing", 2, items, [&]() {
+        return spsc_ring_transfer(harness, items, false);
+    });
+    harness.run(name, "SpscRing_bulk", 2, items, [&]() {
+        return spsc_ring_transfer(harness, items, true);
+    });
+    
+    // The MPMC queue pays for its CAS loops even with one thread per end
+    harness.run(name, "MpmcQueue", 2, items, [&]() {
+        return mpmc_transfer(harness, 1, 1, items);
+    });
+}
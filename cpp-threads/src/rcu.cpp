@@ -0,0 +1,131 @@
+/**
+ * @file rcu.cpp
+ * @brief Reader registration and grace-period detection for rcu.h
+ */
+
+#include "rcu.h"
+
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+std::atomic<uint64_t> rcu_gp_ctr{RCU_ACTIVE};
+std::atomic<bool> rcu_fast_readers{false};
+
+// Every reader record ever registered; records are reused but never freed
+static std::atomic<RcuReaderRecord*> rcu_readers{nullptr};
+
+// Serializes grace periods
+static std::mutex rcu_gp_mutex;
+
+#if defined(__linux__)
+static long membarrier_call(int command) {
+    return syscall(__NR_membarrier, command, 0);
+}
+#endif
+
+// Register for expedited membarrier once; readers stay on full fences if that fails
+static void rcu_init() {
+    static std::once_flag once;
+    std::call_once(once, []() {
+#if defined(__linux__)
+        long supported = membarrier_call(MEMBARRIER_CMD_QUERY);
+        if (supported > 0 && (supported & MEMBARRIER_CMD_PRIVATE_EXPEDITED) != 0 &&
+            membarrier_call(MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED) == 0) {
+            rcu_fast_readers.store(true, std::memory_order_relaxed);
+        }
+#endif
+    });
+}
+
+// Full fence on every running thread of the process (or only this one in fallback mode)
+static void rcu_heavy_fence() {
+#if defined(__linux__)
+    if (rcu_fast_readers.load(std::memory_order_relaxed)) {
+        membarrier_call(MEMBARRIER_CMD_PRIVATE_EXPEDITED);
+        return;
+    }
+#endif
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+// Releases the calling thread's record when it exits
+struct RcuThreadExit {
+    ~RcuThreadExit() {
+        if (rcu_thread_record != nullptr) {
+            rcu_thread_record->ctr.store(0, std::memory_order_release);
+            rcu_thread_record->in_use.store(false, std::memory_order_release);
+            rcu_thread_record = nullptr;
+        }
+    }
+};
+
+static thread_local RcuThreadExit rcu_thread_exit;
+
+RcuReaderRecord* rcu_register_thread() {
+    rcu_init();
+    RcuThreadExit& exit_hook = rcu_thread_exit;
+    (void)exit_hook;
+    
+    RcuReaderRecord* record = nullptr;
+    for (RcuReaderRecord* r = rcu_readers.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+        bool expected = false;
+        if (!r->in_use.load(std::memory_order_relaxed) &&
+            r->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            record = r;
+            break;
+        }
+    }
+    
+    if (record == nullptr) {
+        record = new RcuReaderRecord();
+        record->in_use.store(true, std::memory_order_relaxed);
+        RcuReaderRecord* head = rcu_readers.load(std::memory_order_relaxed);
+        do {
+            record->next = head;
+        } while (!rcu_readers.compare_exchange_weak(head, record, std::memory_order_release,
+                                                    std::memory_order_relaxed));
+    }
+    
+    record->nesting = 0;
+    rcu_thread_record = record;
+    return record;
+}
+
+// Flip the phase and wait for every reader still in a section of the old phase
+static void rcu_flip_and_wait() {
+    uint64_t phase = rcu_gp_ctr.load(std::memory_order_relaxed) ^ RCU_PHASE;
+    rcu_gp_ctr.store(phase, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    
+    for (RcuReaderRecord* r = rcu_readers.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+        for (;;) {
+            uint64_t ctr = r->ctr.load(std::memory_order_relaxed);
+            if ((ctr & RCU_ACTIVE) == 0 || ((ctr ^ phase) & RCU_PHASE) == 0) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+}
+
+void synchronize_rcu() {
+    rcu_init();
+    std::lock_guard<std::mutex> lock(rcu_gp_mutex);
+    
+    // Make the caller's unpublishing visible to every reader, and every reader's snapshot to us
+    rcu_heavy_fence();
+    
+    // A reader may have loaded the counter just before the first flip and stored
+    // its snapshot just after it; the second flip waits for that reader too
+    rcu_flip_and_wait();
+    rcu_flip_and_wait();
+    
+    // Order the readers' last accesses before whatever the caller frees next
+    rcu_heavy_fence();
+}
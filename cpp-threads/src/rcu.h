@@ -0,0 +1,85 @@
+/**
+ * @file rcu.h
+ * @brief Read-copy-update grace periods with near-free read-side sections
+ *
+ * A reader marks its read-side section with an RcuReadGuard, which only
+ * copies the global grace-period counter into the reader's own record: no
+ * shared cache line is written and no atomic read-modify-write or fence is
+ * executed. synchronize_rcu() returns once every read-side section that was
+ * running when it was called has ended (a grace period), after which the
+ * versions those readers could see may be freed.
+ *
+ * The reader side can skip its memory fence because the writer forces one
+ * on every thread of the process with membarrier(2) instead, the scheme of
+ * the "memb" flavour of liburcu. Where membarrier is not available readers
+ * fall back to a full fence per section.
+ *
+ * Never call synchronize_rcu() inside a read-side section: it would wait
+ * for itself.
+ */
+
+#ifndef RCU_H
+#define RCU_H
+
+#include <atomic>
+#include <cstdint>
+
+// Bits of the grace-period counter and of a reader's snapshot of it
+const uint64_t RCU_ACTIVE = 1;       // Set in a reader's record while it is inside a section
+const uint64_t RCU_PHASE = 2;        // Flipped twice by every grace period
+
+// One reader thread; ctr is 0 outside a section, a snapshot of the counter inside
+struct RcuReaderRecord {
+    alignas(64) std::atomic<uint64_t> ctr{0};
+    std::atomic<bool> in_use{false};
+    unsigned int nesting = 0;            // Owner only: depth of nested guards
+    RcuReaderRecord* next = nullptr;
+};
+
+extern std::atomic<uint64_t> rcu_gp_ctr;
+
+// False when membarrier(2) is unavailable and readers must fence themselves
+extern std::atomic<bool> rcu_fast_readers;
+
+// Record of the calling thread (nullptr until its first read-side section)
+inline thread_local RcuReaderRecord* rcu_thread_record = nullptr;
+
+// Slow path: a thread's first read-side section
+RcuReaderRecord* rcu_register_thread();
+
+class RcuReadGuard {
+public:
+    RcuReadGuard() : record(rcu_thread_record != nullptr ? rcu_thread_record : rcu_register_thread()) {
+        if (record->nesting++ == 0) {
+            record->ctr.store(rcu_gp_ctr.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            read_side_fence();
+        }
+    }
+    
+    ~RcuReadGuard() {
+        if (--record->nesting == 0) {
+            read_side_fence();
+            record->ctr.store(0, std::memory_order_release);
+        }
+    }
+    
+    RcuReadGuard(const RcuReadGuard&) = delete;
+    RcuReadGuard& operator=(const RcuReadGuard&) = delete;
+
+private:
+    // Compiler barrier only; the writer's membarrier supplies the hardware fence
+    static void read_side_fence() {
+        if (rcu_fast_readers.load(std::memory_order_relaxed)) {
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        } else {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+    
+    RcuReaderRecord* record;
+};
+
+// Wait until every read-side section running at the time of the call has ended
+void synchronize_rcu();
+
+#endif // RCU_H
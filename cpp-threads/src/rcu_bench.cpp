@@ -0,0 +1,124 @@
+/**
+ * @file rcu_bench.cpp
+ * @brief Reader throughput of a read-mostly config: shared_mutex against RCU
+ *
+ * Readers look up a small configuration object while one writer replaces it
+ * every 100 microseconds. The shared_mutex row is the reader path of
+ * sync_reader_writer_lock_demo; the rcu_epoch and rcu_hazard rows read
+ * through RcuConfig and free old versions through retire(), and the rcu_cell
+ * row reads through RcuCell, whose readers write no shared state at all.
+ * The sweep always goes up to 64 readers to show where the shared lock
+ * word stops scaling. The writer only changes values[0], so a read that sees
+ * any other field changed has read a freed or half-built version and fails
+ * the run.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include "bench_harness.h"
+#include "rcu_cell.h"
+#include "rcu_config.h"
+
+// Reader counts always swept up to at least this many threads
+static const int RCU_MAX_THREADS = 64;
+
+// The configuration readers look at
+struct BenchConfig {
+    long values[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+};
+
+// What config_sum() returns for every version the writer publishes
+static const long CONFIG_FIXED_SUM = 2 + 3 + 4 + 5 + 6 + 7 + 8;
+
+// Sum of the fields the writer never changes
+static long config_sum(const BenchConfig& config) {
+    long sum = 0;
+    for (size_t i = 1; i < sizeof(config.values) / sizeof(config.values[0]); ++i) {
+        sum += config.values[i];
+    }
+    return sum;
+}
+
+// Measure `threads` readers doing ops reads each while a writer keeps calling write()
+template <typename Read, typename Write>
+static void sweep_reads(BenchHarness& harness, const std::string& policy, Read read, Write write) {
+    const std::string name = "rcu/read";
+    if (!harness.enabled(name)) {
+        return;
+    }
+    const size_t ops = harness.options().ops;
+    std::atomic<size_t> bad_reads(0);
+    for (int threads : harness.thread_sweep(std::max(RCU_MAX_THREADS, harness.options().max_threads))) {
+        harness.run(name, policy, threads, ops * threads, [&]() {
+            std::atomic<bool> reading(true);
+            std::thread writer([&]() {
+                long version = 0;
+                while (reading.load(std::memory_order_relaxed)) {
+                    write(++version);
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            });
+            
+            uint64_t elapsed = measure_threads(threads, [&](int) {
+                size_t bad = 0;
+                for (size_t i = 0; i < ops; ++i) {
+                    bad += read() != CONFIG_FIXED_SUM;
+                }
+                bad_reads.fetch_add(bad, std::memory_order_relaxed);
+            });
+            
+            reading.store(false, std::memory_order_relaxed);
+            writer.join();
+            return elapsed;
+        });
+    }
+    
+    if (bad_reads.load() != 0) {
+        harness.report_failure(name + " " + policy + ": " + std::to_string(bad_reads.load()) +
+                               " reads saw a freed or partly written config");
+    }
+}
+
+void rcu_bench(BenchHarness& harness) {
+    BenchConfig locked_config;
+    std::shared_mutex rw_mutex;
+    sweep_reads(harness, "shared_mutex",
+        [&]() {
+            std::shared_lock<std::shared_mutex> lock(rw_mutex);
+            return config_sum(locked_config);
+        },
+        [&](long version) {
+            std::unique_lock<std::shared_mutex> lock(rw_mutex);
+            locked_config.values[0] = version;
+        });
+    
+    RcuConfig<BenchConfig> epoch_config;
+    sweep_reads(harness, "rcu_epoch",
+        [&]() { return epoch_config.read(config_sum); },
+        [&](long version) {
+            epoch_config.update([version](BenchConfig& config) { config.values[0] = version; });
+        });
+    
+    RcuConfig<BenchConfig, ReclaimScheme::Hazard> hazard_config;
+    sweep_reads(harness, "rcu_hazard",
+        [&]() { return hazard_config.read(config_sum); },
+        [&](long version) {
+            hazard_config.update([version](BenchConfig& config) { config.values[0] = version; });
+        });
+    
+    RcuCell<BenchConfig> cell;
+    sweep_reads(harness, "rcu_cell",
+        [&]() { return cell.read(config_sum); },
+        [&](long version) {
+            cell.update([version](BenchConfig& config) { config.values[0] = version; });
+        });
+    
+    // Free the versions the writers retired
+    epoch_reclaim();
+    hazard_reclaim();
+}
@@ -0,0 +1,104 @@
+/**
+ * @file rcu_cell.h
+ * @brief One read-mostly value shared through read-copy-update
+ *
+ * Readers of an RcuCell run inside an RcuReadGuard and do a single pointer
+ * load, so any number of them proceed in parallel without writing to any
+ * shared cache line. A writer builds a new copy, publishes it with one
+ * atomic exchange and queues the old version; once RCU_DEFER_BATCH versions
+ * are queued, it waits for one grace period with synchronize_rcu() and
+ * frees the whole batch. Writers are serialized by a mutex.
+ *
+ * Unlike RcuConfig, which pays for an epoch pin or a hazard pointer on every
+ * read, RcuCell moves all of the synchronization cost to the writer.
+ */
+
+#ifndef RCU_CELL_H
+#define RCU_CELL_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "rcu.h"
+
+// Old versions queued per cell before the writer waits for a grace period
+const size_t RCU_DEFER_BATCH = 16;
+
+template <typename T>
+class RcuCell {
+public:
+    explicit RcuCell(T initial = T()) : current(new T(std::move(initial))) {}
+    
+    // The caller guarantees no reader or writer is still running
+    ~RcuCell() {
+        for (const T* old : retired) {
+            delete old;
+        }
+        delete current.load(std::memory_order_relaxed);
+    }
+    
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+    
+    // Call reader(const T&) on the current version; the reference is only valid inside reader,
+    // which must not write to this cell
+    template <typename Reader>
+    auto read(Reader reader) const {
+        RcuReadGuard guard;
+        return reader(*current.load(std::memory_order_acquire));
+    }
+    
+    // Replace the value
+    void store(T value) {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        publish(new T(std::move(value)));
+    }
+    
+    // Copy the current version, let mutate(T&) change the copy, then publish it
+    template <typename Mutate>
+    void update(Mutate mutate) {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        T* next = new T(*current.load(std::memory_order_relaxed));
+        mutate(*next);
+        publish(next);
+    }
+    
+    // Wait for a grace period now and free every queued old version
+    void synchronize() {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        free_retired();
+    }
+    
+    // Old versions waiting for a grace period
+    size_t pending() const {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        return retired.size();
+    }
+
+private:
+    void publish(const T* next) {
+        retired.push_back(current.exchange(next, std::memory_order_acq_rel));
+        if (retired.size() >= RCU_DEFER_BATCH) {
+            free_retired();
+        }
+    }
+    
+    void free_retired() {
+        if (retired.empty()) {
+            return;
+        }
+        synchronize_rcu();
+        for (const T* old : retired) {
+            delete old;
+        }
+        retired.clear();
+    }
+    
+    std::atomic<const T*> current;
+    mutable std::mutex writer_mutex;
+    std::vector<const T*> retired;       // Guarded by writer_mutex
+};
+
+#endif // RCU_CELL_H
@@ -0,0 +1,81 @@
+/**
+ * @file rcu_config.h
+ * @brief Read-mostly configuration object updated by read-copy-update
+ *
+ * Readers never take a lock: read() protects the current version (with an
+ * epoch pin or a hazard pointer, depending on Scheme) and hands it to the
+ * caller's function. A writer copies the current version, changes the copy
+ * and swaps it in with one atomic exchange; the old version is retired and
+ * freed once no reader can still see it. Writers are serialized by a mutex
+ * so that two concurrent updates cannot lose each other's changes.
+ */
+
+#ifndef RCU_CONFIG_H
+#define RCU_CONFIG_H
+
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include "reclamation.h"
+
+// How readers protect a version and how writers retire old ones
+enum class ReclaimScheme {
+    Epoch,                           // Cheap pin per read; a stalled reader delays every free
+    Hazard                           // One fenced store per read; garbage stays bounded
+};
+
+template <typename T, ReclaimScheme Scheme = ReclaimScheme::Epoch>
+class RcuConfig {
+public:
+    explicit RcuConfig(T initial = T()) : current(new T(std::move(initial))) {}
+    
+    // The caller guarantees no reader or writer is still running
+    ~RcuConfig() {
+        delete current.load(std::memory_order_relaxed);
+    }
+    
+    RcuConfig(const RcuConfig&) = delete;
+    RcuConfig& operator=(const RcuConfig&) = delete;
+    
+    // Call reader(const T&) on the current version; the reference is only valid inside reader
+    template <typename Reader>
+    auto read(Reader reader) const {
+        if constexpr (Scheme == ReclaimScheme::Epoch) {
+            EpochGuard guard;
+            return reader(*current.load(std::memory_order_seq_cst));
+        } else {
+            HazardPointer hazard;
+            return reader(*hazard.protect(current));
+        }
+    }
+    
+    // Replace the whole configuration
+    void store(T value) {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        publish(new T(std::move(value)));
+    }
+    
+    // Copy the current version, let mutate(T&) change the copy, then publish it
+    template <typename Mutate>
+    void update(Mutate mutate) {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        T* next = new T(*current.load(std::memory_order_relaxed));
+        mutate(*next);
+        publish(next);
+    }
+
+private:
+    void publish(const T* next) {
+        const T* previous = current.exchange(next, std::memory_order_seq_cst);
+        if constexpr (Scheme == ReclaimScheme::Epoch) {
+            epoch_retire(previous);
+        } else {
+            hazard_retire(previous);
+        }
+    }
+    
+    std::atomic<const T*> current;
+    std::mutex writer_mutex;
+};
+
+#endif // RCU_CONFIG_H
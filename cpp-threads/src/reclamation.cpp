@@ -0,0 +1,221 @@
+/**
+ * @file reclamation.cpp
+ * @brief Record registries, retired lists and reclamation passes for hazard pointers and epochs
+ */
+
+#include "reclamation.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+// An object waiting to be freed
+struct RetiredObject {
+    void* pointer;
+    void (*deleter)(void*);
+    uint64_t epoch;                      // Global epoch when retired (epoch scheme only)
+};
+
+// Lists of records; a record is published once and then only reused
+static std::atomic<HazardSlot*> hazard_slots{nullptr};
+static std::atomic<size_t> hazard_slot_count{0};
+static std::atomic<EpochRecord*> epoch_records{nullptr};
+
+// Retired objects left behind by threads that exited
+static std::mutex orphan_mutex;
+static std::vector<RetiredObject> hazard_orphans;
+static std::vector<RetiredObject> epoch_orphans;
+
+// Per-thread retired lists; on thread exit the records are released and
+// whatever is still pending is handed over to the orphan lists
+struct ThreadReclaimState {
+    std::vector<RetiredObject> hazard_retired;
+    std::vector<RetiredObject> epoch_retired;
+    
+    ~ThreadReclaimState() {
+        while (hazard_thread_slots != nullptr) {
+            HazardSlot* slot = hazard_thread_slots;
+            hazard_thread_slots = slot->next_free;
+            slot->next_free = nullptr;
+            slot->in_use.store(false, std::memory_order_release);
+        }
+        if (epoch_thread_record != nullptr) {
+            epoch_thread_record->state.store(0, std::memory_order_release);
+            epoch_thread_record->in_use.store(false, std::memory_order_release);
+            epoch_thread_record = nullptr;
+        }
+        
+        std::lock_guard<std::mutex> lock(orphan_mutex);
+        hazard_orphans.insert(hazard_orphans.end(), hazard_retired.begin(), hazard_retired.end());
+        epoch_orphans.insert(epoch_orphans.end(), epoch_retired.begin(), epoch_retired.end());
+    }
+};
+
+static thread_local ThreadReclaimState thread_state;
+
+// Move the orphans of one scheme into the caller's list
+static void adopt_orphans(std::vector<RetiredObject>& orphans, std::vector<RetiredObject>& retired) {
+    std::lock_guard<std::mutex> lock(orphan_mutex);
+    retired.insert(retired.end(), orphans.begin(), orphans.end());
+    orphans.clear();
+}
+
+// Free every entry for which is_safe holds and keep the rest
+template <typename IsSafe>
+static size_t free_retired(std::vector<RetiredObject>& retired, IsSafe is_safe) {
+    auto kept = std::partition(retired.begin(), retired.end(),
+                               [&](const RetiredObject& object) { return !is_safe(object); });
+    size_t freed = static_cast<size_t>(retired.end() - kept);
+    
+    // Deleters may retire further objects, so detach the batch before running them
+    std::vector<RetiredObject> batch(kept, retired.end());
+    retired.erase(kept, retired.end());
+    for (const RetiredObject& object : batch) {
+        object.deleter(object.pointer);
+    }
+    return freed;
+}
+
+// =================== HAZARD POINTERS ===================
+
+HazardSlot* hazard_acquire_slot() {
+    (void)thread_state;  // Make sure the slot is released when this thread exits
+    
+    for (HazardSlot* slot = hazard_slots.load(std::memory_order_acquire); slot != nullptr; slot = slot->next) {
+        bool expected = false;
+        if (!slot->in_use.load(std::memory_order_relaxed) &&
+            slot->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return slot;
+        }
+    }
+    
+    HazardSlot* slot = new HazardSlot();
+    slot->in_use.store(true, std::memory_order_relaxed);
+    HazardSlot* head = hazard_slots.load(std::memory_order_relaxed);
+    do {
+        slot->next = head;
+    } while (!hazard_slots.compare_exchange_weak(head, slot, std::memory_order_release,
+                                                 std::memory_order_relaxed));
+    hazard_slot_count.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+}
+
+static size_t hazard_scan() {
+    std::vector<RetiredObject>& retired = thread_state.hazard_retired;
+    adopt_orphans(hazard_orphans, retired);
+    
+    // Pairs with the seq_cst store and reload in protect(): a reader whose reload
+    // still saw a retired pointer has its hazard visible here
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::vector<const void*> hazards;
+    for (HazardSlot* slot = hazard_slots.load(std::memory_order_acquire); slot != nullptr; slot = slot->next) {
+        const void* pointer = slot->pointer.load(std::memory_order_seq_cst);
+        if (pointer != nullptr) {
+            hazards.push_back(pointer);
+        }
+    }
+    std::sort(hazards.begin(), hazards.end());
+    
+    return free_retired(retired, [&](const RetiredObject& object) {
+        return !std::binary_search(hazards.begin(), hazards.end(), object.pointer);
+    });
+}
+
+void hazard_retire(void* pointer, void (*deleter)(void*)) {
+    std::vector<RetiredObject>& retired = thread_state.hazard_retired;
+    retired.push_back({pointer, deleter, 0});
+    
+    // Scanning more slots than there are retired objects would not pay off
+    size_t threshold = std::max(RECLAIM_BATCH, 2 * hazard_slot_count.load(std::memory_order_relaxed));
+    if (retired.size() >= threshold) {
+        hazard_scan();
+    }
+}
+
+size_t hazard_reclaim() {
+    return hazard_scan();
+}
+
+size_t hazard_pending() {
+    return thread_state.hazard_retired.size();
+}
+
+// =================== EPOCHS ===================
+
+std::atomic<uint64_t> global_epoch{0};
+
+EpochRecord* epoch_register_thread() {
+    (void)thread_state;  // Make sure the record is released when this thread exits
+    
+    EpochRecord* record = nullptr;
+    for (EpochRecord* r = epoch_records.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+        bool expected = false;
+        if (!r->in_use.load(std::memory_order_relaxed) &&
+            r->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            record = r;
+            break;
+        }
+    }
+    
+    if (record == nullptr) {
+        record = new EpochRecord();
+        record->in_use.store(true, std::memory_order_relaxed);
+        EpochRecord* head = epoch_records.load(std::memory_order_relaxed);
+        do {
+            record->next = head;
+        } while (!epoch_records.compare_exchange_weak(head, record, std::memory_order_release,
+                                                      std::memory_order_relaxed));
+    }
+    
+    record->nesting = 0;
+    epoch_thread_record = record;
+    return record;
+}
+
+// Advance the global epoch if every pinned thread has announced the current one
+static uint64_t epoch_try_advance() {
+    uint64_t epoch = global_epoch.load(std::memory_order_seq_cst);
+    for (EpochRecord* r = epoch_records.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+        uint64_t state = r->state.load(std::memory_order_seq_cst);
+        if ((state & 1) != 0 && (state >> 1) != epoch) {
+            return epoch;
+        }
+    }
+    
+    // Losing the race means another thread advanced it, which is just as good
+    if (global_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst)) {
+        return epoch + 1;
+    }
+    return epoch;
+}
+
+static size_t epoch_collect(int advances) {
+    std::vector<RetiredObject>& retired = thread_state.epoch_retired;
+    adopt_orphans(epoch_orphans, retired);
+    
+    uint64_t epoch = 0;
+    for (int i = 0; i < advances; i++) {
+        epoch = epoch_try_advance();
+    }
+    
+    // Two advances after retirement, no thread can still be inside a section that saw the object
+    return free_retired(retired, [&](const RetiredObject& object) {
+        return object.epoch + 2 <= epoch;
+    });
+}
+
+void epoch_retire(void* pointer, void (*deleter)(void*)) {
+    std::vector<RetiredObject>& retired = thread_state.epoch_retired;
+    retired.push_back({pointer, deleter, global_epoch.load(std::memory_order_seq_cst)});
+    if (retired.size() >= RECLAIM_BATCH) {
+        epoch_collect(1);
+    }
+}
+
+size_t epoch_reclaim() {
+    return epoch_collect(2);
+}
+
+size_t epoch_pending() {
+    return thread_state.epoch_retired.size();
+}
@@ -0,0 +1,178 @@
+/**
+ * @file reclamation.h
+ * @brief Safe memory reclamation for lock-free pointer swaps: hazard pointers and epochs
+ *
+ * A thread that swaps out a shared pointer cannot delete the old object
+ * right away, because another thread may have loaded it a moment earlier
+ * and still be reading it. Both schemes here let the writer retire() the
+ * old object instead; it is deleted later, once no reader can hold it.
+ *
+ * - Hazard pointers: a reader publishes the exact pointer it is about to
+ *   use in a HazardPointer slot, and a retired object is freed once no slot
+ *   holds it. Memory held back stays bounded, but every protect() needs a
+ *   full fence.
+ * - Epochs: a reader pins the global epoch with an EpochGuard for the whole
+ *   read-side section. An object retired in epoch e is freed once the
+ *   global epoch reaches e + 2, which can only happen after every thread
+ *   pinned at the time has left its section. Pinning is cheaper, but one
+ *   stalled reader holds back all reclamation.
+ *
+ * Retired objects collect in a per-thread list and are reclaimed in batches,
+ * so the cost of scanning the readers is spread over many retire() calls.
+ * Objects still pending when a thread exits go to the next thread that
+ * reclaims. Slot and epoch records are reused by later threads but never
+ * freed.
+ */
+
+#ifndef RECLAMATION_H
+#define RECLAMATION_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Retired objects per thread before a reclamation pass is attempted
+const size_t RECLAIM_BATCH = 64;
+
+// =================== HAZARD POINTERS ===================
+
+// One published hazard; owned by a single HazardPointer at a time
+struct HazardSlot {
+    alignas(64) std::atomic<const void*> pointer{nullptr};
+    std::atomic<bool> in_use{false};
+    HazardSlot* next = nullptr;          // Registry link, never changes once published
+    HazardSlot* next_free = nullptr;     // Owner thread's cache of idle slots
+};
+
+// Idle slots owned by the calling thread, so constructing a HazardPointer
+// normally needs no atomic read-modify-write
+inline thread_local HazardSlot* hazard_thread_slots = nullptr;
+
+// Slow path: take a slot from the registry, adding one when all are in use
+HazardSlot* hazard_acquire_slot();
+
+class HazardPointer {
+public:
+    HazardPointer() : slot(hazard_thread_slots) {
+        if (slot != nullptr) {
+            hazard_thread_slots = slot->next_free;
+        } else {
+            slot = hazard_acquire_slot();
+        }
+    }
+    
+    ~HazardPointer() {
+        reset();
+        slot->next_free = hazard_thread_slots;
+        hazard_thread_slots = slot;
+    }
+    
+    HazardPointer(const HazardPointer&) = delete;
+    HazardPointer& operator=(const HazardPointer&) = delete;
+    
+    // Load source and keep the object it points to alive until reset()
+    template <typename T>
+    T* protect(const std::atomic<T*>& source) {
+        T* pointer = source.load(std::memory_order_relaxed);
+        for (;;) {
+            slot->pointer.store(pointer, std::memory_order_seq_cst);
+            
+            // The hazard only counts if source still holds the pointer after it was published
+            T* again = source.load(std::memory_order_seq_cst);
+            if (again == pointer) {
+                return pointer;
+            }
+            pointer = again;
+        }
+    }
+    
+    void reset() {
+        slot->pointer.store(nullptr, std::memory_order_release);
+    }
+
+private:
+    HazardSlot* slot;
+};
+
+// Free pointer with deleter once no hazard pointer holds it
+void hazard_retire(void* pointer, void (*deleter)(void*));
+
+template <typename T>
+void hazard_retire(T* pointer) {
+    hazard_retire(const_cast<void*>(static_cast<const void*>(pointer)),
+                  [](void* object) { delete static_cast<T*>(object); });
+}
+
+// Scan now instead of waiting for a full batch; returns the number of objects freed
+size_t hazard_reclaim();
+
+// Objects the calling thread has retired that are not freed yet
+size_t hazard_pending();
+
+// =================== EPOCHS ===================
+
+// Announcement of one thread; state is (epoch << 1) | 1 while pinned, 0 otherwise
+struct EpochRecord {
+    alignas(64) std::atomic<uint64_t> state{0};
+    std::atomic<bool> in_use{false};
+    unsigned int nesting = 0;            // Owner only: depth of nested EpochGuards
+    EpochRecord* next = nullptr;
+};
+
+extern std::atomic<uint64_t> global_epoch;
+
+// Record of the calling thread (nullptr until its first EpochGuard)
+inline thread_local EpochRecord* epoch_thread_record = nullptr;
+
+// Slow path: a thread's first EpochGuard
+EpochRecord* epoch_register_thread();
+
+// Read-side critical section: objects reachable when it starts stay alive until it ends
+class EpochGuard {
+public:
+    EpochGuard() : record(epoch_thread_record != nullptr ? epoch_thread_record : epoch_register_thread()) {
+        if (record->nesting++ > 0) {
+            return;
+        }
+        uint64_t epoch = global_epoch.load(std::memory_order_relaxed);
+        for (;;) {
+            record->state.store((epoch << 1) | 1, std::memory_order_seq_cst);
+            
+            // Announce the newest epoch so a stale pin does not hold back reclamation
+            uint64_t now = global_epoch.load(std::memory_order_seq_cst);
+            if (now == epoch) {
+                break;
+            }
+            epoch = now;
+        }
+    }
+    
+    ~EpochGuard() {
+        if (--record->nesting == 0) {
+            record->state.store(0, std::memory_order_release);
+        }
+    }
+    
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+
+private:
+    EpochRecord* record;
+};
+
+// Free pointer with deleter once every reader pinned now has left its section
+void epoch_retire(void* pointer, void (*deleter)(void*));
+
+template <typename T>
+void epoch_retire(T* pointer) {
+    epoch_retire(const_cast<void*>(static_cast<const void*>(pointer)),
+                 [](void* object) { delete static_cast<T*>(object); });
+}
+
+// Try to advance the epoch and free what has become safe; returns the number of objects freed
+size_t epoch_reclaim();
+
+// Objects the calling thread has retired that are not freed yet
+size_t epoch_pending();
+
+#endif // RECLAMATION_H
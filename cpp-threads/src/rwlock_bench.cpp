@@ -0,0 +1,87 @@
+/**
+ * @file rwlock_bench.cpp
+ * @brief Reader-writer lock matrix: read/write ratios by thread count
+ *
+ * Every thread runs a fixed mix of reads and writes on a small shared
+ * record: 99/1, 90/10 or 50/50 percent reads to writes. A write increments
+ * every field of the record and a read checks that all fields are equal,
+ * so a lock that lets a reader in next to a writer is reported. The rows
+ * compare std::shared_mutex with BigReaderLock in its writer-preference,
+ * reader-preference and per-CPU-slot configurations.
+ */
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include "bench_harness.h"
+#include "big_reader_lock.h"
+
+// Record guarded by the lock under test
+struct RwRecord {
+    long fields[8] = {};
+};
+
+// One read/write mix of the matrix
+struct RwMix {
+    const char* name;
+    int write_percent;
+};
+
+static const RwMix RW_MIXES[] = {
+    { "rwlock/99r1w", 1 },
+    { "rwlock/90r10w", 10 },
+    { "rwlock/50r50w", 50 },
+};
+
+template <typename Lock>
+static void sweep_mix(BenchHarness& harness, const RwMix& mix, const std::string& policy, Lock& lock) {
+    if (!harness.enabled(mix.name)) {
+        return;
+    }
+    const size_t ops = harness.options().ops;
+    RwRecord record;
+    std::atomic<long> torn_reads(0);
+    
+    for (int threads : harness.thread_sweep()) {
+        harness.run(mix.name, policy, threads, ops * threads, [&]() {
+            return measure_threads(threads, [&](int index) {
+                long torn = 0;
+                for (size_t i = 0; i < ops; ++i) {
+                    // Spread the writes so the threads do not all write at the same moment
+                    if (static_cast<int>((i + static_cast<size_t>(index) * 37) % 100) < mix.write_percent) {
+                        std::unique_lock<Lock> guard(lock);
+                        for (long& field : record.fields) {
+                            field++;
+                        }
+                    } else {
+                        std::shared_lock<Lock> guard(lock);
+                        for (long field : record.fields) {
+                            torn += field != record.fields[0];
+                        }
+                    }
+                }
+                torn_reads.fetch_add(torn, std::memory_order_relaxed);
+            });
+        });
+    }
+    
+    if (torn_reads.load() != 0) {
+        harness.report_failure(std::string(mix.name) + " " + policy + ": " + std::to_string(torn_reads.load()) +
+                               " reads overlapped a write");
+    }
+}
+
+void rwlock_bench(BenchHarness& harness) {
+    for (const RwMix& mix : RW_MIXES) {
+        std::shared_mutex shared_mutex;
+        BigReaderLock writer_preferring(RwPreference::Writer);
+        BigReaderLock reader_preferring(RwPreference::Reader);
+        BigReaderLock cpu_slots(RwPreference::Writer, ShardSelect::Cpu);
+        
+        sweep_mix(harness, mix, "shared_mutex", shared_mutex);
+        sweep_mix(harness, mix, "brlock_writer", writer_preferring);
+        sweep_mix(harness, mix, "brlock_reader", reader_preferring);
+        sweep_mix(harness, mix, "brlock_cpu", cpu_slots);
+    }
+}
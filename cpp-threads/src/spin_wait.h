@@ -0,0 +1,48 @@
+/**
+ * @file spin_wait.h
+ * @brief Pause instruction and a spin-then-yield wait step shared by the spinning locks
+ */
+
+#ifndef SPIN_WAIT_H
+#define SPIN_WAIT_H
+
+#include <thread>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Pause instructions a SpinWait issues before it starts yielding the time slice
+const int SPIN_YIELD_THRESHOLD = 64;
+
+// Tell the CPU this is a spin-wait loop (saves power, frees the core's other hyperthread)
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(_MSC_VER) && (defined(_M_ARM64) || defined(_M_ARM))
+    __yield();
+#endif
+}
+
+// One step of a wait loop: pause while the wait is short, then let other threads run,
+// since the thread we are waiting for may need this CPU
+class SpinWait {
+public:
+    void wait() {
+        if (spins < SPIN_YIELD_THRESHOLD) {
+            ++spins;
+            cpu_relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    int spins = 0;
+};
+
+#endif // SPIN_WAIT_H
@@ -0,0 +1,256 @@
+/**
+ * @file sync_bench.cpp
+ * @brief Lock benchmarks: mutex, lock_guard, unique_lock, shared_mutex, atomic_flag spinlocks
+ *        (pure spin and yielding), the adaptive spin-then-park mutex and the FIFO spinlocks
+ *
+ * Every thread increments a shared counter under the lock, the same pattern
+ * as the counters in synchronization.cpp, so the time per operation is the
+ * cost of one acquire/release pair at the given level of contention.
+ * lock/low_contention adds private work between acquisitions, and
+ * lock/oversubscribed runs up to four threads per hardware thread, where a
+ * spinning waiter may be burning the time slice the lock owner needs.
+ * lock/fair also records how evenly the lock was shared: when the first
+ * thread has finished its operations, how far the slowest one has got
+ * (slowest_share in the results).
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "adaptive_mutex.h"
+#include "bench_harness.h"
+#include "fair_locks.h"
+
+// Spinlock built on std::atomic_flag, as in atomic_flag_demo: it spins without limit
+class AtomicFlagSpinlock {
+private:
+    std::atomic_flag flag = ATOMIC_FLAG_INIT;
+
+public:
+    void lock() {
+        while (flag.test_and_set(std::memory_order_acquire)) {
+        }
+    }
+    
+    void unlock() {
+        flag.clear(std::memory_order_release);
+    }
+};
+
+// The same spinlock yielding after every failed attempt, as the demo suggests for real code
+class YieldingSpinlock {
+private:
+    std::atomic_flag flag = ATOMIC_FLAG_INIT;
+
+public:
+    void lock() {
+        while (flag.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+    
+    void unlock() {
+        flag.clear(std::memory_order_release);
+    }
+};
+
+// Iterations of private work between two acquisitions in lock/low_contention
+const int LOW_CONTENTION_WORK = 200;
+
+// Threads per hardware thread at the top of the lock/oversubscribed sweep
+const int OVERSUBSCRIPTION = 4;
+
+// Run one increment benchmark for every thread count in sweep
+template <typename Increment>
+static void sweep_increment(BenchHarness& harness, const std::string& name, const std::string& policy,
+                            const std::vector<int>& sweep, Increment increment) {
+    if (!harness.enabled(name)) {
+        return;
+    }
+    const size_t ops = harness.options().ops;
+    for (int threads : sweep) {
+        harness.run(name, policy, threads, ops * threads, [&]() {
+            return measure_threads(threads, [&](int) {
+                for (size_t i = 0; i < ops; ++i) {
+                    increment();
+                }
+            });
+        });
+    }
+}
+
+// The same over the default thread sweep
+template <typename Increment>
+static void sweep_increment(BenchHarness& harness, const std::string& name, const std::string& policy,
+                            Increment increment) {
+    sweep_increment(harness, name, policy, harness.thread_sweep(), increment);
+}
+
+// Short dependent computation standing in for work done outside the lock
+static unsigned int private_work(unsigned int seed) {
+    for (int i = 0; i < LOW_CONTENTION_WORK; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+    }
+    return seed;
+}
+
+// Throughput and fairness of one lock over the thread sweep. Each thread notes how many
+// acquisitions it had made when the first thread finished all of its own.
+template <typename Lock>
+static void sweep_fairness(BenchHarness& harness, const std::string& policy, Lock& lock) {
+    const std::string name = "lock/fair";
+    if (!harness.enabled(name)) {
+        return;
+    }
+    const size_t ops = harness.options().ops;
+    
+    for (int threads : harness.thread_sweep()) {
+        std::vector<size_t> done_at_first_finish(threads);
+        double slowest_share_sum = 0.0;
+        int runs = 0;
+        long counter = 0;
+        
+        harness.run(name, policy, threads, ops * threads, [&]() {
+            std::atomic<bool> first_finished(false);
+            uint64_t ns = measure_threads(threads, [&](int index) {
+                size_t done = ops;
+                for (size_t i = 0; i < ops; ++i) {
+                    if (done == ops && first_finished.load(std::memory_order_relaxed)) {
+                        done = i;
+                    }
+                    std::lock_guard<Lock> guard(lock);
+                    counter++;
+                }
+                first_finished.store(true, std::memory_order_relaxed);
+                done_at_first_finish[index] = done;
+            });
+            
+            slowest_share_sum += static_cast<double>(
+                *std::min_element(done_at_first_finish.begin(), done_at_first_finish.end())) / ops;
+            runs++;
+            return ns;
+        }, [&](BenchResult& result) {
+            if (threads > 1) {
+                result.slowest_share = slowest_share_sum / runs;
+            }
+        });
+        
+        if (counter != static_cast<long>(ops) * threads * runs) {
+            harness.report_failure(name + " " + policy + ": counted " + std::to_string(counter) + " of " +
+                                   std::to_string(static_cast<long>(ops) * threads * runs));
+        }
+    }
+}
+
+void sync_bench(BenchHarness& harness) {
+    std::mutex mutex;
+    std::shared_mutex shared_mutex;
+    AtomicFlagSpinlock spinlock;
+    YieldingSpinlock yielding_spinlock;
+    AdaptiveMutex adaptive;
+    long counter = 0;
+    
+    // Exclusive increments through each locking style
+    sweep_increment(harness, "lock/increment", "mutex", [&]() {
+        mutex.lock();
+        counter++;
+        mutex.unlock();
+    });
+    sweep_increment(harness, "lock/increment", "lock_guard", [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        counter++;
+    });
+    sweep_increment(harness, "lock/increment", "unique_lock", [&]() {
+        std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+        lock.lock();
+        counter++;
+        lock.unlock();
+    });
+    sweep_increment(harness, "lock/increment", "shared_mutex", [&]() {
+        std::unique_lock<std::shared_mutex> lock(shared_mutex);
+        counter++;
+    });
+    sweep_increment(harness, "lock/increment", "atomic_flag", [&]() {
+        std::lock_guard<YieldingSpinlock> lock(yielding_spinlock);
+        counter++;
+    });
+    sweep_increment(harness, "lock/increment", "atomic_flag_spin", [&]() {
+        std::lock_guard<AtomicFlagSpinlock> lock(spinlock);
+        counter++;
+    });
+    sweep_increment(harness, "lock/increment", "adaptive", [&]() {
+        std::lock_guard<AdaptiveMutex> lock(adaptive);
+        counter++;
+    });
+    
+    // Lower contention: most of each operation happens outside the lock
+    thread_local unsigned int seed = 1;
+    sweep_increment(harness, "lock/low_contention", "mutex", [&]() {
+        seed = private_work(seed);
+        std::lock_guard<std::mutex> lock(mutex);
+        counter++;
+    });
+    sweep_increment(harness, "lock/low_contention", "atomic_flag", [&]() {
+        seed = private_work(seed);
+        std::lock_guard<YieldingSpinlock> lock(yielding_spinlock);
+        counter++;
+    });
+    sweep_increment(harness, "lock/low_contention", "atomic_flag_spin", [&]() {
+        seed = private_work(seed);
+        std::lock_guard<AtomicFlagSpinlock> lock(spinlock);
+        counter++;
+    });
+    sweep_increment(harness, "lock/low_contention", "adaptive", [&]() {
+        seed = private_work(seed);
+        std::lock_guard<AdaptiveMutex> lock(adaptive);
+        counter++;
+    });
+    
+    // More threads than the machine can run at once
+    const int hardware = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const std::vector<int> oversubscribed =
+        harness.thread_sweep(std::max(hardware * OVERSUBSCRIPTION, harness.options().max_threads));
+    sweep_increment(harness, "lock/oversubscribed", "mutex", oversubscribed, [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        counter++;
+    });
+    sweep_increment(harness, "lock/oversubscribed", "atomic_flag", oversubscribed, [&]() {
+        std::lock_guard<YieldingSpinlock> lock(yielding_spinlock);
+        counter++;
+    });
+    sweep_increment(harness, "lock/oversubscribed", "atomic_flag_spin", oversubscribed, [&]() {
+        std::lock_guard<AtomicFlagSpinlock> lock(spinlock);
+        counter++;
+    });
+    sweep_increment(harness, "lock/oversubscribed", "adaptive", oversubscribed, [&]() {
+        std::lock_guard<AdaptiveMutex> lock(adaptive);
+        counter++;
+    });
+    
+    // Read-only access: shared_mutex readers may proceed together, a mutex serializes them
+    sweep_increment(harness, "lock/read", "mutex", [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        do_not_optimize(counter);
+    });
+    sweep_increment(harness, "lock/read", "shared_mutex", [&]() {
+        std::shared_lock<std::shared_mutex> lock(shared_mutex);
+        do_not_optimize(counter);
+    });
+    
+    // FIFO spinlocks against the unfair ones as waiters are added
+    TicketLock ticket;
+    McsLock mcs;
+    ClhLock clh;
+    sweep_fairness(harness, "mutex", mutex);
+    sweep_fairness(harness, "atomic_flag", yielding_spinlock);
+    sweep_fairness(harness, "ticket", ticket);
+    sweep_fairness(harness, "mcs", mcs);
+    sweep_fairness(harness, "clh", clh);
+    
+    do_not_optimize(counter);
+    do_not_optimize(seed);
+}
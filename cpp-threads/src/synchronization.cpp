@@ -4,14 +4,21 @@
  */
 
 #include <iostream>
+#include <algorithm>
 #include <thread>
 #include <mutex>
 #include <vector>
 #include <chrono>
 #include <atomic>
 #include <shared_mutex> // For std::shared_mutex (C++17)
+#include "adaptive_mutex.h"
+#include "big_reader_lock.h"
+#include "demo_settings.h"
+#include "lock_profiler.h"
+#include "rcu_cell.h"
+#include "rcu_config.h"
 
-// Global variables
+// Default thread and increment counts (overridable with --threads and --size)
 const int NUM_THREADS = 4;
 const int NUM_INCREMENTS = 1000000;
 
@@ -20,7 +27,10 @@ int unsafe_counter = 0;
 
 // Shared counter with mutex protection
 int safe_counter = 0;
-std::mutex counter_mutex;
+ProfiledMutex counter_mutex("counter_mutex");
+
+// Spin-then-park mutex guarding the same counter in lock_guard_demo
+AdaptiveMutex counter_adaptive_mutex;
 
 // Shared counter with atomic protection
 std::atomic<int> atomic_counter(0);
@@ -58,7 +68,7 @@ void increment_with_mutex(int iterations) {
 void increment_with_lock_guard(int iterations) {
     for (int i = 0; i < iterations; ++i) {
         // RAII approach - lock_guard automatically releases mutex when it goes out of scope
-        std::lock_guard<std::mutex> lock(counter_mutex);
+        std::lock_guard<ProfiledMutex> lock(counter_mutex);
         
         // Critical section
         safe_counter++;
@@ -67,11 +77,19 @@ void increment_with_lock_guard(int iterations) {
     }
 }
 
+// The same with AdaptiveMutex: lock_guard works with any Lockable type
+void increment_with_adaptive_mutex(int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+        std::lock_guard<AdaptiveMutex> lock(counter_adaptive_mutex);
+        safe_counter++;
+    }
+}
+
 // Function that increments a counter with unique_lock
 void increment_with_unique_lock(int iterations) {
     for (int i = 0; i < iterations; ++i) {
         // Create a unique_lock without locking the mutex immediately (defer_lock)
-        std::unique_lock<std::mutex> lock(counter_mutex, std::defer_lock);
+        std::unique_lock<ProfiledMutex> lock(counter_mutex, std::defer_lock);
         
         // Do some work before acquiring the mutex
         // ...
@@ -102,6 +120,11 @@ void increment_atomic(int iterations) {
 void basic_mutex_demo() {
     std::cout << "\n=== Basic Mutex Demo ===" << std::endl;
     
+    // Split the increments evenly between the threads
+    const int num_threads = demo_threads(NUM_THREADS);
+    const int increments_per_thread = static_cast<int>(demo_size(NUM_INCREMENTS)) / num_threads;
+    const int expected_count = increments_per_thread * num_threads;
+    
     // Reset counters
     unsafe_counter = 0;
     safe_counter = 0;
@@ -112,8 +135,8 @@ void basic_mutex_demo() {
     
     // Create threads for unsafe increment (race condition)
     std::vector<std::thread> unsafe_threads;
-    for (int i = 0; i < NUM_THREADS; ++i) {
-        unsafe_threads.emplace_back(increment_unsafe, NUM_INCREMENTS / NUM_THREADS);
+    for (int i = 0; i < num_threads; ++i) {
+        unsafe_threads.emplace_back(increment_unsafe, increments_per_thread);
     }
     
     // Join the unsafe threads
@@ -131,8 +154,8 @@ void basic_mutex_demo() {
     
     // Create threads for safe increment (with mutex)
     std::vector<std::thread> safe_threads;
-    for (int i = 0; i < NUM_THREADS; ++i) {
-        safe_threads.emplace_back(increment_with_mutex, NUM_INCREMENTS / NUM_THREADS);
+    for (int i = 0; i < num_threads; ++i) {
+        safe_threads.emplace_back(increment_with_mutex, increments_per_thread);
     }
     
     // Join the safe threads
@@ -145,8 +168,12 @@ void basic_mutex_demo() {
     auto safe_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
         end_safe - start_safe).count();
     
+    // Keep the timings for --format=json/csv reports
+    demo_record("basic_mutex", "unsafe", num_threads, expected_count, end_unsafe - start_unsafe);
+    demo_record("basic_mutex", "mutex", num_threads, expected_count, end_safe - start_safe);
+    
     // Print results
-    std::cout << "Expected final count: " << NUM_INCREMENTS << std::endl;
+    std::cout << "Expected final count: " << expected_count << std::endl;
     std::cout << "Unsafe counter (with race condition): " << unsafe_counter 
               << " (Time: " << unsafe_duration << " ms)" << std::endl;
     std::cout << "Safe counter (with mutex): " << safe_counter 
@@ -157,6 +184,11 @@ void basic_mutex_demo() {
 void lock_guard_demo() {
     std::cout << "\n=== Lock Guard Demo ===" << std::endl;
     
+    // Split the increments evenly between the threads
+    const int num_threads = demo_threads(NUM_THREADS);
+    const int increments_per_thread = static_cast<int>(demo_size(NUM_INCREMENTS)) / num_threads;
+    const int expected_count = increments_per_thread * num_threads;
+    
     // Reset counter
     safe_counter = 0;
     
@@ -165,8 +197,8 @@ void lock_guard_demo() {
     
     auto start_time = std::chrono::high_resolution_clock::now();
     
-    for (int i = 0; i < NUM_THREADS; ++i) {
-        threads.emplace_back(increment_with_lock_guard, NUM_INCREMENTS / NUM_THREADS);
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back(increment_with_lock_guard, increments_per_thread);
     }
     
     // Join all threads
@@ -178,10 +210,34 @@ void lock_guard_demo() {
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
         end_time - start_time).count();
     
+    // Same again with the spin-then-park mutex
+    const int lock_guard_count = safe_counter;
+    safe_counter = 0;
+    threads.clear();
+    
+    auto adaptive_start = std::chrono::high_resolution_clock::now();
+    
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back(increment_with_adaptive_mutex, increments_per_thread);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    
+    auto adaptive_end = std::chrono::high_resolution_clock::now();
+    auto adaptive_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        adaptive_end - adaptive_start).count();
+    
+    // Keep the timing for --format=json/csv reports
+    demo_record("lock_guard", "lock_guard", num_threads, expected_count, end_time - start_time);
+    demo_record("lock_guard", "adaptive", num_threads, expected_count, adaptive_end - adaptive_start);
+    
     // Print result
-    std::cout << "Expected final count: " << NUM_INCREMENTS << std::endl;
-    std::cout << "Final count with lock_guard: " << safe_counter 
+    std::cout << "Expected final count: " << expected_count << std::endl;
+    std::cout << "Final count with lock_guard: " << lock_guard_count 
               << " (Time: " << duration << " ms)" << std::endl;
+    std::cout << "Final count with AdaptiveMutex: " << safe_counter 
+              << " (Time: " << adaptive_duration << " ms)" << std::endl;
     
     std::cout << "Lock guard is an RAII wrapper for mutex that automatically releases the lock when out of scope" << std::endl;
 }
@@ -190,6 +246,11 @@ void lock_guard_demo() {
 void unique_lock_demo() {
     std::cout << "\n=== Unique Lock Demo ===" << std::endl;
     
+    // Split the increments evenly between the threads
+    const int num_threads = demo_threads(NUM_THREADS);
+    const int increments_per_thread = static_cast<int>(demo_size(NUM_INCREMENTS)) / num_threads;
+    const int expected_count = increments_per_thread * num_threads;
+    
     // Reset counter
     safe_counter = 0;
     
@@ -198,8 +259,8 @@ void unique_lock_demo() {
     
     auto start_time = std::chrono::high_resolution_clock::now();
     
-    for (int i = 0; i < NUM_THREADS; ++i) {
-        threads.emplace_back(increment_with_unique_lock, NUM_INCREMENTS / NUM_THREADS);
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back(increment_with_unique_lock, increments_per_thread);
     }
     
     // Join all threads
@@ -211,8 +272,11 @@ void unique_lock_demo() {
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
         end_time - start_time).count();
     
+    // Keep the timing for --format=json/csv reports
+    demo_record("unique_lock", "unique_lock", num_threads, expected_count, end_time - start_time);
+    
     // Print result
-    std::cout << "Expected final count: " << NUM_INCREMENTS << std::endl;
+    std::cout << "Expected final count: " << expected_count << std::endl;
     std::cout << "Final count with unique_lock: " << safe_counter 
               << " (Time: " << duration << " ms)" << std::endl;
     
@@ -251,19 +315,20 @@ void recursive_function(int depth) {
     // The lock is automatically released when it goes out of scope
 }
 
-// Reader-writer lock demonstration - renamed to avoid conflict with data_races.cpp
-void sync_reader_writer_lock_demo() {
-    std::cout << "\n=== Reader-Writer Lock Demo ===" << std::endl;
-    
-    // Shared data protected by a shared_mutex
+// One writer and three readers sharing an int under Lock; returns the writer's longest wait
+template <typename Lock>
+static std::chrono::microseconds run_reader_writer(Lock& rw_mutex) {
     int shared_value = 0;
-    std::shared_mutex rw_mutex;
+    std::chrono::microseconds longest_wait(0);
     
     // Function that writes to the shared data
-    auto writer_fn = [&shared_value, &rw_mutex](int iterations) {
+    auto writer_fn = [&shared_value, &rw_mutex, &longest_wait](int iterations) {
         for (int i = 0; i < iterations; ++i) {
             // Exclusive lock for writing
-            std::unique_lock<std::shared_mutex> write_lock(rw_mutex);
+            auto wait_start = std::chrono::steady_clock::now();
+            std::unique_lock<Lock> write_lock(rw_mutex);
+            longest_wait = std::max(longest_wait, std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - wait_start));
             shared_value = i;
             
             // Simulate some work
@@ -276,7 +341,7 @@ void sync_reader_writer_lock_demo() {
         int sum = 0;
         for (int i = 0; i < iterations; ++i) {
             // Shared lock for reading (multiple readers allowed)
-            std::shared_lock<std::shared_mutex> read_lock(rw_mutex);
+            std::shared_lock<Lock> read_lock(rw_mutex);
             sum += shared_value;
             
             // Simulate some work
@@ -303,14 +368,152 @@ void sync_reader_writer_lock_demo() {
     for (auto& reader : readers) {
         reader.join();
     }
+    return longest_wait;
+}
+
+// Reader-writer lock demonstration - renamed to avoid conflict with data_races.cpp
+void sync_reader_writer_lock_demo() {
+    std::cout << "\n=== Reader-Writer Lock Demo ===" << std::endl;
+    
+    // Shared data protected by a shared_mutex
+    std::shared_mutex rw_mutex;
+    auto shared_mutex_wait = run_reader_writer(rw_mutex);
+    
+    // The same workload on a distributed lock whose waiting writer holds back new readers
+    std::cout << "Repeating with a writer-preferring BigReaderLock..." << std::endl;
+    BigReaderLock big_reader_lock(RwPreference::Writer);
+    auto big_reader_wait = run_reader_writer(big_reader_lock);
     
+    std::cout << "Longest writer wait: shared_mutex " << shared_mutex_wait.count() / 1000.0
+              << " ms, BigReaderLock " << big_reader_wait.count() / 1000.0 << " ms" << std::endl;
     std::cout << "Reader-writer lock demo completed. Multiple readers could read simultaneously." << std::endl;
 }
 
+// Configuration read by every reader of the RCU demo
+struct DemoConfig {
+    int version = 0;
+    int limit = 100;
+};
+
+// Time `reads_per_thread` reads on each of `num_threads` readers while one writer keeps updating
+template <typename Read, typename Write>
+static std::chrono::nanoseconds time_config_reads(int num_threads, int reads_per_thread, Read read, Write write) {
+    std::atomic<bool> reading(true);
+    std::thread writer([&reading, &write]() {
+        int version = 0;
+        while (reading.load()) {
+            write(++version);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+    
+    std::vector<std::thread> readers;
+    auto start_time = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < num_threads; ++i) {
+        readers.emplace_back([reads_per_thread, &read]() {
+            long sum = 0;
+            for (int r = 0; r < reads_per_thread; ++r) {
+                sum += read();
+            }
+            if (sum < 0) {
+                std::cout << "Impossible sum " << sum << std::endl;
+            }
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    
+    reading = false;
+    writer.join();
+    return end_time - start_time;
+}
+
+// Read-copy-update demonstration: lock-free readers of a read-mostly config
+void rcu_config_demo() {
+    std::cout << "\n=== RCU Config Demo ===" << std::endl;
+    
+    const int num_threads = demo_threads(NUM_THREADS);
+    const int reads_per_thread = static_cast<int>(demo_size(NUM_INCREMENTS)) / num_threads;
+    const size_t total_reads = static_cast<size_t>(reads_per_thread) * num_threads;
+    
+    // Baseline: the shared_mutex reader path of the reader-writer demo
+    DemoConfig locked_config;
+    std::shared_mutex rw_mutex;
+    auto locked_time = time_config_reads(num_threads, reads_per_thread,
+        [&]() {
+            std::shared_lock<std::shared_mutex> read_lock(rw_mutex);
+            return locked_config.limit + locked_config.version;
+        },
+        [&](int version) {
+            std::unique_lock<std::shared_mutex> write_lock(rw_mutex);
+            locked_config.version = version;
+        });
+    
+    // RCU: readers pin an epoch (or publish a hazard pointer) and never write shared state
+    RcuConfig<DemoConfig> epoch_config;
+    auto epoch_time = time_config_reads(num_threads, reads_per_thread,
+        [&]() {
+            return epoch_config.read([](const DemoConfig& c) { return c.limit + c.version; });
+        },
+        [&](int version) {
+            epoch_config.update([version](DemoConfig& c) { c.version = version; });
+        });
+    
+    RcuConfig<DemoConfig, ReclaimScheme::Hazard> hazard_config;
+    auto hazard_time = time_config_reads(num_threads, reads_per_thread,
+        [&]() {
+            return hazard_config.read([](const DemoConfig& c) { return c.limit + c.version; });
+        },
+        [&](int version) {
+            hazard_config.update([version](DemoConfig& c) { c.version = version; });
+        });
+    
+    // RcuCell readers only copy a counter into their own record; writers wait for grace periods
+    RcuCell<DemoConfig> cell_config;
+    auto cell_time = time_config_reads(num_threads, reads_per_thread,
+        [&]() {
+            return cell_config.read([](const DemoConfig& c) { return c.limit + c.version; });
+        },
+        [&](int version) {
+            cell_config.update([version](DemoConfig& c) { c.version = version; });
+        });
+    
+    // Keep the timing for --format=json/csv reports
+    demo_record("rcu_config", "shared_mutex", num_threads, total_reads, locked_time);
+    demo_record("rcu_config", "rcu_epoch", num_threads, total_reads, epoch_time);
+    demo_record("rcu_config", "rcu_hazard", num_threads, total_reads, hazard_time);
+    demo_record("rcu_config", "rcu_cell", num_threads, total_reads, cell_time);
+    
+    auto ms = [](std::chrono::nanoseconds elapsed) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+    };
+    std::cout << total_reads << " reads on " << num_threads << " threads with a concurrent writer:" << std::endl;
+    std::cout << "  shared_mutex: " << ms(locked_time) << " ms (last version " << locked_config.version << ")" << std::endl;
+    std::cout << "  RCU (epochs): " << ms(epoch_time) << " ms (last version "
+              << epoch_config.read([](const DemoConfig& c) { return c.version; }) << ")" << std::endl;
+    std::cout << "  RCU (hazard pointers): " << ms(hazard_time) << " ms (last version "
+              << hazard_config.read([](const DemoConfig& c) { return c.version; }) << ")" << std::endl;
+    std::cout << "  RcuCell (grace periods): " << ms(cell_time) << " ms (last version "
+              << cell_config.read([](const DemoConfig& c) { return c.version; }) << ")" << std::endl;
+    
+    // The writer threads have exited; free the versions they retired
+    epoch_reclaim();
+    hazard_reclaim();
+    
+    std::cout << "RCU readers never block a writer and never write to a shared cache line" << std::endl;
+}
+
 // Atomic operations demonstration
 void atomic_demo() {
     std::cout << "\n=== Atomic Operations Demo ===" << std::endl;
     
+    // Split the increments evenly between the threads
+    const int num_threads = demo_threads(NUM_THREADS);
+    const int increments_per_thread = static_cast<int>(demo_size(NUM_INCREMENTS)) / num_threads;
+    const int expected_count = increments_per_thread * num_threads;
+    
     // Reset atomic counter
     atomic_counter = 0;
     
@@ -319,8 +522,8 @@ void atomic_demo() {
     
     auto start_time = std::chrono::high_resolution_clock::now();
     
-    for (int i = 0; i < NUM_THREADS; ++i) {
-        threads.emplace_back(increment_atomic, NUM_INCREMENTS / NUM_THREADS);
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back(increment_atomic, increments_per_thread);
     }
     
     // Join all threads
@@ -332,8 +535,11 @@ void atomic_demo() {
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
         end_time - start_time).count();
     
+    // Keep the timing for --format=json/csv reports
+    demo_record("sync_atomic", "seq_cst", num_threads, expected_count, end_time - start_time);
+    
     // Print result
-    std::cout << "Expected final count: " << NUM_INCREMENTS << std::endl;
+    std::cout << "Expected final count: " << expected_count << std::endl;
     std::cout << "Final atomic counter: " << atomic_counter.load() 
               << " (Time: " << duration << " ms)" << std::endl;
     
@@ -359,6 +565,9 @@ int synchronization_main() {
     // Run the reader-writer lock demo
     sync_reader_writer_lock_demo();
     
+    // Compare its reader path with read-copy-update
+    rcu_config_demo();
+    
     // Run the atomic operations demo
     atomic_demo();
     
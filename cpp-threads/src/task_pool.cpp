@@ -0,0 +1,179 @@
+/**
+ * @file task_pool.cpp
+ * @brief Worker threads and fork-join bookkeeping for TaskPool and TaskGroup
+ */
+
+#include "task_pool.h"
+
+#include <algorithm>
+#include <string>
+
+#include "trace.h"
+
+TaskPool::TaskPool(int threads) {
+    if (threads <= 0) {
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    workers.reserve(threads);
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back([this, i]() {
+            trace_thread_name("task pool worker " + std::to_string(i));
+            worker_loop();
+        });
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_cv.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void TaskPool::submit(std::function<void()> task) {
+    QueuedTask queued{ std::move(task) };
+    if (trace_enabled()) {
+        queued.queued_at = trace_now_ns();
+        queued.trace_id = trace_next_id();
+    }
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        tasks.push_back(std::move(queued));
+        trace_counter("task pool queue", static_cast<int64_t>(tasks.size()));
+        wake = idle > 0;
+    }
+    if (wake) {
+        queue_cv.notify_one();
+    }
+}
+
+void TaskPool::submit_batch(std::vector<std::function<void()>> batch) {
+    if (batch.empty()) {
+        return;
+    }
+    uint64_t queued_at = trace_enabled() ? trace_now_ns() : 0;
+    size_t wake;
+    size_t waiting;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        for (auto& task : batch) {
+            QueuedTask queued{ std::move(task) };
+            if (queued_at != 0) {
+                queued.queued_at = queued_at;
+                queued.trace_id = trace_next_id();
+            }
+            tasks.push_back(std::move(queued));
+        }
+        trace_counter("task pool queue", static_cast<int64_t>(tasks.size()));
+        waiting = idle;
+        wake = std::min(batch.size(), idle);
+    }
+    
+    // One wake-up per task up to the number of idle workers; busy workers find
+    // the rest when they come back for their next task
+    if (wake == waiting) {
+        if (wake > 0) {
+            queue_cv.notify_all();
+        }
+    } else {
+        for (size_t i = 0; i < wake; ++i) {
+            queue_cv.notify_one();
+        }
+    }
+}
+
+// Trace the time the task sat in the queue apart from the time it ran
+void TaskPool::execute(QueuedTask& task) {
+    if (task.queued_at != 0) {
+        trace_async("queue wait", "task_pool", task.trace_id, task.queued_at, trace_now_ns());
+    }
+    TraceSpan span("task", "task_pool");
+    task.run();
+}
+
+bool TaskPool::run_one() {
+    QueuedTask task;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (tasks.empty()) {
+            return false;
+        }
+        task = std::move(tasks.front());
+        tasks.pop_front();
+        trace_counter("task pool queue", static_cast<int64_t>(tasks.size()));
+    }
+    execute(task);
+    return true;
+}
+
+void TaskPool::worker_loop() {
+    for (;;) {
+        QueuedTask task;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            ++idle;
+            queue_cv.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            --idle;
+            
+            // Drain the queue before stopping so no submitted task is lost
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            trace_counter("task pool queue", static_cast<int64_t>(tasks.size()));
+        }
+        execute(task);
+    }
+}
+
+TaskPool& default_task_pool() {
+    static TaskPool pool;
+    return pool;
+}
+
+TaskGroup::~TaskGroup() {
+    // Tasks reference the group, so it must not disappear under them
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (!pool.run_one()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    pending.fetch_add(1, std::memory_order_relaxed);
+    pool.submit([this, task = std::move(task)]() {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        pending.fetch_sub(1, std::memory_order_acq_rel);
+    });
+}
+
+void TaskGroup::wait() {
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (!pool.run_one()) {
+            std::this_thread::yield();
+        }
+    }
+    
+    std::exception_ptr first;
+    {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        std::swap(first, error);
+    }
+    if (first) {
+        std::rethrow_exception(first);
+    }
+}
@@ -0,0 +1,108 @@
+/**
+ * @file task_pool.h
+ * @brief Persistent worker pool with fork-join task groups
+ *
+ * TaskPool keeps its worker threads for its whole lifetime and runs
+ * submitted tasks in FIFO order. TaskGroup adds fork-join on top: run()
+ * forks a task, wait() joins all of them. A waiting thread executes queued
+ * tasks itself instead of blocking, so tasks may fork and wait on nested
+ * groups (recursive divide and conquer) without starving the pool, and the
+ * caller of wait() counts as one more worker.
+ */
+
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TaskPool {
+public:
+    // threads <= 0 uses one worker per hardware thread
+    explicit TaskPool(int threads = 0);
+    ~TaskPool();
+    
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+    
+    // Number of worker threads
+    int size() const { return static_cast<int>(workers.size()); }
+    
+    // Queue a task for any worker
+    void submit(std::function<void()> task);
+    
+    // Queue every task under one lock acquisition and wake no more idle
+    // workers than there are tasks
+    void submit_batch(std::vector<std::function<void()>> batch);
+    
+    // Run one queued task on the calling thread; false when the queue was empty
+    bool run_one();
+
+private:
+    // A task and when it was queued; queued_at is 0 unless tracing was on
+    struct QueuedTask {
+        std::function<void()> run;
+        uint64_t queued_at = 0;
+        uint64_t trace_id = 0;
+    };
+    
+    void worker_loop();
+    static void execute(QueuedTask& task);
+    
+    std::vector<std::thread> workers;
+    std::deque<QueuedTask> tasks;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    size_t idle = 0;                     // Workers waiting on queue_cv; a submit with none skips the notify
+    bool stopping = false;
+};
+
+// Process-wide pool with one worker per hardware thread, started on first use
+TaskPool& default_task_pool();
+
+// A set of forked tasks that can be joined; the first exception thrown by
+// any task is rethrown from wait()
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskPool& pool) : pool(pool) {}
+    ~TaskGroup();
+    
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    
+    void run(std::function<void()> task);
+    
+    // Help run queued tasks until every task of this group has finished
+    void wait();
+
+private:
+    TaskPool& pool;
+    std::atomic<size_t> pending{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+};
+
+// Call body(i) for every i in [0, count) on the pool and wait for all of
+// them; the calling thread takes the last index itself
+template <typename Body>
+void parallel_for_index(TaskPool& pool, size_t count, Body body) {
+    if (count == 0) {
+        return;
+    }
+    TaskGroup group(pool);
+    for (size_t i = 0; i + 1 < count; ++i) {
+        group.run([&body, i]() { body(i); });
+    }
+    body(count - 1);
+    group.wait();
+}
+
+#endif // TASK_POOL_H
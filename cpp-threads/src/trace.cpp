@@ -0,0 +1,180 @@
+/**
+ * @file trace.cpp
+ * @brief Per-thread event buffers and the Chrome trace JSON writer
+ */
+
+#include "trace.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// One thread's events. Only the owning thread appends; it publishes each event by
+// storing the new count with release order, so the writer can read up to the count
+// it loaded while the thread keeps recording.
+struct TraceThreadBuffer {
+    std::atomic<TraceEvent*> chunks[TRACE_MAX_CHUNKS] = {};
+    std::atomic<size_t> count{0};
+    std::atomic<uint64_t> dropped{0};
+    size_t thread_id = 0;
+    std::string name;                    // Guarded by the registry mutex
+    
+    ~TraceThreadBuffer() {
+        for (auto& chunk : chunks) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+};
+
+// Every thread buffer ever created; a buffer stays after its thread exits
+struct TraceRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceThreadBuffer>> buffers;
+    std::atomic<uint64_t> start_ns{0};
+    std::atomic<uint64_t> next_id{1};
+};
+
+// Never destroyed: detached threads may still record while static destructors run
+static TraceRegistry& registry() {
+    static TraceRegistry* instance = new TraceRegistry;
+    return *instance;
+}
+
+// Created on the first event, so threads that never record pay nothing
+static TraceThreadBuffer& thread_buffer() {
+    static thread_local TraceThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        TraceRegistry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.buffers.push_back(std::make_unique<TraceThreadBuffer>());
+        buffer = reg.buffers.back().get();
+        buffer->thread_id = reg.buffers.size();
+    }
+    return *buffer;
+}
+
+uint64_t trace_now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void trace_start() {
+    registry().start_ns.store(trace_now_ns(), std::memory_order_relaxed);
+    trace_on.store(true, std::memory_order_release);
+}
+
+void trace_stop() {
+    trace_on.store(false, std::memory_order_release);
+}
+
+uint64_t trace_next_id() {
+    return registry().next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+void trace_record(const TraceEvent& event) {
+    TraceThreadBuffer& buffer = thread_buffer();
+    size_t index = buffer.count.load(std::memory_order_relaxed);
+    size_t chunk = index / TRACE_CHUNK_EVENTS;
+    if (chunk >= TRACE_MAX_CHUNKS) {
+        buffer.dropped.store(buffer.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    
+    TraceEvent* events = buffer.chunks[chunk].load(std::memory_order_relaxed);
+    if (events == nullptr) {
+        events = new TraceEvent[TRACE_CHUNK_EVENTS];
+        buffer.chunks[chunk].store(events, std::memory_order_relaxed);
+    }
+    events[index % TRACE_CHUNK_EVENTS] = event;
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+void trace_thread_name(const std::string& name) {
+    TraceThreadBuffer& buffer = thread_buffer();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    buffer.name = name;
+}
+
+static void write_json_string(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c != '\0'; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\' << *c;
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(*c)
+                << std::dec << std::setfill(' ');
+        } else {
+            out << *c;
+        }
+    }
+    out << '"';
+}
+
+// Chrome trace timestamps are microseconds
+static void write_microseconds(std::ostream& out, uint64_t ns) {
+    out << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000 << std::setfill(' ');
+}
+
+static void write_event(std::ostream& out, const TraceEvent& event, size_t thread_id, uint64_t start_ns) {
+    uint64_t timestamp = event.timestamp_ns > start_ns ? event.timestamp_ns - start_ns : 0;
+    
+    out << "{\"name\":";
+    write_json_string(out, event.name);
+    out << ",\"cat\":";
+    write_json_string(out, event.category);
+    out << ",\"ph\":\"" << event.phase << "\",\"ts\":";
+    write_microseconds(out, timestamp);
+    out << ",\"pid\":1,\"tid\":" << thread_id;
+    if (event.phase == 'X') {
+        out << ",\"dur\":";
+        write_microseconds(out, event.duration_ns);
+    } else if (event.phase == 'b' || event.phase == 'e') {
+        out << ",\"id\":" << event.id;
+    } else if (event.phase == 'C') {
+        out << ",\"args\":{\"value\":" << event.value << "}";
+    }
+    out << "}";
+}
+
+bool trace_write(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    
+    TraceRegistry& reg = registry();
+    uint64_t start_ns = reg.start_ns.load(std::memory_order_relaxed);
+    uint64_t dropped = 0;
+    bool first = true;
+    
+    out << "{\"traceEvents\":[";
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& buffer : reg.buffers) {
+        if (!buffer->name.empty()) {
+            out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                << buffer->thread_id << ",\"args\":{\"name\":";
+            write_json_string(out, buffer->name.c_str());
+            out << "}}";
+            first = false;
+        }
+        
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent* events = buffer->chunks[i / TRACE_CHUNK_EVENTS].load(std::memory_order_relaxed);
+            out << (first ? "\n" : ",\n");
+            write_event(out, events[i % TRACE_CHUNK_EVENTS], buffer->thread_id, start_ns);
+            first = false;
+        }
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    out << "\n]}\n";
+    
+    if (dropped > 0) {
+        std::cerr << "Trace buffers were full: " << dropped << " events dropped" << std::endl;
+    }
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,109 @@
+/**
+ * @file trace.h
+ * @brief Timeline tracing of threads, tasks and counters in Chrome trace format
+ *
+ * Run a demo with --trace=FILE and open FILE in chrome://tracing or
+ * https://ui.perfetto.dev to see one row per thread instead of interleaved
+ * console lines. Spans mark what a thread was doing, async events mark the
+ * time a task spent queued before a worker picked it up, and counters plot
+ * a value such as the queue depth over time.
+ *
+ * Each thread appends to a buffer of its own without locks or shared
+ * writes; the buffers outlive their threads and are written out together.
+ * While tracing is off every call costs one relaxed load.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Events per chunk of a thread's buffer; chunks are allocated as the thread records
+const size_t TRACE_CHUNK_EVENTS = 4096;
+
+// Chunks per thread; events past TRACE_CHUNK_EVENTS * TRACE_MAX_CHUNKS are dropped and counted
+const size_t TRACE_MAX_CHUNKS = 64;
+
+// One recorded event. Names and categories must be string literals (or live as long).
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    char phase;                  // 'X' span, 'b'/'e' async begin/end, 'C' counter
+    uint64_t timestamp_ns;
+    uint64_t duration_ns;        // Spans only
+    uint64_t id;                 // Async events only
+    int64_t value;               // Counters only
+};
+
+inline std::atomic<bool> trace_on{false};
+
+inline bool trace_enabled() {
+    return trace_on.load(std::memory_order_relaxed);
+}
+
+// Start recording; timestamps in the file are relative to this call
+void trace_start();
+
+// Stop recording; what was recorded stays for trace_write
+void trace_stop();
+
+// Write every recorded event as Chrome trace JSON; false when the file cannot be written
+bool trace_write(const std::string& path);
+
+uint64_t trace_now_ns();
+
+// Append to the calling thread's buffer
+void trace_record(const TraceEvent& event);
+
+// Label the calling thread's row in the timeline
+void trace_thread_name(const std::string& name);
+
+// Identifier that ties an async begin to its end
+uint64_t trace_next_id();
+
+// Something the calling thread did between two trace_now_ns() readings
+inline void trace_complete(const char* name, const char* category, uint64_t start_ns, uint64_t end_ns) {
+    if (trace_enabled()) {
+        trace_record({ name, category, 'X', start_ns, end_ns - start_ns, 0, 0 });
+    }
+}
+
+// An interval that is not tied to one thread, such as a task waiting in a queue
+inline void trace_async(const char* name, const char* category, uint64_t id, uint64_t start_ns, uint64_t end_ns) {
+    if (trace_enabled()) {
+        trace_record({ name, category, 'b', start_ns, 0, id, 0 });
+        trace_record({ name, category, 'e', end_ns, 0, id, 0 });
+    }
+}
+
+inline void trace_counter(const char* name, int64_t value) {
+    if (trace_enabled()) {
+        trace_record({ name, "counter", 'C', trace_now_ns(), 0, 0, value });
+    }
+}
+
+// Records the lifetime of the scope as a span on the calling thread
+class TraceSpan {
+public:
+    TraceSpan(const char* name, const char* category)
+        : name(name), category(category), start(trace_enabled() ? trace_now_ns() : 0) {}
+    
+    ~TraceSpan() {
+        if (start != 0) {
+            trace_complete(name, category, start, trace_now_ns());
+        }
+    }
+    
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;
+    const char* category;
+    uint64_t start;
+};
+
+#endif // TRACE_H